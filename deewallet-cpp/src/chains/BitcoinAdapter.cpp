@@ -4,25 +4,35 @@
 
 #include "BitcoinAdapter.h"
 #include "../utils/AddressUtils.h"
+#include "../utils/AddressValidator.h"
+#include "../utils/Amount.h"
+#include "../utils/CoinSelector.h"
 #include <openssl/sha.h>
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
-#include <QEventLoop>
+#include "../rpc/HttpTransport.h"
+#include "../rpc/NetworkService.h"
+#include "../rpc/RPCManager.h"
+#include "../rpc/ElectrumClient.h"
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QSet>
 #include <QDebug>
 
 BitcoinAdapter::BitcoinAdapter(const QString &rpcUrl, bool isTestnet)
-    : isTestnet(isTestnet)
+    : BitcoinAdapter(rpcUrl, UtxoNetwork::forChain("BTC", isTestnet))
+{
+}
+
+BitcoinAdapter::BitcoinAdapter(const QString &rpcUrl, const UtxoNetwork &network)
+    : network(network)
 {
     this->rpcUrl = rpcUrl;
 }
 
 QString BitcoinAdapter::deriveAddress(const QByteArray &publicKey)
 {
-    // P2WPKH (Native SegWit) address generation
-    // bc1q... for mainnet, tb1q... for testnet
+    // P2WPKH (Native SegWit) address generation: bc1q / tb1q / ltc1q...
+    // Networks without SegWit (Dogecoin) get a P2PKH address instead
 
     qDebug() << "[BitcoinAdapter] Input public key size:" << publicKey.size();
     if (!publicKey.isEmpty()) {
@@ -68,58 +78,175 @@ QString BitcoinAdapter::deriveAddress(const QByteArray &publicKey)
     // Step 2: RIPEMD160 hash
     QByteArray pubKeyHash = AddressUtils::ripemd160(sha256Data);
 
-    // Step 3: Bech32 encoding
-    QString hrp = isTestnet ? "tb" : "bc";
-    QString address = AddressUtils::encodeBech32(hrp, pubKeyHash);
-
-    return address;
+    // Step 3: Bech32 (or Base58Check) encoding with the network's prefix
+    return network.addressForKeyHash(pubKeyHash);
 }
 
 bool BitcoinAdapter::validateAddress(const QString &address)
 {
-    // Check for Bech32 (SegWit)
-    if (address.startsWith("bc1") || address.startsWith("tb1")) {
-        return address.length() >= 42 && address.length() <= 62;
+    // Bech32/Bech32m (SegWit v0, Taproot v1) and legacy P2PKH/P2SH, checksum verified
+    return AddressValidator::validate(network.symbol, address, network.testnet);
+}
+
+QString BitcoinAdapter::getBalance(const QString &address)
+{
+    return getBalances({address}).value(address);
+}
+
+QHash<QString, QString> BitcoinAdapter::getBalances(const QStringList &addresses)
+{
+    QHash<QString, QString> balances;
+
+    // One Electrum batch for every address over the chain's persistent session
+    ElectrumClient *client = electrum();
+    if (client) {
+        QVector<ElectrumCall> calls;
+        QStringList queried;
+        for (const QString &address : addresses) {
+            QByteArray script = network.scriptPubKey(address);
+            if (!script.isEmpty()) {
+                calls.append({"blockchain.scripthash.get_balance",
+                              QJsonArray{ElectrumClient::scriptHash(script)}});
+                queried.append(address);
+            }
+        }
+
+        QVector<ElectrumResponse> responses = HttpTransport::waitFor(client->batch(calls));
+        for (int i = 0; i < queried.size() && i < responses.size(); ++i) {
+            if (responses[i].ok()) {
+                // Confirmed only, matching Esplora's chain_stats
+                qint64 confirmed = responses[i].result.toObject()["confirmed"].toVariant().toLongLong();
+                balances.insert(queried[i], formatUnits(confirmed));
+            }
+        }
     }
 
-    // Check for legacy addresses (P2PKH: 1..., P2SH: 3...)
-    if (address.startsWith("1") || address.startsWith("3")) {
-        return address.length() >= 26 && address.length() <= 35;
+    // Esplora (Blockstream / mempool.space) for whatever Electrum did not
+    // answer; all requests are in flight together
+    if (hasEsplora()) {
+        QStringList remaining;
+        QVector<QFuture<HttpResponse>> replies;
+        for (const QString &address : addresses) {
+            if (!balances.contains(address)) {
+                remaining.append(address);
+                replies.append(esploraRequest("/address/" + address));
+            }
+        }
+
+        for (int i = 0; i < remaining.size(); ++i) {
+            HttpResponse reply = HttpTransport::waitFor(replies[i]);
+            QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+            if (reply.ok() && doc.isObject()) {
+                QJsonObject chainStats = doc.object()["chain_stats"].toObject();
+                qint64 fundedTxoSum = chainStats["funded_txo_sum"].toVariant().toLongLong();
+                qint64 spentTxoSum = chainStats["spent_txo_sum"].toVariant().toLongLong();
+                balances.insert(remaining[i], formatUnits(fundedTxoSum - spentTxoSum));
+            }
+        }
     }
 
-    return false;
+    // Addresses neither backend answered are left out, not reported as zero
+    return balances;
 }
 
-QString BitcoinAdapter::getBalance(const QString &address)
+QVector<UnspentOutput> BitcoinAdapter::getUnspentOutputs(const QStringList &addresses)
 {
-    // Use Blockstream API for balance query
-    QString url = QString("https://blockstream.info/api/address/%1").arg(address);
+    QVector<UnspentOutput> outputs;
+    QSet<QString> answered;
 
-    QNetworkAccessManager manager;
-    QNetworkRequest request(url);
-    QNetworkReply *reply = manager.get(request);
+    ElectrumClient *client = electrum();
+    if (client) {
+        QVector<ElectrumCall> calls;
+        QStringList queried;
+        for (const QString &address : addresses) {
+            QByteArray script = network.scriptPubKey(address);
+            if (!script.isEmpty()) {
+                calls.append({"blockchain.scripthash.listunspent",
+                              QJsonArray{ElectrumClient::scriptHash(script)}});
+                queried.append(address);
+            }
+        }
 
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+        QVector<ElectrumResponse> responses = HttpTransport::waitFor(client->batch(calls));
+        for (int i = 0; i < queried.size() && i < responses.size(); ++i) {
+            if (!responses[i].ok()) {
+                continue;
+            }
+            answered.insert(queried[i]);
+            for (const QJsonValue &value : responses[i].result.toArray()) {
+                QJsonObject utxo = value.toObject();
+                UnspentOutput output;
+                output.txid = utxo["tx_hash"].toString();
+                output.vout = utxo["tx_pos"].toInt();
+                output.value = utxo["value"].toVariant().toLongLong();
+                output.height = qMax<qint64>(0, utxo["height"].toVariant().toLongLong());
+                output.address = queried[i];
+                outputs.append(output);
+            }
+        }
+    }
 
-    QString balance = "0.0";
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(response);
-        if (doc.isObject()) {
-            QJsonObject obj = doc.object();
-            QJsonObject chainStats = obj["chain_stats"].toObject();
-            qint64 fundedTxoSum = chainStats["funded_txo_sum"].toVariant().toLongLong();
-            qint64 spentTxoSum = chainStats["spent_txo_sum"].toVariant().toLongLong();
-            qint64 satoshis = fundedTxoSum - spentTxoSum;
-            double btc = satoshis / 100000000.0;
-            balance = QString::number(btc, 'f', 8);
+    if (hasEsplora()) {
+        QStringList remaining;
+        QVector<QFuture<HttpResponse>> replies;
+        for (const QString &address : addresses) {
+            if (!answered.contains(address)) {
+                remaining.append(address);
+                replies.append(esploraRequest("/address/" + address + "/utxo"));
+            }
         }
+
+        for (int i = 0; i < remaining.size(); ++i) {
+            HttpResponse reply = HttpTransport::waitFor(replies[i]);
+            if (!reply.ok()) {
+                continue;
+            }
+            for (const QJsonValue &value : QJsonDocument::fromJson(reply.body).array()) {
+                QJsonObject utxo = value.toObject();
+                QJsonObject status = utxo["status"].toObject();
+                UnspentOutput output;
+                output.txid = utxo["txid"].toString();
+                output.vout = utxo["vout"].toInt();
+                output.value = utxo["value"].toVariant().toLongLong();
+                output.height = status["confirmed"].toBool()
+                    ? status["block_height"].toVariant().toLongLong() : 0;
+                output.address = remaining[i];
+                outputs.append(output);
+            }
+        }
+    }
+
+    return outputs;
+}
+
+AddressActivity BitcoinAdapter::getActivity(const QString &address)
+{
+    // Any confirmed or mempool transaction, even if the balance is zero again
+    ElectrumClient *client = electrum();
+    QByteArray script = network.scriptPubKey(address);
+    if (client && !script.isEmpty()) {
+        ElectrumResponse response = HttpTransport::waitFor(
+            client->call("blockchain.scripthash.get_history",
+                         QJsonArray{ElectrumClient::scriptHash(script)}));
+        if (response.ok()) {
+            return response.result.toArray().isEmpty() ? AddressActivity::Unused : AddressActivity::Used;
+        }
+    }
+
+    if (!hasEsplora()) {
+        return AddressActivity::Unknown;
+    }
+
+    HttpResponse reply = esploraGet("/address/" + address);
+    QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+    if (!reply.ok() || !doc.isObject()) {
+        return AddressActivity::Unknown;
     }
 
-    reply->deleteLater();
-    return balance;
+    QJsonObject obj = doc.object();
+    bool used = obj["chain_stats"].toObject()["tx_count"].toInt() > 0
+        || obj["mempool_stats"].toObject()["tx_count"].toInt() > 0;
+    return used ? AddressActivity::Used : AddressActivity::Unused;
 }
 
 QVector<Token> BitcoinAdapter::getTokens(const QString &address)
@@ -133,30 +260,369 @@ QString BitcoinAdapter::createTransaction(const QString &from,
                                           const QString &amount,
                                           const QString &gasPrice)
 {
-    // TODO: Implement UTXO-based transaction creation
-    return QString();
+    // Unsigned transaction with the spent outputs' values and scripts as
+    // JSON; signTransaction needs both for the SegWit sighash
+    bool ok = false;
+    Amount value = Amount::parse(amount, 8, &ok);
+    if (!ok || value.isZero()) {
+        return QString();
+    }
+    qint64 satoshis = static_cast<qint64>(value.units().toUInt64());
+
+    CoinSelector selector;
+    CoinSelectionParams params;
+    if (!prepareSelection(from, to, gasPrice, selector, params)) {
+        return QString();
+    }
+    QByteArray toScript = network.scriptPubKey(to);
+    QByteArray fromScript = network.scriptPubKey(from);
+
+    CoinSelection selection = selector.select(satoshis, params);
+    if (!selection.ok()) {
+        return QString();
+    }
+
+    BitcoinTransaction tx = TransactionBuilder::buildBitcoinTransaction(
+        selection.inputs, toScript, satoshis, selection.fee, fromScript);
+    if (tx.inputs().isEmpty()) {
+        return QString();
+    }
+
+    QJsonArray inputs;
+    for (const UTXO &utxo : selection.inputs) {
+        QJsonObject input;
+        input["txid"] = utxo.txid;
+        input["vout"] = static_cast<qint64>(utxo.vout);
+        input["value"] = utxo.value;
+        input["script"] = utxo.scriptPubKey;
+        inputs.append(input);
+    }
+    QJsonArray outputs;
+    for (const BitcoinTxOutput &txOutput : tx.outputs()) {
+        QJsonObject output;
+        output["value"] = txOutput.value;
+        output["script"] = QString::fromLatin1(txOutput.scriptPubKey.toHex());
+        outputs.append(output);
+    }
+
+    QJsonObject obj;
+    obj["version"] = static_cast<qint64>(tx.version());
+    obj["locktime"] = static_cast<qint64>(tx.lockTime());
+    obj["inputs"] = inputs;
+    obj["outputs"] = outputs;
+    obj["fee"] = selection.fee;
+    return QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact));
 }
 
 QString BitcoinAdapter::signTransaction(const QString &rawTx, const QByteArray &privateKey)
 {
-    // TODO: Implement ECDSA signing
-    return QString();
+    QJsonObject obj = QJsonDocument::fromJson(rawTx.toUtf8()).object();
+    if (obj.isEmpty()) {
+        return QString();
+    }
+
+    BitcoinTransaction tx;
+    tx.setVersion(static_cast<quint32>(obj["version"].toVariant().toLongLong()));
+    tx.setLockTime(static_cast<quint32>(obj["locktime"].toVariant().toLongLong()));
+    for (const QJsonValue &value : obj["inputs"].toArray()) {
+        QJsonObject input = value.toObject();
+        tx.addInput(input["txid"].toString(),
+                    static_cast<quint32>(input["vout"].toVariant().toLongLong()),
+                    input["value"].toVariant().toLongLong(),
+                    TransactionBuilder::hexToBytes(input["script"].toString()));
+    }
+    for (const QJsonValue &value : obj["outputs"].toArray()) {
+        QJsonObject output = value.toObject();
+        tx.addOutput(output["value"].toVariant().toLongLong(),
+                     TransactionBuilder::hexToBytes(output["script"].toString()));
+    }
+
+    for (int i = 0; i < tx.inputs().size(); ++i) {
+        if (!TransactionBuilder::signBitcoinInput(tx, i, privateKey)) {
+            return QString();
+        }
+    }
+    return QString::fromLatin1(tx.serialize().toHex());
 }
 
 QString BitcoinAdapter::broadcastTransaction(const QString &signedTx)
 {
-    // TODO: Implement RPC broadcast
-    return QString();
+    ElectrumClient *client = electrum();
+    if (client) {
+        ElectrumResponse response = HttpTransport::waitFor(
+            client->call("blockchain.transaction.broadcast", QJsonArray{signedTx}));
+        if (response.ok()) {
+            return response.result.toString();
+        }
+    }
+
+    if (!hasEsplora()) {
+        return QString();
+    }
+
+    // Esplora answers with the txid as plain text
+    HttpResponse reply = HttpTransport::waitFor(esploraPost("/tx", signedTx.toLatin1()));
+    return reply.ok() ? QString::fromLatin1(reply.body).trimmed() : QString();
 }
 
 QVector<Transaction> BitcoinAdapter::getTransactionHistory(const QString &address, int limit)
 {
-    // TODO: Implement transaction history query
-    return QVector<Transaction>();
+    QString nextCursor;
+    QVector<Transaction> history = getTransactionsSince(address, QString(), nextCursor);
+    return history.mid(0, limit);
+}
+
+QVector<Transaction> BitcoinAdapter::getTransactionsSince(const QString &address,
+                                                          const QString &cursor,
+                                                          QString &nextCursor)
+{
+    // Cursor = newest confirmed txid. /txs lists mempool transactions plus the
+    // newest confirmed page; /txs/chain/:last_seen pages further back.
+    QVector<Transaction> transactions;
+    nextCursor = cursor;
+    if (!hasEsplora()) {
+        // Electrum history only lists txids; decoding raw transactions is not supported yet
+        return transactions;
+    }
+
+    // The cursor moves to the newest txid only once the walk has reached the
+    // old cursor or the end of history; a page error or the page cap keeps
+    // it, so the gap is walked again next time (stored results are upserts)
+    QString newestConfirmed;
+    bool reachedCursor = false;
+    bool complete = false;
+
+    QString path = "/address/" + address + "/txs";
+    for (int page = 0; page < MAX_HISTORY_PAGES && !reachedCursor; ++page) {
+        HttpResponse reply = esploraGet(path);
+        if (!reply.ok()) {
+            break;
+        }
+
+        QJsonArray txs = QJsonDocument::fromJson(reply.body).array();
+        QString lastConfirmed;
+        int confirmedCount = 0;
+
+        for (const QJsonValue &value : txs) {
+            QJsonObject tx = value.toObject();
+            QString txid = tx["txid"].toString();
+            bool confirmed = tx["status"].toObject()["confirmed"].toBool();
+
+            if (confirmed) {
+                if (!cursor.isEmpty() && txid == cursor) {
+                    reachedCursor = true;
+                    break;
+                }
+                if (newestConfirmed.isEmpty()) {
+                    newestConfirmed = txid;
+                }
+                lastConfirmed = txid;
+                confirmedCount++;
+            }
+
+            transactions.append(parseEsploraTransaction(tx, address));
+        }
+
+        if (reachedCursor || confirmedCount < ESPLORA_PAGE_SIZE || lastConfirmed.isEmpty()) {
+            complete = true;
+            break;
+        }
+        path = "/address/" + address + "/txs/chain/" + lastConfirmed;
+    }
+
+    if (complete && !newestConfirmed.isEmpty()) {
+        nextCursor = newestConfirmed;
+    }
+    return transactions;
+}
+
+QFuture<HttpResponse> BitcoinAdapter::esploraRequest(const QString &path)
+{
+    RPCManager *router = NetworkService::instance()->rpcManager();
+    if (rpcUrl.isEmpty() && !network.testnet && router->hasChain(network.symbol)) {
+        return router->get(network.symbol, path);
+    }
+
+    QString endpoint = !rpcUrl.isEmpty() ? rpcUrl : network.esploraUrl;
+    return NetworkService::instance()->transport()->get(QUrl(endpoint + path));
+}
+
+QFuture<HttpResponse> BitcoinAdapter::esploraPost(const QString &path, const QByteArray &body)
+{
+    RPCManager *router = NetworkService::instance()->rpcManager();
+    if (rpcUrl.isEmpty() && !network.testnet && router->hasChain(network.symbol)) {
+        // Only used for broadcasts, which must reach a single endpoint
+        return router->post(network.symbol, path, body, false);
+    }
+
+    QString endpoint = !rpcUrl.isEmpty() ? rpcUrl : network.esploraUrl;
+    return NetworkService::instance()->transport()->post(QUrl(endpoint + path), body, "text/plain");
+}
+
+HttpResponse BitcoinAdapter::esploraGet(const QString &path)
+{
+    return HttpTransport::waitFor(esploraRequest(path));
+}
+
+bool BitcoinAdapter::hasEsplora() const
+{
+    return !rpcUrl.isEmpty() || !network.esploraUrl.isEmpty();
+}
+
+ElectrumClient *BitcoinAdapter::electrum() const
+{
+    // An explicit rpcUrl pins the adapter to that Esplora instance
+    NetworkService *service = NetworkService::instance();
+    if (!rpcUrl.isEmpty() || network.testnet || !service) {
+        return nullptr;
+    }
+    return service->electrum(network.symbol);
+}
+
+QString BitcoinAdapter::formatUnits(qint64 satoshis)
+{
+    // BTC, LTC and DOGE all use 8 decimals
+    return Amount(static_cast<quint64>(qMax<qint64>(0, satoshis)), 8).toString();
+}
+
+Transaction BitcoinAdapter::parseEsploraTransaction(const QJsonObject &tx, const QString &address) const
+{
+    Transaction result;
+    result.hash = tx["txid"].toString();
+    result.chainType = network.symbol;
+
+    QJsonObject status = tx["status"].toObject();
+    result.status = status["confirmed"].toBool() ? "confirmed" : "pending";
+    result.timestamp = status["block_time"].toVariant().toLongLong();
+
+    qint64 fee = tx["fee"].toVariant().toLongLong();
+    result.fee = formatUnits(fee);
+
+    // Net effect on this address: inputs it funded vs outputs it received
+    qint64 spent = 0;
+    qint64 received = 0;
+    QString counterpartyIn;
+    QString counterpartyOut;
+
+    for (const QJsonValue &input : tx["vin"].toArray()) {
+        QJsonObject prevout = input.toObject()["prevout"].toObject();
+        QString owner = prevout["scriptpubkey_address"].toString();
+        if (owner == address) {
+            spent += prevout["value"].toVariant().toLongLong();
+        } else if (counterpartyIn.isEmpty()) {
+            counterpartyIn = owner;
+        }
+    }
+    for (const QJsonValue &output : tx["vout"].toArray()) {
+        QJsonObject out = output.toObject();
+        QString owner = out["scriptpubkey_address"].toString();
+        if (owner == address) {
+            received += out["value"].toVariant().toLongLong();
+        } else if (counterpartyOut.isEmpty()) {
+            counterpartyOut = owner;
+        }
+    }
+
+    qint64 amount = 0;
+    if (spent > 0) {
+        // Outgoing: what left the wallet, excluding change and fee
+        result.from = address;
+        result.to = counterpartyOut.isEmpty() ? address : counterpartyOut;
+        amount = qMax<qint64>(0, spent - received - fee);
+    } else {
+        result.from = counterpartyIn;
+        result.to = address;
+        amount = received;
+    }
+    result.value = formatUnits(amount);
+
+    return result;
+}
+
+bool BitcoinAdapter::prepareSelection(const QString &from, const QString &to, const QString &gasPrice,
+                                      CoinSelector &selector, CoinSelectionParams &params)
+{
+    // Outputs of a script the wallet cannot sign are never selected
+    QByteArray toScript = network.scriptPubKey(to);
+    QByteArray fromScript = network.scriptPubKey(from);
+    if (toScript.isEmpty() || CoinSelector::inputVSize(fromScript) == 0) {
+        return false;
+    }
+
+    // A user-chosen fee rate is in sat/vB; below the relay floor it would
+    // never propagate
+    params.feeRate = feeRatePerKvB();
+    if (!gasPrice.isEmpty()) {
+        bool ok = false;
+        Amount rate = Amount::parse(gasPrice, 3, &ok);
+        if (ok && !rate.isZero()) {
+            params.feeRate = qMax<qint64>(network.minRelayFeeRate,
+                                          static_cast<qint64>(rate.units().toUInt64()));
+        }
+    }
+    params.fixedVSize = TX_OVERHEAD_VSIZE + 9 + toScript.size();
+    params.changeOutputVSize = 9 + fromScript.size();
+    params.changeSpendVSize = CoinSelector::inputVSize(fromScript);
+
+    QString scriptHex = QString::fromLatin1(fromScript.toHex());
+    QVector<UTXO> utxos;
+    for (const UnspentOutput &output : getUnspentOutputs(QStringList{from})) {
+        utxos.append({output.txid, static_cast<uint32_t>(output.vout), scriptHex, output.value});
+    }
+    selector.setUtxos(utxos);
+    return true;
 }
 
 QString BitcoinAdapter::estimateFee(const QString &from, const QString &to, const QString &amount)
 {
-    // TODO: Implement fee estimation
-    return "0.0001";
+    // The fee of the transaction createTransaction would build, from the
+    // same UTXOs, fee rate and coin selection
+    CoinSelector selector;
+    CoinSelectionParams params;
+    if (!prepareSelection(from, to, QString(), selector, params)) {
+        return QString();
+    }
+
+    // No amount: whatever a send of everything cannot deliver, so that the
+    // balance minus this is an amount createTransaction can fund. Outputs
+    // worth less than their input fee stay behind and count here too.
+    if (amount.isEmpty()) {
+        qint64 sendable = selector.maxSendable(params);
+        return sendable > 0 ? formatUnits(selector.totalValue() - sendable) : QString();
+    }
+
+    bool ok = false;
+    Amount value = Amount::parse(amount, 8, &ok);
+    if (!ok || value.isZero()) {
+        return QString();
+    }
+    CoinSelection selection = selector.select(static_cast<qint64>(value.units().toUInt64()), params);
+    return selection.ok() ? formatUnits(selection.fee) : QString();
+}
+
+qint64 BitcoinAdapter::feeRatePerKvB()
+{
+    // Rate for confirmation within FEE_TARGET_BLOCKS, floored at the chain's relay minimum
+    ElectrumClient *client = electrum();
+    if (client) {
+        ElectrumResponse response = HttpTransport::waitFor(
+            client->call("blockchain.estimatefee", QJsonArray{FEE_TARGET_BLOCKS}));
+        double coinsPerKb = response.ok() ? response.result.toDouble() : -1;
+        if (coinsPerKb > 0) {
+            return qMax<qint64>(network.minRelayFeeRate, qRound64(coinsPerKb * 1e8));
+        }
+    }
+
+    if (hasEsplora()) {
+        HttpResponse reply = esploraGet("/fee-estimates");
+        if (reply.ok()) {
+            QJsonObject estimates = QJsonDocument::fromJson(reply.body).object();
+            double satPerVb = estimates[QString::number(FEE_TARGET_BLOCKS)].toDouble();
+            if (satPerVb > 0) {
+                return qMax<qint64>(network.minRelayFeeRate, qRound64(satPerVb * 1000));
+            }
+        }
+    }
+
+    return network.defaultFeeRate;
 }
@@ -1,19 +1,45 @@
 /**
  * DEE WALLET - Bitcoin Chain Adapter
+ * Bitcoin-family UTXO chains (BTC, LTC, DOGE and testnets), parameterized
+ * by UtxoNetwork
  */
 
 #ifndef BITCOINADAPTER_H
 #define BITCOINADAPTER_H
 
 #include "ChainAdapter.h"
+#include "UtxoNetwork.h"
+#include <QJsonObject>
+#include <QFuture>
+
+struct HttpResponse;
+struct CoinSelectionParams;
+class ElectrumClient;
+class CoinSelector;
+
+// A spendable output owned by one of the queried addresses
+struct UnspentOutput {
+    QString txid;
+    int vout = 0;
+    qint64 value = 0;       // base units (satoshis)
+    qint64 height = 0;      // 0 = unconfirmed
+    QString address;
+};
 
 class BitcoinAdapter : public ChainAdapter {
 public:
     explicit BitcoinAdapter(const QString &rpcUrl, bool isTestnet = false);
+    BitcoinAdapter(const QString &rpcUrl, const UtxoNetwork &network);
 
     QString deriveAddress(const QByteArray &publicKey) override;
     bool validateAddress(const QString &address) override;
     QString getBalance(const QString &address) override;
+    QHash<QString, QString> getBalances(const QStringList &addresses) override;
+
+    // Unspent outputs of several addresses: one Electrum listunspent batch,
+    // or concurrent Esplora /utxo requests
+    QVector<UnspentOutput> getUnspentOutputs(const QStringList &addresses);
+    AddressActivity getActivity(const QString &address) override;
     QVector<Token> getTokens(const QString &address) override;
     QString createTransaction(const QString &from,
                              const QString &to,
@@ -22,10 +48,41 @@ public:
     QString signTransaction(const QString &rawTx, const QByteArray &privateKey) override;
     QString broadcastTransaction(const QString &signedTx) override;
     QVector<Transaction> getTransactionHistory(const QString &address, int limit) override;
+    QVector<Transaction> getTransactionsSince(const QString &address,
+                                              const QString &cursor,
+                                              QString &nextCursor) override;
     QString estimateFee(const QString &from, const QString &to, const QString &amount) override;
 
+    const UtxoNetwork &utxoNetwork() const { return network; }
+
 private:
-    bool isTestnet;
+    // Esplora GET; mainnet defaults go through the router
+    QFuture<HttpResponse> esploraRequest(const QString &path);
+    HttpResponse esploraGet(const QString &path);
+    QFuture<HttpResponse> esploraPost(const QString &path, const QByteArray &body);
+    bool hasEsplora() const;
+    Transaction parseEsploraTransaction(const QJsonObject &tx, const QString &address) const;
+
+    // The chain's persistent Electrum session, if one is configured
+    ElectrumClient *electrum() const;
+    static QString formatUnits(qint64 satoshis);
+
+    // Estimated fee rate in sat per 1000 vbytes
+    qint64 feeRatePerKvB();
+
+    // The sender's UTXOs and the selection parameters for a payment to to;
+    // gasPrice is a sat/vB override (empty = network estimate)
+    bool prepareSelection(const QString &from, const QString &to, const QString &gasPrice,
+                          CoinSelector &selector, CoinSelectionParams &params);
+
+    // Esplora returns confirmed transactions 25 per page
+    static constexpr int ESPLORA_PAGE_SIZE = 25;
+    static constexpr int MAX_HISTORY_PAGES = 20;
+
+    static constexpr int FEE_TARGET_BLOCKS = 6;
+    static constexpr int TX_OVERHEAD_VSIZE = 11;     // version, counts, locktime, SegWit marker
+
+    UtxoNetwork network;
 };
 
 #endif // BITCOINADAPTER_H
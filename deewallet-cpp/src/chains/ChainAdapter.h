@@ -9,6 +9,8 @@
 #include <QString>
 #include <QByteArray>
 #include <QVector>
+#include <QHash>
+#include <QStringList>
 
 struct Token {
     QString symbol;
@@ -24,9 +26,17 @@ struct Transaction {
     QString to;
     QString value;
     QString chainType;
-    qint64 timestamp;
+    qint64 timestamp;   // seconds since epoch
     QString status; // "pending", "confirmed", "failed"
     QString fee;
+    int logIndex = -1;  // EVM token transfers: the Transfer log's index in its block
+};
+
+// On-chain use of an address; Unknown when the query failed or was throttled
+enum class AddressActivity {
+    Unused,
+    Used,
+    Unknown
 };
 
 class ChainAdapter {
@@ -37,8 +47,25 @@ public:
     virtual QString deriveAddress(const QByteArray &publicKey) = 0;
     virtual bool validateAddress(const QString &address) = 0;
 
-    // Balance queries
+    // Balance queries; empty when the query failed, so an error is never
+    // mistaken for a zero balance
     virtual QString getBalance(const QString &address) = 0;
+
+    // Several addresses at once (address -> balance); addresses whose query
+    // failed are left out. Backends with a multi-address query override this.
+    virtual QHash<QString, QString> getBalances(const QStringList &addresses) {
+        QHash<QString, QString> balances;
+        for (const QString &address : addresses) {
+            QString balance = getBalance(address);
+            if (!balance.isEmpty()) {
+                balances.insert(address, balance);
+            }
+        }
+        return balances;
+    }
+
+    // Whether the address has ever been used on chain (BIP44 gap-limit discovery)
+    virtual AddressActivity getActivity(const QString &address) = 0;
     virtual QVector<Token> getTokens(const QString &address) = 0;
 
     // Transaction operations
@@ -55,7 +82,16 @@ public:
     virtual QVector<Transaction> getTransactionHistory(const QString &address,
                                                        int limit = 10) = 0;
 
-    // Fee estimation
+    // Incremental history: transactions newer than cursor, newest first.
+    // The cursor is chain specific (txid, signature, timestamp, block) and
+    // empty on the first sync; nextCursor receives the value for the next call.
+    virtual QVector<Transaction> getTransactionsSince(const QString &address,
+                                                      const QString &cursor,
+                                                      QString &nextCursor) = 0;
+
+    // Fee createTransaction(from, to, amount) would pay, in native units; an
+    // empty amount asks for the fee of sending the whole balance. Empty when
+    // it could not be estimated.
     virtual QString estimateFee(const QString &from,
                                const QString &to,
                                const QString &amount) = 0;
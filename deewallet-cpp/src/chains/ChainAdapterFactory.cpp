@@ -0,0 +1,26 @@
+/**
+ * DEE WALLET - Chain Adapter Factory Implementation
+ */
+
+#include "ChainAdapterFactory.h"
+#include "BitcoinAdapter.h"
+#include "EthereumAdapter.h"
+#include "TronAdapter.h"
+#include "SolanaAdapter.h"
+#include "../utils/AddressValidator.h"
+
+std::unique_ptr<ChainAdapter> ChainAdapterFactory::create(const QString &chainSymbol)
+{
+    // Empty rpcUrl = route through RPCManager
+    if (UtxoNetwork::isUtxoChain(chainSymbol)) {
+        return std::make_unique<BitcoinAdapter>("", UtxoNetwork::forChain(chainSymbol));
+    } else if (chainSymbol == "TRX") {
+        return std::make_unique<TronAdapter>("");
+    } else if (chainSymbol == "SOL") {
+        return std::make_unique<SolanaAdapter>("");
+    } else if (AddressValidator::isEvmChain(chainSymbol)) {
+        return std::make_unique<EthereumAdapter>("", EthereumAdapter::getChainId(chainSymbol));
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,19 @@
+/**
+ * DEE WALLET - Chain Adapter Factory
+ * Builds the adapter for a chain symbol, routed through RPCManager
+ */
+
+#ifndef CHAINADAPTERFACTORY_H
+#define CHAINADAPTERFACTORY_H
+
+#include <QString>
+#include <memory>
+#include "ChainAdapter.h"
+
+class ChainAdapterFactory {
+public:
+    // BTC, LTC, DOGE, TRX, SOL or any EVM chain symbol; nullptr if unknown
+    static std::unique_ptr<ChainAdapter> create(const QString &chainSymbol);
+};
+
+#endif // CHAINADAPTERFACTORY_H
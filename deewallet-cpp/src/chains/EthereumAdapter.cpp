@@ -3,20 +3,27 @@
  */
 
 #include "EthereumAdapter.h"
+#include "EvmBatchSender.h"
 #include "../utils/Keccak256.h"
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
-#include <QEventLoop>
+#include "../utils/AddressValidator.h"
+#include "../utils/AddressUtils.h"
+#include "../utils/TokenDetector.h"
+#include "../utils/UInt256.h"
+#include "../utils/Amount.h"
+#include "../utils/TransactionBuilder.h"
+#include "../rpc/RPCClient.h"
+#include "../rpc/HttpTransport.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QMap>
+#include <algorithm>
 
 EthereumAdapter::EthereumAdapter(const QString &rpcUrl, int chainId)
     : chainId(chainId)
 {
-    this->rpcUrl = rpcUrl.isEmpty() ? getRpcUrl("ETH") : rpcUrl;
+    // Empty = route through RPCManager's endpoints for this chain
+    this->rpcUrl = rpcUrl;
 }
 
 QString EthereumAdapter::deriveAddress(const QByteArray &publicKey)
@@ -41,90 +48,116 @@ QString EthereumAdapter::deriveAddress(const QByteArray &publicKey)
     }
 
     // Keccak256 hash of public key
-    QByteArray hash = Keccak256::hash(pubKeyData);
+    uint8_t hash[32];
+    Keccak256::hash(reinterpret_cast<const uint8_t*>(pubKeyData.constData()), pubKeyData.size(), hash);
 
-    // Take last 20 bytes
-    QByteArray addressBytes = hash.right(20);
+    // Take last 20 bytes and emit the EIP-55 checksummed form in the same pass
+    return toChecksumAddress(hash + 12);
+}
+
+QString EthereumAdapter::toChecksumAddress(const uint8_t addressBytes[20])
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    char lowerHex[40];
+    for (int i = 0; i < 20; ++i) {
+        lowerHex[2 * i] = HEX_DIGITS[addressBytes[i] >> 4];
+        lowerHex[2 * i + 1] = HEX_DIGITS[addressBytes[i] & 0x0f];
+    }
 
-    // Convert to hex string with 0x prefix
-    QString address = "0x" + addressBytes.toHex();
+    char out[42] = {'0', 'x'};
+    AddressUtils::applyEip55Checksum(lowerHex, out + 2);
 
-    return address;
+    return QString::fromLatin1(out, sizeof(out));
 }
 
-bool EthereumAdapter::validateAddress(const QString &address)
+QString EthereumAdapter::toChecksumAddress(const QString &address)
 {
-    if (!address.startsWith("0x")) {
-        return false;
+    QString hex = address.startsWith("0x", Qt::CaseInsensitive) ? address.mid(2) : address;
+    if (hex.length() != 40) {
+        return QString();
     }
 
-    if (address.length() != 42) {
-        return false;
+    QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
+    if (bytes.size() != 20) {
+        return QString();
     }
 
-    // Check if all characters are hex
-    QString hexPart = address.mid(2);
-    for (QChar c : hexPart) {
-        if (!c.isDigit() && !(c >= 'a' && c <= 'f') && !(c >= 'A' && c <= 'F')) {
-            return false;
-        }
+    return toChecksumAddress(reinterpret_cast<const uint8_t*>(bytes.constData()));
+}
+
+bool EthereumAdapter::isChecksumValid(const QString &address)
+{
+    // One Keccak over stack buffers; single-case input has no checksum to verify
+    char input[42];
+    if (AddressUtils::toAscii(address, input, sizeof(input)) != 42) {
+        return false;
     }
+    return AddressValidator::checkEvm(input, 42) == AddressValidator::Format::EvmChecksummed;
+}
 
-    return true;
+bool EthereumAdapter::validateAddress(const QString &address)
+{
+    // Hex format plus EIP-55 checksum for mixed-case input
+    return AddressValidator::validate("ETH", address);
 }
 
 QString EthereumAdapter::getBalance(const QString &address)
 {
-    // Use Infura public RPC endpoint
-    QString endpoint = rpcUrl.isEmpty() ? "https://eth.llamarpc.com" : rpcUrl;
-
-    QNetworkAccessManager manager;
-    QNetworkRequest request(endpoint);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    // Prepare JSON-RPC request
-    QJsonObject rpcRequest;
-    rpcRequest["jsonrpc"] = "2.0";
-    rpcRequest["method"] = "eth_getBalance";
+    QString symbol = getChainSymbol(chainId);
+    RPCClient client(rpcUrl.isEmpty() ? getRpcUrl(symbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(symbol);
+    }
     QJsonArray params;
     params.append(address);
     params.append("latest");
-    rpcRequest["params"] = params;
-    rpcRequest["id"] = 1;
-
-    QJsonDocument doc(rpcRequest);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
-
-    QNetworkReply *reply = manager.post(request, data);
-
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
-
-    QString balance = "0.0";
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument responseDoc = QJsonDocument::fromJson(response);
-        if (responseDoc.isObject()) {
-            QJsonObject responseObj = responseDoc.object();
-            QString hexBalance = responseObj["result"].toString();
-            // Convert hex Wei to ETH
-            bool ok;
-            quint64 wei = hexBalance.toULongLong(&ok, 16);
-            if (ok) {
-                double eth = wei / 1e18;
-                balance = QString::number(eth, 'f', 8);
-            }
+
+    QString balance;
+    QJsonValue result = client.call("eth_getBalance", params);
+    if (result.isString()) {
+        // Hex wei as a full uint256 (quint64 overflows above ~18.4 ETH)
+        bool ok;
+        UInt256 wei = UInt256::fromHex(result.toString(), &ok);
+        if (ok) {
+            balance = Amount(wei, 18).toString();
         }
     }
 
-    reply->deleteLater();
     return balance;
 }
 
+AddressActivity EthereumAdapter::getActivity(const QString &address)
+{
+    // A sent transaction bumps the nonce; receive-only addresses show a balance
+    QString symbol = getChainSymbol(chainId);
+    RPCClient client(rpcUrl.isEmpty() ? getRpcUrl(symbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(symbol);
+    }
+
+    QJsonArray params;
+    params.append(address);
+    params.append("latest");
+
+    RPCBatch batch = client.batch();
+    QFuture<QJsonValue> nonce = batch.add("eth_getTransactionCount", params);
+    QFuture<QJsonValue> balance = batch.add("eth_getBalance", params);
+    batch.send();
+
+    QJsonValue nonceValue = HttpTransport::waitFor(nonce);
+    QJsonValue balanceValue = HttpTransport::waitFor(balance);
+    bool nonceUsed = nonceValue.isString() && !UInt256::fromHex(nonceValue.toString()).isZero();
+    bool balanceUsed = balanceValue.isString() && !UInt256::fromHex(balanceValue.toString()).isZero();
+    if (nonceUsed || balanceUsed) {
+        return AddressActivity::Used;
+    }
+    return nonceValue.isString() && balanceValue.isString() ? AddressActivity::Unused
+                                                            : AddressActivity::Unknown;
+}
+
 QVector<Token> EthereumAdapter::getTokens(const QString &address)
 {
-    // TODO: Implement ERC-20 token balance queries
     return parseERC20Balances(address);
 }
 
@@ -133,45 +166,262 @@ QString EthereumAdapter::createTransaction(const QString &from,
                                            const QString &amount,
                                            const QString &gasPrice)
 {
-    // TODO: Implement RLP-encoded transaction creation
-    return QString();
+    // Unsigned EIP-1559 (or legacy) fields as JSON; signTransaction encodes them
+    EvmBatchSender sender(getChainSymbol(chainId), rpcUrl);
+    if (!sender.prepare(from)) {
+        return QString();
+    }
+
+    // A user-chosen gas price (Gwei) caps the max fee; the node's base fee
+    // headroom and tip are kept below it
+    if (!gasPrice.isEmpty()) {
+        bool ok = false;
+        Amount cap = Amount::parse(gasPrice, 9, &ok);
+        if (ok && !cap.isZero()) {
+            sender.capFees(cap.units());
+        }
+    }
+
+    EvmPayout payout;
+    payout.to = to;
+    payout.amount = amount;
+
+    EthereumTx tx;
+    if (!sender.buildTransaction(payout, sender.nextNonce(), tx)) {
+        return QString();
+    }
+
+    QJsonObject obj;
+    obj["type"] = tx.type;
+    obj["chainId"] = tx.chainId;
+    obj["nonce"] = tx.nonce;
+    obj["gasLimit"] = tx.gasLimit;
+    obj["to"] = tx.to;
+    obj["value"] = tx.value;
+    obj["data"] = tx.data;
+    obj["gasPrice"] = tx.gasPrice;
+    obj["maxFeePerGas"] = tx.maxFeePerGas;
+    obj["maxPriorityFeePerGas"] = tx.maxPriorityFeePerGas;
+    return QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact));
 }
 
 QString EthereumAdapter::signTransaction(const QString &rawTx, const QByteArray &privateKey)
 {
-    // TODO: Implement ECDSA signing with secp256k1
-    return QString();
+    QJsonObject obj = QJsonDocument::fromJson(rawTx.toUtf8()).object();
+    if (obj.isEmpty()) {
+        return QString();
+    }
+
+    EthereumTx tx;
+    tx.type = obj["type"].toInt();
+    tx.chainId = obj["chainId"].toInt();
+    tx.nonce = obj["nonce"].toString();
+    tx.gasLimit = obj["gasLimit"].toString();
+    tx.to = obj["to"].toString();
+    tx.value = obj["value"].toString();
+    tx.data = obj["data"].toString();
+    tx.gasPrice = obj["gasPrice"].toString();
+    tx.maxFeePerGas = obj["maxFeePerGas"].toString();
+    tx.maxPriorityFeePerGas = obj["maxPriorityFeePerGas"].toString();
+
+    QByteArray raw = TransactionBuilder::signEthereumTransaction(tx, privateKey);
+    return raw.isEmpty() ? QString() : "0x" + QString::fromLatin1(raw.toHex());
 }
 
 QString EthereumAdapter::broadcastTransaction(const QString &signedTx)
 {
-    // TODO: Implement eth_sendRawTransaction RPC call
-    return QString();
+    if (signedTx.isEmpty()) {
+        return QString();
+    }
+
+    QString symbol = getChainSymbol(chainId);
+    RPCClient client(rpcUrl.isEmpty() ? getRpcUrl(symbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(symbol);
+    }
+
+    // Returns the transaction hash; an error leaves the result undefined
+    QJsonValue result = client.call("eth_sendRawTransaction", QJsonArray{signedTx});
+    return result.isString() ? result.toString() : QString();
 }
 
 QVector<Transaction> EthereumAdapter::getTransactionHistory(const QString &address, int limit)
 {
-    // TODO: Implement transaction history query (Etherscan API or RPC)
-    return QVector<Transaction>();
+    QString nextCursor;
+    QVector<Transaction> history = getTransactionsSince(address, QString(), nextCursor);
+    return history.mid(0, limit);
+}
+
+QVector<Transaction> EthereumAdapter::getTransactionsSince(const QString &address,
+                                                           const QString &cursor,
+                                                           QString &nextCursor)
+{
+    // Cursor = last scanned block. Token transfers are found through
+    // Transfer logs with this address as sender or recipient; plain RPC has
+    // no index for native value transfers, so those are not listed.
+    nextCursor = cursor;
+
+    QString symbol = getChainSymbol(chainId);
+    RPCClient client(rpcUrl.isEmpty() ? getRpcUrl(symbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(symbol);
+    }
+
+    bool ok = false;
+    QJsonValue headResult = client.call("eth_blockNumber", QJsonArray());
+    qint64 head = static_cast<qint64>(UInt256::fromHex(headResult.toString(), &ok).toUInt64());
+    if (!ok || head == 0) {
+        return QVector<Transaction>();
+    }
+
+    qint64 fromBlock = cursor.isEmpty() ? qMax<qint64>(0, head - INITIAL_LOG_WINDOW)
+                                        : cursor.toLongLong() + 1;
+    if (fromBlock > head) {
+        return QVector<Transaction>();
+    }
+
+    // Known tokens only; arbitrary contracts emitting Transfer are mostly spam
+    QMap<QString, Token> knownTokens;
+    for (const Token &token : TokenDetector::getPopularTokens(symbol)) {
+        knownTokens.insert(token.contractAddress.toLower(), token);
+    }
+
+    QString paddedAddress = "0x000000000000000000000000" + address.mid(2).toLower();
+
+    // Every range as two eth_getLogs calls (outgoing, incoming), all in one
+    // batch. A cursor far behind the head catches up over several syncs.
+    struct RangeQuery {
+        qint64 endBlock;
+        QFuture<QJsonValue> outgoing;
+        QFuture<QJsonValue> incoming;
+    };
+    QVector<RangeQuery> ranges;
+
+    RPCBatch batch = client.batch();
+    for (qint64 start = fromBlock; start <= head && ranges.size() < MAX_LOG_RANGES;
+         start += LOG_BLOCK_RANGE) {
+        qint64 end = qMin(head, start + LOG_BLOCK_RANGE - 1);
+
+        QJsonObject filter;
+        filter["fromBlock"] = UInt256(static_cast<uint64_t>(start)).toHex();
+        filter["toBlock"] = UInt256(static_cast<uint64_t>(end)).toHex();
+
+        QJsonObject outgoingFilter = filter;
+        outgoingFilter["topics"] = QJsonArray{TRANSFER_TOPIC, paddedAddress};
+        QJsonObject incomingFilter = filter;
+        incomingFilter["topics"] = QJsonArray{TRANSFER_TOPIC, QJsonValue(), paddedAddress};
+
+        RangeQuery range;
+        range.endBlock = end;
+        range.outgoing = batch.add("eth_getLogs", QJsonArray{outgoingFilter});
+        range.incoming = batch.add("eth_getLogs", QJsonArray{incomingFilter});
+        ranges.append(range);
+    }
+    batch.send();
+
+    // Advance the cursor only across ranges that fully succeeded, in order
+    QVector<QJsonObject> logs;
+    for (const RangeQuery &range : ranges) {
+        QJsonValue outgoing = HttpTransport::waitFor(range.outgoing);
+        QJsonValue incoming = HttpTransport::waitFor(range.incoming);
+        if (!outgoing.isArray() || !incoming.isArray()) {
+            break;
+        }
+
+        for (const QJsonValue &log : outgoing.toArray()) {
+            logs.append(log.toObject());
+        }
+        for (const QJsonValue &log : incoming.toArray()) {
+            logs.append(log.toObject());
+        }
+        nextCursor = QString::number(range.endBlock);
+    }
+
+    // Block timestamps, one batched lookup per distinct block
+    QMap<QString, QFuture<QJsonValue>> blockQueries;
+    RPCBatch blockBatch = client.batch();
+    for (const QJsonObject &log : logs) {
+        QString blockNumber = log["blockNumber"].toString();
+        if (!blockQueries.contains(blockNumber)) {
+            blockQueries.insert(blockNumber, blockBatch.add("eth_getBlockByNumber",
+                                                            QJsonArray{blockNumber, false}));
+        }
+    }
+    blockBatch.send();
+
+    QVector<Transaction> transactions;
+    for (const QJsonObject &log : logs) {
+        QJsonArray topics = log["topics"].toArray();
+        auto token = knownTokens.constFind(log["address"].toString().toLower());
+        // ERC-721 transfers index the token id as a fourth topic
+        if (topics.size() != 3 || token == knownTokens.constEnd() || log["removed"].toBool()) {
+            continue;
+        }
+
+        // One transaction can emit several transfers; the log index tells them apart
+        Transaction tx;
+        tx.hash = log["transactionHash"].toString();
+        tx.logIndex = static_cast<int>(UInt256::fromHex(log["logIndex"].toString()).toUInt64());
+        tx.chainType = symbol;
+        tx.from = toChecksumAddress("0x" + topics[1].toString().right(40));
+        tx.to = toChecksumAddress("0x" + topics[2].toString().right(40));
+        tx.value = UInt256::fromHex(log["data"].toString()).formatUnits(token->decimals) + " " + token->symbol;
+        tx.status = "confirmed";
+
+        QJsonValue block = HttpTransport::waitFor(blockQueries.value(log["blockNumber"].toString()));
+        tx.timestamp = static_cast<qint64>(
+            UInt256::fromHex(block.toObject()["timestamp"].toString()).toUInt64());
+
+        transactions.append(tx);
+    }
+
+    // Newest first, like the other adapters
+    std::sort(transactions.begin(), transactions.end(), [](const Transaction &a, const Transaction &b) {
+        return a.timestamp > b.timestamp;
+    });
+    return transactions;
 }
 
 QString EthereumAdapter::estimateFee(const QString &from, const QString &to, const QString &amount)
 {
-    // TODO: Implement eth_gasPrice and eth_estimateGas RPC calls
-    return "0.001";
+    Q_UNUSED(to);
+    Q_UNUSED(amount);
+
+    // The most createTransaction's transfer can cost: its max fee per gas
+    // (twice the base fee plus the tip, or the legacy gas price) times its
+    // gas limit. Empty when the fee query failed.
+    EvmBatchSender sender(getChainSymbol(chainId), rpcUrl);
+    if (!sender.prepare(from)) {
+        return QString();
+    }
+
+    bool overflow = false;
+    UInt256 fee = sender.feePerGas().mulSmall(static_cast<uint32_t>(EvmBatchSender::TRANSFER_GAS), &overflow);
+    if (overflow) {
+        return QString();
+    }
+    return Amount(fee, 18).toString();
 }
 
-QString EthereumAdapter::encodeERC20Transfer(const QString &to, const QString &amount)
+QString EthereumAdapter::encodeERC20Transfer(const QString &to, const UInt256 &amount)
 {
-    // TODO: Implement ERC-20 transfer ABI encoding
-    // Method: transfer(address,uint256)
-    return QString();
+    QByteArray address = QByteArray::fromHex(to.startsWith("0x") ? to.mid(2).toLatin1() : to.toLatin1());
+    if (address.size() != 20) {
+        return QString();
+    }
+
+    // Selector of transfer(address,uint256), then both arguments as 32-byte words
+    QByteArray data = QByteArray::fromHex("a9059cbb");
+    data.append(QByteArray(12, '\0'));
+    data.append(address);
+    data.append(amount.toBigEndian());
+    return "0x" + QString::fromLatin1(data.toHex());
 }
 
 QVector<Token> EthereumAdapter::parseERC20Balances(const QString &address)
 {
-    // TODO: Query popular ERC-20 contracts
-    return QVector<Token>();
+    // Popular tokens for this chain in one Multicall3 aggregate3 call
+    return TokenDetector::detectERC20Tokens(address, getChainSymbol(chainId));
 }
 
 // EVM Chain configuration
@@ -211,6 +461,24 @@ int EthereumAdapter::getChainId(const QString &chainSymbol)
     return chainIds.value(chainSymbol, 1);
 }
 
+QString EthereumAdapter::getChainSymbol(int chainId)
+{
+    static QMap<int, QString> chainSymbols = {
+        {1, "ETH"},
+        {56, "BNB"},
+        {137, "POL"},
+        {42161, "ARB"},
+        {10, "OP"},
+        {43114, "AVAX"},
+        {8453, "BASE"},
+        {250, "FTM"},
+        {25, "CRO"},
+        {100, "xDAI"}
+    };
+
+    return chainSymbols.value(chainId, "ETH");
+}
+
 QString EthereumAdapter::getExplorerUrl(const QString &chainSymbol)
 {
     static QMap<QString, QString> explorerUrls = {
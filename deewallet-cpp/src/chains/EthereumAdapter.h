@@ -6,6 +6,7 @@
 #define ETHEREUMADAPTER_H
 
 #include "ChainAdapter.h"
+#include "../utils/UInt256.h"
 
 class EthereumAdapter : public ChainAdapter {
 public:
@@ -14,6 +15,7 @@ public:
     QString deriveAddress(const QByteArray &publicKey) override;
     bool validateAddress(const QString &address) override;
     QString getBalance(const QString &address) override;
+    AddressActivity getActivity(const QString &address) override;
     QVector<Token> getTokens(const QString &address) override;
     QString createTransaction(const QString &from,
                              const QString &to,
@@ -22,17 +24,37 @@ public:
     QString signTransaction(const QString &rawTx, const QByteArray &privateKey) override;
     QString broadcastTransaction(const QString &signedTx) override;
     QVector<Transaction> getTransactionHistory(const QString &address, int limit) override;
+    QVector<Transaction> getTransactionsSince(const QString &address,
+                                              const QString &cursor,
+                                              QString &nextCursor) override;
     QString estimateFee(const QString &from, const QString &to, const QString &amount) override;
 
+    // EIP-55 checksummed address helpers
+    static QString toChecksumAddress(const uint8_t addressBytes[20]);
+    static QString toChecksumAddress(const QString &address);
+    static bool isChecksumValid(const QString &address);
+
     // EVM chain helpers
     static QString getRpcUrl(const QString &chainSymbol);
     static int getChainId(const QString &chainSymbol);
+    static QString getChainSymbol(int chainId);
     static QString getExplorerUrl(const QString &chainSymbol);
 
+    // ERC-20 Transfer(address,address,uint256) event signature (topic 0)
+    static constexpr const char *TRANSFER_TOPIC = "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+
 private:
-    // ERC-20 helpers
-    QString encodeERC20Transfer(const QString &to, const QString &amount);
+    // ERC-20 helpers; transfer(address,uint256) calldata ("0x..."), empty
+    // for an invalid recipient
+    static QString encodeERC20Transfer(const QString &to, const UInt256 &amount);
     QVector<Token> parseERC20Balances(const QString &address);
+
+    // Transfer log scan settings. Public nodes cap
+    // eth_getLogs ranges; the first sync only looks back a bounded window,
+    // and one sync scans at most MAX_LOG_RANGES ranges before returning.
+    static constexpr qint64 LOG_BLOCK_RANGE = 5000;
+    static constexpr qint64 INITIAL_LOG_WINDOW = 100000;
+    static constexpr int MAX_LOG_RANGES = 20;
     
     int chainId;
 };
@@ -0,0 +1,356 @@
+/**
+ * DEE WALLET - EVM Batch Sender Implementation
+ */
+
+#include "EvmBatchSender.h"
+#include "EthereumAdapter.h"
+#include "../rpc/RPCClient.h"
+#include "../rpc/HttpTransport.h"
+#include "../utils/Keccak256.h"
+#include "../utils/Amount.h"
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+// Native EVM currencies all carry 18 decimals
+const int NATIVE_DECIMALS = 18;
+
+// The node already holds this exact transaction (an earlier send got through)
+bool isAlreadyKnown(const QString &error)
+{
+    return error.contains("already known", Qt::CaseInsensitive)
+        || error.contains("known transaction", Qt::CaseInsensitive);
+}
+
+} // namespace
+
+EvmBatchSender::EvmBatchSender(const QString &chainSymbol, const QString &rpcUrl, QThreadPool *pool)
+    : chainSymbol(chainSymbol)
+    , rpcUrl(rpcUrl)
+    , chainId(EthereumAdapter::getChainId(chainSymbol))
+    , pool(pool ? pool : QThreadPool::globalInstance())
+    , baseNonce(0)
+    , nonceStale(false)
+    , eip1559(true)
+{
+}
+
+bool EvmBatchSender::prepare(const QString &from)
+{
+    this->from = from;
+    nonceStale = false;
+
+    RPCClient client(rpcUrl.isEmpty() ? EthereumAdapter::getRpcUrl(chainSymbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(chainSymbol);
+    }
+
+    RPCBatch batch = client.batch();
+    QFuture<QJsonValue> nonce = batch.add("eth_getTransactionCount", QJsonArray{from, "pending"});
+    QFuture<QJsonValue> block = batch.add("eth_getBlockByNumber", QJsonArray{"latest", false});
+    QFuture<QJsonValue> tip = batch.add("eth_maxPriorityFeePerGas", QJsonArray());
+    QFuture<QJsonValue> gasPrice = batch.add("eth_gasPrice", QJsonArray());
+    batch.send();
+
+    // Pending count so transactions still in the mempool are not replaced
+    QJsonValue nonceValue = HttpTransport::waitFor(nonce);
+    if (!nonceValue.isString()) {
+        return false;
+    }
+    baseNonce = UInt256::fromHex(nonceValue.toString()).toUInt64();
+
+    bool hasBaseFee = false;
+    UInt256 baseFee = UInt256::fromHex(HttpTransport::waitFor(block).toObject().value("baseFeePerGas").toString(),
+                                       &hasBaseFee);
+    QJsonValue tipValue = HttpTransport::waitFor(tip);
+    QJsonValue gasPriceValue = HttpTransport::waitFor(gasPrice);
+
+    if (hasBaseFee && tipValue.isString()) {
+        // Headroom for the base fee doubling over the next blocks
+        eip1559 = true;
+        maxPriorityFeePerGas = UInt256::fromHex(tipValue.toString());
+        maxFeePerGas = baseFee.mulSmall(2).add(maxPriorityFeePerGas);
+        return true;
+    }
+
+    if (!gasPriceValue.isString()) {
+        return false;
+    }
+    eip1559 = false;
+    maxFeePerGas = UInt256::fromHex(gasPriceValue.toString());
+    maxPriorityFeePerGas = UInt256();
+    return true;
+}
+
+bool EvmBatchSender::refreshNonce()
+{
+    RPCClient client(rpcUrl.isEmpty() ? EthereumAdapter::getRpcUrl(chainSymbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(chainSymbol);
+    }
+
+    QJsonValue nonceValue = client.call("eth_getTransactionCount", QJsonArray{from, "pending"});
+    if (!nonceValue.isString()) {
+        return false;
+    }
+    baseNonce = UInt256::fromHex(nonceValue.toString()).toUInt64();
+    nonceStale = false;
+    return true;
+}
+
+void EvmBatchSender::setFees(const UInt256 &maxFeePerGas, const UInt256 &maxPriorityFeePerGas)
+{
+    this->maxFeePerGas = maxFeePerGas;
+    this->maxPriorityFeePerGas = maxPriorityFeePerGas.compare(maxFeePerGas) > 0
+        ? maxFeePerGas : maxPriorityFeePerGas;
+}
+
+void EvmBatchSender::capFees(const UInt256 &cap)
+{
+    if (maxFeePerGas.compare(cap) > 0) {
+        setFees(cap, maxPriorityFeePerGas);
+    }
+}
+
+bool EvmBatchSender::buildTransaction(const EvmPayout &payout, quint64 nonce,
+                                      EthereumTx &tx, QString *error) const
+{
+    bool ok = false;
+    Amount value = Amount::parse(payout.amount, NATIVE_DECIMALS, &ok);
+    if (!ok) {
+        if (error) {
+            *error = "Invalid amount: " + payout.amount;
+        }
+        return false;
+    }
+    if (!payout.data.isEmpty() && payout.gasLimit == 0) {
+        if (error) {
+            *error = "Gas limit required for contract calls";
+        }
+        return false;
+    }
+
+    tx.type = eip1559 ? 2 : 0;
+    tx.chainId = chainId;
+    tx.nonce = UInt256(nonce).toHex();
+    tx.gasLimit = UInt256(payout.gasLimit ? payout.gasLimit : TRANSFER_GAS).toHex();
+    tx.to = payout.to;
+    tx.value = value.units().toHex();
+    tx.data = payout.data;
+    if (eip1559) {
+        tx.maxFeePerGas = maxFeePerGas.toHex();
+        tx.maxPriorityFeePerGas = maxPriorityFeePerGas.toHex();
+    } else {
+        tx.gasPrice = maxFeePerGas.toHex();
+    }
+    return true;
+}
+
+QString EvmBatchSender::transactionHash(const QByteArray &raw)
+{
+    uint8_t hash[32];
+    Keccak256::hash(reinterpret_cast<const uint8_t*>(raw.constData()), raw.size(), hash);
+    return "0x" + QString::fromLatin1(QByteArray(reinterpret_cast<const char*>(hash), 32).toHex());
+}
+
+QVector<EvmSignedTx> EvmBatchSender::signAll(const QVector<EvmPayout> &payouts,
+                                             const QByteArray &privateKey)
+{
+    // Payouts are validated before any nonce is handed out: a rejected
+    // payout must not leave a gap that strands every later transaction
+    struct SigningJob {
+        int index;
+        EthereumTx tx;
+    };
+
+    QVector<EvmSignedTx> transactions(payouts.size());
+
+    // A nonce from before a broadcast with an unknown outcome could replace
+    // a transaction that is already pending
+    if (nonceStale && !refreshNonce()) {
+        for (int i = 0; i < payouts.size(); ++i) {
+            transactions[i].to = payouts[i].to;
+            transactions[i].error = "Nonce unknown after a failed broadcast; try again later";
+        }
+        return transactions;
+    }
+
+    QVector<SigningJob> jobs;
+    jobs.reserve(payouts.size());
+    quint64 nonce = baseNonce;
+    for (int i = 0; i < payouts.size(); ++i) {
+        transactions[i].to = payouts[i].to;
+        EthereumTx tx;
+        if (buildTransaction(payouts[i], nonce, tx, &transactions[i].error)) {
+            transactions[i].nonce = nonce++;
+            jobs.append({i, tx});
+        }
+    }
+
+    EvmSignedTx *results = transactions.data();
+    QtConcurrent::blockingMap(pool, jobs, [results, &privateKey](const SigningJob &job) {
+        EvmSignedTx &result = results[job.index];
+        result.raw = TransactionBuilder::signEthereumTransaction(job.tx, privateKey);
+        if (result.raw.isEmpty()) {
+            result.error = "Signing failed";
+        } else {
+            result.hash = transactionHash(result.raw);
+        }
+    });
+
+    // Nonces past a signing failure cannot be mined; only the run before it counts
+    quint64 signedCount = 0;
+    bool failed = false;
+    for (const SigningJob &job : jobs) {
+        EvmSignedTx &tx = transactions[job.index];
+        if (!tx.ok()) {
+            failed = true;
+        } else if (failed) {
+            tx.raw.clear();
+            tx.hash.clear();
+            tx.error = "Not signed: an earlier nonce failed";
+        } else {
+            ++signedCount;
+        }
+    }
+
+    baseNonce += signedCount;
+    return transactions;
+}
+
+void EvmBatchSender::broadcast(QVector<EvmSignedTx> &transactions)
+{
+    HttpTransport::PriorityScope sendPriority(HttpTransport::Priority::UserAction);
+
+    RPCClient client(rpcUrl.isEmpty() ? EthereumAdapter::getRpcUrl(chainSymbol) : rpcUrl);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute(chainSymbol);
+    }
+
+    // Only a gap-free run of nonces is sent
+    QVector<int> order;
+    for (int i = 0; i < transactions.size(); ++i) {
+        if (transactions[i].ok()) {
+            order.append(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&transactions](int a, int b) {
+        return transactions[a].nonce < transactions[b].nonce;
+    });
+    for (int i = 1; i < order.size(); ++i) {
+        if (transactions[order[i]].nonce != transactions[order[i - 1]].nonce + 1) {
+            for (int j = i; j < order.size(); ++j) {
+                transactions[order[j]].error = "Not sent: nonce gap before "
+                    + QString::number(transactions[order[i]].nonce);
+            }
+            order.resize(i);
+            break;
+        }
+    }
+
+    // One call per nonce, each after the previous was answered: batches are
+    // split into concurrent POSTs, so a node could see nonce N+1 before N
+    QString stopReason;
+    for (int index : order) {
+        EvmSignedTx &tx = transactions[index];
+        if (!stopReason.isEmpty()) {
+            tx.error = stopReason;
+            continue;
+        }
+
+        QString raw = "0x" + QString::fromLatin1(tx.raw.toHex());
+        RPCResponse response = HttpTransport::waitFor(
+            client.requestResponse("eth_sendRawTransaction", QJsonArray{raw}));
+        if (response.ok() || (response.delivered && isAlreadyKnown(response.error))) {
+            continue;
+        }
+
+        QString nonce = QString::number(tx.nonce);
+        if (response.delivered) {
+            // Rejected: the nonce is still free and every later one would wait on it
+            tx.error = "Rejected by the node: " + response.error;
+            stopReason = "Not sent: nonce " + nonce + " was rejected";
+            baseNonce = qMin(baseNonce, tx.nonce);
+        } else {
+            // Unknown outcome: the transaction may be pending, so its nonce
+            // is not reused until the node's pending count says so
+            tx.error = "Broadcast failed (" + response.error + "); the transaction may still be pending";
+            stopReason = "Not sent: the outcome of nonce " + nonce + " is unknown";
+            nonceStale = true;
+        }
+    }
+
+    if (nonceStale) {
+        refreshNonce();
+    }
+}
+
+QFuture<QVector<EvmReceipt>> EvmBatchSender::trackReceipts(const QStringList &hashes, int timeoutMs) const
+{
+    // Occupies one pool thread for the lifetime of the poll
+    QString symbol = chainSymbol;
+    QString endpoint = rpcUrl;
+    return QtConcurrent::run(pool, [symbol, endpoint, hashes, timeoutMs]() {
+        HttpTransport::PriorityScope backgroundPriority(HttpTransport::Priority::Background);
+
+        RPCClient client(endpoint.isEmpty() ? EthereumAdapter::getRpcUrl(symbol) : endpoint);
+        if (endpoint.isEmpty()) {
+            client.setChainRoute(symbol);
+        }
+
+        QHash<QString, EvmReceipt> mined;
+        QStringList pending = hashes;
+        QElapsedTimer timer;
+        timer.start();
+
+        while (!pending.isEmpty()) {
+            RPCBatch batch = client.batch();
+            QVector<QFuture<QJsonValue>> futures;
+            futures.reserve(pending.size());
+            for (const QString &hash : pending) {
+                futures.append(batch.add("eth_getTransactionReceipt", QJsonArray{hash}));
+            }
+            batch.send();
+
+            // Unknown or not yet mined transactions come back as null
+            QStringList stillPending;
+            for (int i = 0; i < pending.size(); ++i) {
+                QJsonObject obj = HttpTransport::waitFor(futures[i]).toObject();
+                if (obj.isEmpty()) {
+                    stillPending.append(pending[i]);
+                    continue;
+                }
+
+                EvmReceipt receipt;
+                receipt.mined = true;
+                receipt.success = UInt256::fromHex(obj["status"].toString()).toUInt64() == 1;
+                receipt.blockNumber = UInt256::fromHex(obj["blockNumber"].toString()).toUInt64();
+                receipt.gasUsed = UInt256::fromHex(obj["gasUsed"].toString());
+                receipt.effectiveGasPrice = UInt256::fromHex(obj["effectiveGasPrice"].toString());
+                mined.insert(pending[i], receipt);
+            }
+            pending = stillPending;
+
+            if (pending.isEmpty() || timer.elapsed() + RECEIPT_POLL_MS > timeoutMs) {
+                break;
+            }
+            QThread::msleep(RECEIPT_POLL_MS);
+        }
+
+        QVector<EvmReceipt> receipts;
+        receipts.reserve(hashes.size());
+        for (const QString &hash : hashes) {
+            EvmReceipt receipt = mined.value(hash);
+            receipt.hash = hash;
+            receipts.append(receipt);
+        }
+        return receipts;
+    });
+}
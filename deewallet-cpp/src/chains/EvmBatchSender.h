@@ -0,0 +1,117 @@
+/**
+ * DEE WALLET - EVM Batch Sender
+ * Many transfers from one account: a single nonce/fee round trip, local
+ * sequential nonces, EIP-1559 signing across worker threads, in-order
+ * eth_sendRawTransaction calls and asynchronous receipt polling
+ */
+
+#ifndef EVMBATCHSENDER_H
+#define EVMBATCHSENDER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QByteArray>
+#include <QFuture>
+#include "../utils/UInt256.h"
+#include "../utils/TransactionBuilder.h"
+
+class QThreadPool;
+
+struct EvmPayout {
+    QString to;
+    QString amount;         // native units, decimal ("0.25")
+    QString data;           // optional calldata (hex)
+    quint64 gasLimit = 0;   // 0 = 21000; required when data is set
+};
+
+struct EvmSignedTx {
+    quint64 nonce = 0;
+    QString to;
+    QByteArray raw;         // typed envelope, ready for eth_sendRawTransaction
+    QString hash;           // Keccak-256 of raw
+    QString error;          // signing or broadcast failure
+
+    bool ok() const { return error.isEmpty() && !raw.isEmpty(); }
+};
+
+struct EvmReceipt {
+    QString hash;
+    bool mined = false;     // false = still pending when tracking timed out
+    bool success = false;   // receipt status 0x1
+    quint64 blockNumber = 0;
+    UInt256 gasUsed;
+    UInt256 effectiveGasPrice;
+};
+
+class EvmBatchSender {
+public:
+    // RPC goes to rpcUrl when set (testnets, custom nodes), otherwise through
+    // the router for chainSymbol. Signing runs on pool (the global pool when null).
+    explicit EvmBatchSender(const QString &chainSymbol, const QString &rpcUrl = QString(),
+                            QThreadPool *pool = nullptr);
+
+    // Pending nonce and fees for from in one batched round trip (blocking).
+    // Chains without a base fee are sent as legacy transactions.
+    bool prepare(const QString &from);
+
+    quint64 nextNonce() const { return baseNonce; }
+    bool isEip1559() const { return eip1559; }
+
+    // Max fee per gas (gas price on legacy chains) transactions are built with
+    const UInt256 &feePerGas() const { return maxFeePerGas; }
+
+    // Override the quoted fees (wei); tip is ignored for legacy chains
+    void setFees(const UInt256 &maxFeePerGas, const UInt256 &maxPriorityFeePerGas);
+
+    // Lowers the prepared max fee (gas price on legacy chains) to at most
+    // cap, keeping the node's tip unless it exceeds the new max fee
+    void capFees(const UInt256 &cap);
+
+    // Unsigned transaction for payout at nonce with the current fees
+    bool buildTransaction(const EvmPayout &payout, quint64 nonce,
+                          EthereumTx &tx, QString *error = nullptr) const;
+
+    // Consecutive nonces from nextNonce() go to the payouts that validate,
+    // in payout order; invalid payouts get error set and no nonce.
+    // nextNonce() advances by the number actually signed. After a broadcast
+    // whose outcome is unknown the pending nonce is queried again first.
+    QVector<EvmSignedTx> signAll(const QVector<EvmPayout> &payouts, const QByteArray &privateKey);
+
+    // Sends the gap-free nonce run one transaction at a time, each only after
+    // the node answered for the previous nonce. A node's rejection stops the
+    // run and rewinds nextNonce() to the rejected nonce; a transport failure
+    // stops it too, and nextNonce() is re-read from the node's pending count,
+    // since the transaction may already be in the mempool.
+    void broadcast(QVector<EvmSignedTx> &transactions);
+
+    // Polls eth_getTransactionReceipt for the outstanding hashes in batches
+    // until all are mined or timeoutMs passes
+    QFuture<QVector<EvmReceipt>> trackReceipts(const QStringList &hashes,
+                                               int timeoutMs = RECEIPT_TIMEOUT_MS) const;
+
+    // "0x" Keccak-256 of a signed raw transaction
+    static QString transactionHash(const QByteArray &raw);
+
+    static constexpr quint64 TRANSFER_GAS = 21000;
+    static constexpr int RECEIPT_POLL_MS = 3000;
+    static constexpr int RECEIPT_TIMEOUT_MS = 300000;
+
+private:
+    // eth_getTransactionCount(from, "pending") into baseNonce
+    bool refreshNonce();
+
+    QString chainSymbol;
+    QString rpcUrl;
+    int chainId;
+    QThreadPool *pool;
+
+    QString from;
+    quint64 baseNonce;
+    bool nonceStale;                // a broadcast's outcome is unknown
+    bool eip1559;
+    UInt256 maxFeePerGas;           // gasPrice for legacy chains
+    UInt256 maxPriorityFeePerGas;
+};
+
+#endif // EVMBATCHSENDER_H
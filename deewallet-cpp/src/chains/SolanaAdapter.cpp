@@ -4,10 +4,10 @@
 
 #include "SolanaAdapter.h"
 #include "../utils/AddressUtils.h"
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
-#include <QEventLoop>
+#include "../utils/AddressValidator.h"
+#include "../utils/Amount.h"
+#include "../rpc/RPCClient.h"
+#include "../rpc/HttpTransport.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -45,7 +45,7 @@ QString SolanaAdapter::deriveAddress(const QByteArray &publicKey)
 bool SolanaAdapter::validateAddress(const QString &address)
 {
     // Solana addresses are Base58-encoded 32-byte keys (typically 32-44 chars)
-    return address.length() >= 32 && address.length() <= 44;
+    return AddressValidator::validate("SOL", address);
 }
 
 QString SolanaAdapter::getBalance(const QString &address)
@@ -53,45 +53,46 @@ QString SolanaAdapter::getBalance(const QString &address)
     // Use Solana RPC endpoint
     QString endpoint = rpcUrl.isEmpty() ? "https://api.mainnet-beta.solana.com" : rpcUrl;
 
-    QNetworkAccessManager manager;
-    QNetworkRequest request(endpoint);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    // Prepare JSON-RPC request
-    QJsonObject rpcRequest;
-    rpcRequest["jsonrpc"] = "2.0";
-    rpcRequest["method"] = "getBalance";
+    RPCClient client(endpoint);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute("SOL");
+    }
     QJsonArray params;
     params.append(address);
-    rpcRequest["params"] = params;
-    rpcRequest["id"] = 1;
-
-    QJsonDocument doc(rpcRequest);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
-
-    QNetworkReply *reply = manager.post(request, data);
-
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
-
-    QString balance = "0.0";
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument responseDoc = QJsonDocument::fromJson(response);
-        if (responseDoc.isObject()) {
-            QJsonObject responseObj = responseDoc.object();
-            QJsonObject result = responseObj["result"].toObject();
-            qint64 lamports = result["value"].toVariant().toLongLong();
-            double sol = lamports / 1e9; // Convert lamports to SOL
-            balance = QString::number(sol, 'f', 9);
-        }
+
+    QString balance;
+    QJsonValue result = client.call("getBalance", params);
+    if (result.isObject()) {
+        quint64 lamports = result.toObject()["value"].toVariant().toULongLong();
+        balance = Amount(lamports, LAMPORT_DECIMALS).toString();
     }
 
-    reply->deleteLater();
     return balance;
 }
 
+AddressActivity SolanaAdapter::getActivity(const QString &address)
+{
+    QString endpoint = rpcUrl.isEmpty() ? "https://api.mainnet-beta.solana.com" : rpcUrl;
+
+    RPCClient client(endpoint);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute("SOL");
+    }
+
+    QJsonObject options;
+    options["limit"] = 1;
+
+    QJsonArray params;
+    params.append(address);
+    params.append(options);
+
+    QJsonValue result = client.call("getSignaturesForAddress", params);
+    if (!result.isArray()) {
+        return AddressActivity::Unknown;
+    }
+    return result.toArray().isEmpty() ? AddressActivity::Unused : AddressActivity::Used;
+}
+
 QVector<Token> SolanaAdapter::getTokens(const QString &address)
 {
     // TODO: Implement SPL token account queries
@@ -123,8 +124,152 @@ QString SolanaAdapter::broadcastTransaction(const QString &signedTx)
 
 QVector<Transaction> SolanaAdapter::getTransactionHistory(const QString &address, int limit)
 {
-    // TODO: Implement getSignaturesForAddress RPC call
-    return QVector<Transaction>();
+    QString nextCursor;
+    QVector<Transaction> history = getTransactionsSince(address, QString(), nextCursor);
+    return history.mid(0, limit);
+}
+
+QVector<Transaction> SolanaAdapter::getTransactionsSince(const QString &address,
+                                                         const QString &cursor,
+                                                         QString &nextCursor)
+{
+    // Cursor = newest finalized signature. getSignaturesForAddress with
+    // "until" stops at it; "before" pages back through anything newer.
+    QString endpoint = rpcUrl.isEmpty() ? "https://api.mainnet-beta.solana.com" : rpcUrl;
+
+    RPCClient client(endpoint);
+    if (rpcUrl.isEmpty()) {
+        client.setChainRoute("SOL");
+    }
+
+    // The cursor moves only when paging ran down to the old cursor (or the
+    // start of history); on an error or the signature cap the old one is
+    // kept and the gap is paged again next time
+    QVector<Transaction> transactions;
+    nextCursor = cursor;
+    QString newestFinalized;
+    bool complete = false;
+    QString before;
+
+    while (transactions.size() < MAX_HISTORY_SIGNATURES) {
+        QJsonObject options;
+        options["limit"] = SIGNATURE_PAGE_SIZE;
+        if (!cursor.isEmpty()) {
+            options["until"] = cursor;
+        }
+        if (!before.isEmpty()) {
+            options["before"] = before;
+        }
+
+        QJsonArray params;
+        params.append(address);
+        params.append(options);
+
+        QJsonValue result = client.call("getSignaturesForAddress", params);
+        if (!result.isArray()) {
+            break;
+        }
+
+        QJsonArray signatures = result.toArray();
+        for (const QJsonValue &value : signatures) {
+            QJsonObject info = value.toObject();
+
+            Transaction tx;
+            tx.hash = info["signature"].toString();
+            tx.chainType = "SOL";
+            tx.timestamp = info["blockTime"].toVariant().toLongLong();
+            QString confirmation = info["confirmationStatus"].toString();
+            tx.status = !info["err"].isNull() ? "failed"
+                      : confirmation == "processed" ? "pending" : "confirmed";
+            transactions.append(tx);
+
+            // A processed signature can still be dropped; only finalized ones anchor the cursor
+            if (newestFinalized.isEmpty() && confirmation == "finalized") {
+                newestFinalized = tx.hash;
+            }
+        }
+
+        // A short page ends at "until" or at the account's first signature
+        if (signatures.size() < SIGNATURE_PAGE_SIZE) {
+            complete = true;
+            break;
+        }
+        before = transactions.last().hash;
+    }
+
+    if (complete && !newestFinalized.isEmpty()) {
+        nextCursor = newestFinalized;
+    }
+
+    // Amounts and counterparties for the new signatures only, in batched getTransaction calls
+    RPCBatch batch = client.batch();
+    QVector<QFuture<QJsonValue>> details;
+    for (const Transaction &tx : transactions) {
+        QJsonObject config;
+        config["encoding"] = "json";
+        config["maxSupportedTransactionVersion"] = 0;
+
+        QJsonArray params;
+        params.append(tx.hash);
+        params.append(config);
+        details.append(batch.add("getTransaction", params));
+    }
+    batch.send();
+
+    for (int i = 0; i < transactions.size(); ++i) {
+        QJsonValue result = HttpTransport::waitFor(details[i]);
+        if (result.isObject()) {
+            applyTransactionDetails(transactions[i], result.toObject(), address);
+        }
+    }
+
+    return transactions;
+}
+
+void SolanaAdapter::applyTransactionDetails(Transaction &tx, const QJsonObject &details,
+                                            const QString &address)
+{
+    QJsonArray accountKeys = details["transaction"].toObject()["message"].toObject()["accountKeys"].toArray();
+    QJsonObject meta = details["meta"].toObject();
+    QJsonArray preBalances = meta["preBalances"].toArray();
+    QJsonArray postBalances = meta["postBalances"].toArray();
+    qint64 fee = meta["fee"].toVariant().toLongLong();
+
+    tx.fee = Amount(static_cast<quint64>(fee), LAMPORT_DECIMALS).toString();
+    if (tx.timestamp == 0) {
+        tx.timestamp = details["blockTime"].toVariant().toLongLong();
+    }
+
+    int self = -1;
+    for (int i = 0; i < accountKeys.size(); ++i) {
+        if (accountKeys[i].toString() == address) {
+            self = i;
+            break;
+        }
+    }
+    if (self < 0 || self >= preBalances.size() || self >= postBalances.size()) {
+        return;
+    }
+
+    qint64 delta = postBalances[self].toVariant().toLongLong() - preBalances[self].toVariant().toLongLong();
+    if (self == 0) {
+        // The fee payer's delta includes the fee
+        delta += fee;
+    }
+
+    if (delta < 0) {
+        tx.from = address;
+        for (int i = 0; i < accountKeys.size() && i < preBalances.size() && i < postBalances.size(); ++i) {
+            if (i != self && postBalances[i].toVariant().toLongLong() > preBalances[i].toVariant().toLongLong()) {
+                tx.to = accountKeys[i].toString();
+                break;
+            }
+        }
+    } else {
+        tx.from = accountKeys.isEmpty() ? QString() : accountKeys[0].toString();
+        tx.to = address;
+    }
+    tx.value = Amount(static_cast<quint64>(qAbs(delta)), LAMPORT_DECIMALS).toString();
 }
 
 QString SolanaAdapter::estimateFee(const QString &from, const QString &to, const QString &amount)
@@ -6,6 +6,7 @@
 #define SOLANAADAPTER_H
 
 #include "ChainAdapter.h"
+#include <QJsonObject>
 
 class SolanaAdapter : public ChainAdapter {
 public:
@@ -14,6 +15,7 @@ public:
     QString deriveAddress(const QByteArray &publicKey) override;
     bool validateAddress(const QString &address) override;
     QString getBalance(const QString &address) override;
+    AddressActivity getActivity(const QString &address) override;
     QVector<Token> getTokens(const QString &address) override;
     QString createTransaction(const QString &from,
                              const QString &to,
@@ -22,11 +24,23 @@ public:
     QString signTransaction(const QString &rawTx, const QByteArray &privateKey) override;
     QString broadcastTransaction(const QString &signedTx) override;
     QVector<Transaction> getTransactionHistory(const QString &address, int limit) override;
+    QVector<Transaction> getTransactionsSince(const QString &address,
+                                              const QString &cursor,
+                                              QString &nextCursor) override;
     QString estimateFee(const QString &from, const QString &to, const QString &amount) override;
 
 private:
     // SPL Token helpers
     QVector<Token> parseSPLTokens(const QString &address);
+
+    static void applyTransactionDetails(Transaction &tx, const QJsonObject &details,
+                                        const QString &address);
+
+    static constexpr int LAMPORT_DECIMALS = 9;
+
+    // getSignaturesForAddress returns at most 1000 per call
+    static constexpr int SIGNATURE_PAGE_SIZE = 1000;
+    static constexpr int MAX_HISTORY_SIGNATURES = 1000;
 };
 
 #endif // SOLANAADAPTER_H
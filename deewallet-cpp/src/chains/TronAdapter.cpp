@@ -5,10 +5,11 @@
 #include "TronAdapter.h"
 #include "../utils/AddressUtils.h"
 #include "../utils/Keccak256.h"
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
-#include <QEventLoop>
+#include "../utils/AddressValidator.h"
+#include "../utils/Amount.h"
+#include "../rpc/HttpTransport.h"
+#include "../rpc/NetworkService.h"
+#include "../rpc/RPCManager.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -49,43 +50,55 @@ QString TronAdapter::deriveAddress(const QByteArray &publicKey)
 
 bool TronAdapter::validateAddress(const QString &address)
 {
-    return address.startsWith("T") && address.length() == 34;
+    // Base58Check with 0x41 prefix
+    return AddressValidator::validate("TRX", address);
 }
 
 QString TronAdapter::getBalance(const QString &address)
 {
     // Use TronGrid API for balance query
     QString endpoint = rpcUrl.isEmpty() ? "https://api.trongrid.io" : rpcUrl;
-    QString url = endpoint + "/v1/accounts/" + address;
-
-    QNetworkAccessManager manager;
-    QNetworkRequest request(url);
-    QNetworkReply *reply = manager.get(request);
-
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
-
-    QString balance = "0.0";
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(response);
-        if (doc.isObject()) {
+    QString path = "/v1/accounts/" + address;
+
+    // Default endpoints go through the health-checked router
+    RPCManager *router = NetworkService::instance()->rpcManager();
+    HttpResponse reply = HttpTransport::waitFor(rpcUrl.isEmpty() && router->hasChain("TRX")
+        ? router->get("TRX", path)
+        : NetworkService::instance()->transport()->get(QUrl(endpoint + path)));
+
+    QString balance;
+    if (reply.ok()) {
+        QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+        if (doc.isObject() && doc.object()["success"].toBool(true)) {
+            // An account that was never activated has no data entry: zero
             QJsonObject obj = doc.object();
             QJsonArray data = obj["data"].toArray();
-            if (!data.isEmpty()) {
-                QJsonObject accountData = data[0].toObject();
-                qint64 sunBalance = accountData["balance"].toVariant().toLongLong();
-                double trx = sunBalance / 1000000.0; // Convert SUN to TRX
-                balance = QString::number(trx, 'f', 6);
-            }
+            quint64 sun = data.isEmpty() ? 0 : data[0].toObject()["balance"].toVariant().toULongLong();
+            balance = Amount(sun, SUN_DECIMALS).toString();
         }
     }
 
-    reply->deleteLater();
     return balance;
 }
 
+AddressActivity TronAdapter::getActivity(const QString &address)
+{
+    // TronGrid only knows accounts that have been activated by a transfer
+    QString endpoint = rpcUrl.isEmpty() ? "https://api.trongrid.io" : rpcUrl;
+    QString path = "/v1/accounts/" + address;
+
+    RPCManager *router = NetworkService::instance()->rpcManager();
+    HttpResponse reply = HttpTransport::waitFor(rpcUrl.isEmpty() && router->hasChain("TRX")
+        ? router->get("TRX", path)
+        : NetworkService::instance()->transport()->get(QUrl(endpoint + path)));
+
+    QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+    if (!reply.ok() || !doc.isObject() || !doc.object()["success"].toBool(true)) {
+        return AddressActivity::Unknown;
+    }
+    return doc.object()["data"].toArray().isEmpty() ? AddressActivity::Unused : AddressActivity::Used;
+}
+
 QVector<Token> TronAdapter::getTokens(const QString &address)
 {
     // TODO: Implement TRC-20 token balance queries
@@ -115,8 +128,100 @@ QString TronAdapter::broadcastTransaction(const QString &signedTx)
 
 QVector<Transaction> TronAdapter::getTransactionHistory(const QString &address, int limit)
 {
-    // TODO: Implement transaction history query
-    return QVector<Transaction>();
+    QString nextCursor;
+    QVector<Transaction> history = getTransactionsSince(address, QString(), nextCursor);
+    return history.mid(0, limit);
+}
+
+QVector<Transaction> TronAdapter::getTransactionsSince(const QString &address,
+                                                       const QString &cursor,
+                                                       QString &nextCursor)
+{
+    // Cursor = newest block_timestamp (ms). TronGrid filters with min_timestamp
+    // and pages with the fingerprint from the previous response.
+    QString endpoint = rpcUrl.isEmpty() ? "https://api.trongrid.io" : rpcUrl;
+    RPCManager *router = NetworkService::instance()->rpcManager();
+
+    QVector<Transaction> transactions;
+    nextCursor = cursor;
+    qint64 newestTimestamp = cursor.toLongLong();
+    QString fingerprint;
+    bool complete = false;
+
+    for (int page = 0; page < MAX_HISTORY_PAGES; ++page) {
+        QString path = QString("/v1/accounts/%1/transactions?limit=%2&order_by=block_timestamp,desc")
+                           .arg(address)
+                           .arg(HISTORY_PAGE_SIZE);
+        if (!cursor.isEmpty()) {
+            path += "&min_timestamp=" + QString::number(cursor.toLongLong() + 1);
+        }
+        if (!fingerprint.isEmpty()) {
+            path += "&fingerprint=" + QString::fromLatin1(QUrl::toPercentEncoding(fingerprint));
+        }
+
+        HttpResponse reply = HttpTransport::waitFor(rpcUrl.isEmpty() && router->hasChain("TRX")
+            ? router->get("TRX", path)
+            : NetworkService::instance()->transport()->get(QUrl(endpoint + path)));
+        if (!reply.ok()) {
+            break;
+        }
+
+        QJsonObject obj = QJsonDocument::fromJson(reply.body).object();
+        for (const QJsonValue &value : obj["data"].toArray()) {
+            QJsonObject txJson = value.toObject();
+            newestTimestamp = qMax(newestTimestamp, txJson["block_timestamp"].toVariant().toLongLong());
+            transactions.append(parseTronGridTransaction(txJson));
+        }
+
+        // No fingerprint: the last page above min_timestamp
+        fingerprint = obj["meta"].toObject()["fingerprint"].toString();
+        if (fingerprint.isEmpty()) {
+            complete = true;
+            break;
+        }
+    }
+
+    // A page error or the page cap leaves transactions between the old
+    // cursor and where paging stopped unseen; keep the old cursor then
+    if (complete && newestTimestamp > 0) {
+        nextCursor = QString::number(newestTimestamp);
+    }
+    return transactions;
+}
+
+Transaction TronAdapter::parseTronGridTransaction(const QJsonObject &tx)
+{
+    Transaction result;
+    result.hash = tx["txID"].toString();
+    result.chainType = "TRX";
+    result.timestamp = tx["block_timestamp"].toVariant().toLongLong() / 1000;
+
+    QJsonObject ret = tx["ret"].toArray().at(0).toObject();
+    QString contractRet = ret["contractRet"].toString();
+    result.status = contractRet.isEmpty() || contractRet == "SUCCESS" ? "confirmed" : "failed";
+    result.fee = Amount(ret["fee"].toVariant().toULongLong(), SUN_DECIMALS).toString();
+
+    // Native TRX moves in TransferContract; other contracts carry no TRX amount
+    QJsonObject contract = tx["raw_data"].toObject()["contract"].toArray().at(0).toObject();
+    QJsonObject value = contract["parameter"].toObject()["value"].toObject();
+    result.from = hexToBase58(value["owner_address"].toString());
+    result.to = hexToBase58(value.contains("to_address") ? value["to_address"].toString()
+                                                         : value["contract_address"].toString());
+    quint64 sun = contract["type"].toString() == "TransferContract"
+        ? value["amount"].toVariant().toULongLong() : 0;
+    result.value = Amount(sun, SUN_DECIMALS).toString();
+
+    return result;
+}
+
+QString TronAdapter::hexToBase58(const QString &hexAddress)
+{
+    // TronGrid returns 41-prefixed hex addresses
+    QByteArray bytes = QByteArray::fromHex(hexAddress.toLatin1());
+    if (bytes.size() != 21 || static_cast<uint8_t>(bytes[0]) != 0x41) {
+        return hexAddress;
+    }
+    return AddressUtils::encodeBase58Check(bytes.mid(1), 0x41);
 }
 
 QString TronAdapter::estimateFee(const QString &from, const QString &to, const QString &amount)
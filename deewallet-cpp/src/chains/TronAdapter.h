@@ -6,6 +6,7 @@
 #define TRONADAPTER_H
 
 #include "ChainAdapter.h"
+#include <QJsonObject>
 
 class TronAdapter : public ChainAdapter {
 public:
@@ -14,6 +15,7 @@ public:
     QString deriveAddress(const QByteArray &publicKey) override;
     bool validateAddress(const QString &address) override;
     QString getBalance(const QString &address) override;
+    AddressActivity getActivity(const QString &address) override;
     QVector<Token> getTokens(const QString &address) override;
     QString createTransaction(const QString &from,
                              const QString &to,
@@ -22,7 +24,18 @@ public:
     QString signTransaction(const QString &rawTx, const QByteArray &privateKey) override;
     QString broadcastTransaction(const QString &signedTx) override;
     QVector<Transaction> getTransactionHistory(const QString &address, int limit) override;
+    QVector<Transaction> getTransactionsSince(const QString &address,
+                                              const QString &cursor,
+                                              QString &nextCursor) override;
     QString estimateFee(const QString &from, const QString &to, const QString &amount) override;
+
+private:
+    static Transaction parseTronGridTransaction(const QJsonObject &tx);
+    static QString hexToBase58(const QString &hexAddress);
+
+    static constexpr int SUN_DECIMALS = 6;
+    static constexpr int HISTORY_PAGE_SIZE = 200;
+    static constexpr int MAX_HISTORY_PAGES = 10;
 };
 
 #endif // TRONADAPTER_H
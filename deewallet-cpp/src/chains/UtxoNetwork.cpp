@@ -0,0 +1,101 @@
+/**
+ * DEE WALLET - UTXO Network Parameters Implementation
+ */
+
+#include "UtxoNetwork.h"
+#include "../utils/AddressUtils.h"
+
+static UtxoNetwork makeNetwork(const QString &symbol, bool testnet, const QString &hrp,
+                               quint8 p2pkhVersion, quint8 p2shVersion, int coinType,
+                               const QString &esploraUrl, qint64 minRelayFeeRate,
+                               qint64 defaultFeeRate)
+{
+    UtxoNetwork network;
+    network.symbol = symbol;
+    network.testnet = testnet;
+    network.hrp = hrp;
+    network.p2pkhVersion = p2pkhVersion;
+    network.p2shVersion = p2shVersion;
+    network.coinType = coinType;
+    network.esploraUrl = esploraUrl;
+    network.minRelayFeeRate = minRelayFeeRate;
+    network.defaultFeeRate = defaultFeeRate;
+    return network;
+}
+
+const UtxoNetwork &UtxoNetwork::forChain(const QString &chainType, bool testnet)
+{
+    // Relay floors follow each chain's node defaults: 1 sat/vB for Bitcoin,
+    // 0.0001 LTC/kB for Litecoin, 0.01 DOGE/kB for Dogecoin
+    static const UtxoNetwork bitcoin = makeNetwork("BTC", false, "bc", 0x00, 0x05, 0,
+                                                   "https://blockstream.info/api", 1000, 5000);
+    static const UtxoNetwork bitcoinTestnet = makeNetwork("BTC", true, "tb", 0x6f, 0xc4, 1,
+                                                          "https://blockstream.info/testnet/api", 1000, 5000);
+    static const UtxoNetwork litecoin = makeNetwork("LTC", false, "ltc", 0x30, 0x32, 2,
+                                                    "https://litecoinspace.org/api", 10000, 10000);
+    static const UtxoNetwork litecoinTestnet = makeNetwork("LTC", true, "tltc", 0x6f, 0x3a, 1,
+                                                           "https://litecoinspace.org/testnet/api", 10000, 10000);
+    // No SegWit and no public Esplora instance: P2PKH over Electrum
+    static const UtxoNetwork dogecoin = makeNetwork("DOGE", false, "", 0x1e, 0x16, 3, "",
+                                                    1000000, 1000000);
+    static const UtxoNetwork dogecoinTestnet = makeNetwork("DOGE", true, "", 0x71, 0xc4, 1, "",
+                                                           1000000, 1000000);
+
+    QString chain = chainType.toUpper();
+    if (chain == "LTC" || chain == "LITECOIN") {
+        return testnet ? litecoinTestnet : litecoin;
+    } else if (chain == "DOGE" || chain == "DOGECOIN") {
+        return testnet ? dogecoinTestnet : dogecoin;
+    }
+    return testnet ? bitcoinTestnet : bitcoin;
+}
+
+bool UtxoNetwork::isUtxoChain(const QString &chainType)
+{
+    QString chain = chainType.toUpper();
+    return chain == "BTC" || chain == "BITCOIN"
+        || chain == "LTC" || chain == "LITECOIN"
+        || chain == "DOGE" || chain == "DOGECOIN";
+}
+
+QByteArray UtxoNetwork::scriptPubKey(const QString &address) const
+{
+    QByteArray script;
+
+    if (!hrp.isEmpty()) {
+        int witnessVersion = -1;
+        QByteArray program = AddressUtils::decodeSegwitAddress(address, hrp, witnessVersion);
+        if (!program.isEmpty()) {
+            // OP_0 / OP_1..OP_16, push program
+            script.append(static_cast<char>(witnessVersion == 0 ? 0x00 : 0x50 + witnessVersion));
+            script.append(static_cast<char>(program.size()));
+            script.append(program);
+            return script;
+        }
+    }
+
+    // Base58Check: version byte, 20-byte hash, 4-byte checksum
+    QByteArray decoded = AddressUtils::decodeBase58(address);
+    if (decoded.size() != 25 || AddressUtils::sha256d(decoded.left(21)).left(4) != decoded.right(4)) {
+        return script;
+    }
+
+    quint8 version = static_cast<quint8>(decoded[0]);
+    QByteArray hash = decoded.mid(1, 20);
+    if (version == p2pkhVersion) {
+        // OP_DUP OP_HASH160 <20> OP_EQUALVERIFY OP_CHECKSIG
+        script = QByteArray::fromHex("76a914") + hash + QByteArray::fromHex("88ac");
+    } else if (version == p2shVersion) {
+        // OP_HASH160 <20> OP_EQUAL
+        script = QByteArray::fromHex("a914") + hash + QByteArray::fromHex("87");
+    }
+    return script;
+}
+
+QString UtxoNetwork::addressForKeyHash(const QByteArray &pubKeyHash) const
+{
+    if (!hrp.isEmpty()) {
+        return AddressUtils::encodeBech32(hrp, pubKeyHash);
+    }
+    return AddressUtils::encodeBase58Check(pubKeyHash, p2pkhVersion);
+}
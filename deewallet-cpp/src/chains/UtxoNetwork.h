@@ -0,0 +1,36 @@
+/**
+ * DEE WALLET - UTXO Network Parameters
+ * Address encoding, BIP44 coin type and backends for Bitcoin-family chains
+ */
+
+#ifndef UTXONETWORK_H
+#define UTXONETWORK_H
+
+#include <QString>
+#include <QByteArray>
+
+struct UtxoNetwork {
+    QString symbol;             // BTC, LTC, DOGE
+    bool testnet = false;
+    QString hrp;                // Bech32 prefix; empty = no SegWit (P2PKH receive addresses)
+    quint8 p2pkhVersion = 0x00;
+    quint8 p2shVersion = 0x05;
+    int coinType = 0;           // SLIP-44
+    QString esploraUrl;         // empty = no Esplora backend (Electrum only)
+    qint64 minRelayFeeRate = 1000;  // base units per 1000 vbytes nodes relay at
+    qint64 defaultFeeRate = 5000;   // when no estimate is available
+
+    // Known networks; aliases like "bitcoin" or "Litecoin" are accepted.
+    // Unknown symbols fall back to Bitcoin.
+    static const UtxoNetwork &forChain(const QString &chainType, bool testnet = false);
+    static bool isUtxoChain(const QString &chainType);
+
+    // Output script an address pays to (empty if it does not decode for this network)
+    QByteArray scriptPubKey(const QString &address) const;
+
+    // Address for a compressed public key hash: P2WPKH when the network has
+    // SegWit, P2PKH otherwise
+    QString addressForKeyHash(const QByteArray &pubKeyHash) const;
+};
+
+#endif // UTXONETWORK_H
@@ -0,0 +1,256 @@
+/**
+ * DEE WALLET - Address Discovery Implementation
+ */
+
+#include "AddressDiscovery.h"
+#include "WalletCore.h"
+#include "WalletStore.h"
+#include "../chains/ChainAdapterFactory.h"
+#include "../rpc/HttpTransport.h"
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QDebug>
+
+struct AddressDiscovery::Scan {
+    Scan(AddressDiscovery *owner, int maxInFlight)
+        : owner(owner)
+        , chainSymbol(owner->chainSymbol)
+        , mnemonic(owner->mnemonic)
+        , gapLimit(owner->gapLimit)
+    {
+        // Probe threads only block on the network thread; this bounds requests in flight
+        pool.setMaxThreadCount(maxInFlight);
+    }
+
+    void run();
+    int scanChain(WalletCore &wallet, int change, bool *complete);
+    QVector<AddressActivity> checkWindow(const QStringList &addresses);
+    AddressActivity checkActivity(const QString &address);
+
+    void cancel();
+    bool isCancelled() const { return cancelled.loadRelaxed() != 0; }
+
+    // Sleeps up to ms; false if the scan was cancelled before or meanwhile
+    bool sleepUnlessCancelled(int ms);
+
+    // Signals go out only while the owner is alive; detach() clears it
+    // under the same lock
+    template <typename Emit>
+    void notify(Emit emitSignal)
+    {
+        QMutexLocker locker(&mutex);
+        if (owner) {
+            emitSignal(owner);
+        }
+    }
+    void detach();
+
+    // Rounds of retries for failed or throttled checks, with linear backoff
+    static constexpr int ACTIVITY_RETRIES = 3;
+    static constexpr int RETRY_DELAY_MS = 2000;
+
+    QMutex mutex;
+    QWaitCondition wake;
+    AddressDiscovery *owner;
+
+    const QString chainSymbol;
+    const QString mnemonic;
+    const int gapLimit;
+    QThreadPool pool;
+    QAtomicInt cancelled;
+    QAtomicInt scanned;
+    QAtomicInt used;
+};
+
+AddressDiscovery::AddressDiscovery(const QString &chainSymbol, const QString &mnemonic, QObject *parent)
+    : QObject(parent)
+    , chainSymbol(chainSymbol)
+    , mnemonic(mnemonic)
+    , gapLimit(20)
+    , maxInFlight(8)
+{
+}
+
+AddressDiscovery::~AddressDiscovery()
+{
+    if (scan) {
+        scan->detach();
+    }
+}
+
+void AddressDiscovery::start()
+{
+    if (isRunning()) {
+        return;
+    }
+
+    // A fresh state per run; the worker keeps its own reference
+    scan = std::make_shared<Scan>(this, maxInFlight);
+    std::shared_ptr<Scan> state = scan;
+    task = QtConcurrent::run([state]() { state->run(); });
+}
+
+void AddressDiscovery::cancel()
+{
+    if (scan) {
+        scan->cancel();
+    }
+}
+
+bool AddressDiscovery::isRunning() const
+{
+    return task.isRunning();
+}
+
+void AddressDiscovery::Scan::cancel()
+{
+    QMutexLocker locker(&mutex);
+    cancelled.storeRelaxed(1);
+    wake.wakeAll();
+}
+
+void AddressDiscovery::Scan::detach()
+{
+    QMutexLocker locker(&mutex);
+    owner = nullptr;
+    cancelled.storeRelaxed(1);
+    wake.wakeAll();
+}
+
+bool AddressDiscovery::Scan::sleepUnlessCancelled(int ms)
+{
+    QMutexLocker locker(&mutex);
+    if (!isCancelled()) {
+        wake.wait(&mutex, ms);
+    }
+    return !isCancelled();
+}
+
+void AddressDiscovery::Scan::run()
+{
+    WalletCore wallet;
+    if (!wallet.restoreFromMnemonic(mnemonic)) {
+        qDebug() << "[AddressDiscovery] Failed to restore wallet for" << chainSymbol;
+        notify([](AddressDiscovery *discovery) { emit discovery->finished(0, 0, false); });
+        return;
+    }
+
+    bool complete = true;
+    int nextReceive = scanChain(wallet, 0, &complete);
+    int nextChange = 0;
+    if (complete && WalletCore::usesChangeAddresses(chainSymbol)) {
+        nextChange = scanChain(wallet, 1, &complete);
+    }
+
+    qDebug() << "[AddressDiscovery]" << chainSymbol << "scanned" << scanned.loadRelaxed()
+             << "addresses, used" << used.loadRelaxed() << (complete ? "" : "(incomplete)");
+    notify([=](AddressDiscovery *discovery) { emit discovery->finished(nextReceive, nextChange, complete); });
+}
+
+int AddressDiscovery::Scan::scanChain(WalletCore &wallet, int change, bool *complete)
+{
+    WalletStore *store = WalletStore::instance();
+    int nextUnused = 0;
+    int gap = 0;
+
+    // One window of gapLimit addresses at a time: derive them together, check
+    // them concurrently, then walk the results in index order
+    for (int first = 0; gap < gapLimit && !isCancelled(); first += gapLimit) {
+        QStringList window = wallet.deriveAddresses(chainSymbol, change, first, gapLimit);
+        if (window.size() != gapLimit) {
+            break;
+        }
+
+        QVector<AddressActivity> activity = checkWindow(window);
+
+        for (int i = 0; i < window.size() && gap < gapLimit; ++i) {
+            int index = first + i;
+
+            // An unanswered check is not an unused address: counting it toward
+            // the gap could end the scan early and hide funds beyond it
+            if (activity[i] == AddressActivity::Unknown) {
+                qDebug() << "[AddressDiscovery]" << chainSymbol << "stopping at" << change << index
+                         << ": activity unknown after retries";
+                *complete = false;
+                return nextUnused;
+            }
+            bool isUsed = activity[i] == AddressActivity::Used;
+
+            if (isUsed || (change == 0 && index == 0)) {
+                if (store) {
+                    store->putAddress(chainSymbol, index, window[i], change);
+                }
+                QString address = window[i];
+                notify([=](AddressDiscovery *discovery) { emit discovery->addressDiscovered(change, index, address); });
+            }
+
+            if (isUsed) {
+                used.fetchAndAddRelaxed(1);
+                nextUnused = index + 1;
+                gap = 0;
+            } else {
+                gap++;
+            }
+        }
+
+        int scannedNow = scanned.loadRelaxed();
+        int usedNow = used.loadRelaxed();
+        notify([=](AddressDiscovery *discovery) { emit discovery->progress(scannedNow, usedNow); });
+    }
+
+    if (isCancelled()) {
+        *complete = false;
+    }
+    return nextUnused;
+}
+
+QVector<AddressActivity> AddressDiscovery::Scan::checkWindow(const QStringList &addresses)
+{
+    QVector<AddressActivity> activity = QtConcurrent::blockingMapped<QVector<AddressActivity>>(
+        &pool, addresses, [this](const QString &address) { return checkActivity(address); });
+
+    // Throttled (429) or failed checks get a few more rounds, backing off
+    // so the rate limiter can refill; cancel() cuts the backoff short
+    for (int attempt = 1; attempt <= ACTIVITY_RETRIES; ++attempt) {
+        QVector<int> unknown;
+        QStringList retry;
+        for (int i = 0; i < activity.size(); ++i) {
+            if (activity[i] == AddressActivity::Unknown) {
+                unknown.append(i);
+                retry.append(addresses[i]);
+            }
+        }
+        if (unknown.isEmpty() || !sleepUnlessCancelled(RETRY_DELAY_MS * attempt)) {
+            break;
+        }
+
+        QVector<AddressActivity> again = QtConcurrent::blockingMapped<QVector<AddressActivity>>(
+            &pool, retry, [this](const QString &address) { return checkActivity(address); });
+        for (int i = 0; i < unknown.size(); ++i) {
+            activity[unknown[i]] = again[i];
+        }
+    }
+
+    return activity;
+}
+
+AddressActivity AddressDiscovery::Scan::checkActivity(const QString &address)
+{
+    if (isCancelled()) {
+        return AddressActivity::Unknown;
+    }
+
+    // Discovery yields to user-initiated and on-screen requests
+    HttpTransport::PriorityScope scanPriority(HttpTransport::Priority::Background);
+
+    std::unique_ptr<ChainAdapter> adapter = ChainAdapterFactory::create(chainSymbol);
+    AddressActivity activity = adapter ? adapter->getActivity(address) : AddressActivity::Unknown;
+
+    if (activity != AddressActivity::Unknown) {
+        scanned.fetchAndAddRelaxed(1);
+    }
+    return activity;
+}
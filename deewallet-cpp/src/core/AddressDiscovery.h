@@ -0,0 +1,58 @@
+/**
+ * DEE WALLET - Address Discovery
+ * BIP44 gap-limit scan with a bounded window of concurrent activity checks
+ */
+
+#ifndef ADDRESSDISCOVERY_H
+#define ADDRESSDISCOVERY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QFuture>
+#include <memory>
+#include "../chains/ChainAdapter.h"
+
+class AddressDiscovery : public QObject {
+    Q_OBJECT
+
+public:
+    AddressDiscovery(const QString &chainSymbol, const QString &mnemonic, QObject *parent = nullptr);
+
+    // Cancels without waiting: the scan owns its state and winds down on
+    // its own, so closing a screen never blocks the GUI thread
+    ~AddressDiscovery() override;
+
+    // Consecutive unused addresses that end a chain (BIP44 default: 20)
+    void setGapLimit(int limit) { gapLimit = limit > 0 ? limit : 1; }
+
+    // Activity checks in flight at once; applies from the next start()
+    void setMaxInFlight(int requests) { maxInFlight = requests > 0 ? requests : 1; }
+
+    // Runs on a worker thread; results arrive through the signals below
+    void start();
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    // A used address (receive index 0 is always reported)
+    void addressDiscovered(int change, int index, const QString &address);
+    void progress(int scanned, int used);
+    // First unused index on the receive and change chains. complete is false
+    // when the scan stopped at an address whose activity could not be
+    // determined; the indices are then only lower bounds.
+    void finished(int nextReceiveIndex, int nextChangeIndex, bool complete);
+
+private:
+    // Everything the worker touches; shared with it so it outlives this object
+    struct Scan;
+
+    QString chainSymbol;
+    QString mnemonic;
+    int gapLimit;
+    int maxInFlight;
+    QFuture<void> task;
+    std::shared_ptr<Scan> scan;
+};
+
+#endif // ADDRESSDISCOVERY_H
@@ -0,0 +1,238 @@
+/**
+ * DEE WALLET - Address Watcher Implementation
+ */
+
+#include "AddressWatcher.h"
+#include "BalanceCache.h"
+#include "../chains/UtxoNetwork.h"
+#include "../chains/EthereumAdapter.h"
+#include "../rpc/NetworkService.h"
+#include "../rpc/ElectrumClient.h"
+#include "../rpc/SubscriptionClient.h"
+#include "../utils/AddressValidator.h"
+#include "../utils/UInt256.h"
+#include "../utils/Amount.h"
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+
+AddressWatcher::AddressWatcher(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool AddressWatcher::canWatch(const QString &chain) const
+{
+    NetworkService *network = NetworkService::instance();
+    if (!network) {
+        return false;
+    }
+    if (UtxoNetwork::isUtxoChain(chain)) {
+        return network->electrum(chain) != nullptr;
+    }
+    return network->websocket(chain) != nullptr;
+}
+
+void AddressWatcher::watch(const QString &chain, const QStringList &addresses)
+{
+    if (!canWatch(chain)) {
+        return;
+    }
+
+    NetworkService *network = NetworkService::instance();
+    if (UtxoNetwork::isUtxoChain(chain)) {
+        watchElectrum(chain, network->electrum(chain), addresses);
+    } else {
+        watchSocket(chain, network->websocket(chain), addresses);
+    }
+}
+
+void AddressWatcher::watchElectrum(const QString &chain, ElectrumClient *client,
+                                   const QStringList &addresses)
+{
+    if (!attachedChains.contains(chain)) {
+        attach(chain, client);
+    }
+
+    const UtxoNetwork &network = UtxoNetwork::forChain(chain);
+    QHash<QString, QString> &watched = scriptHashes[chain];
+    for (const QString &address : addresses) {
+        QByteArray script = network.scriptPubKey(address);
+        if (script.isEmpty()) {
+            continue;
+        }
+
+        QString hash = ElectrumClient::scriptHash(script);
+        if (watched.contains(hash)) {
+            continue;
+        }
+        watched.insert(hash, address);
+
+        client->subscribe(hash).then(this, [this, chain, address, hash](const ElectrumResponse &response) {
+            if (response.ok()) {
+                BalanceCache::instance()->setWatched(chain, address, true);
+            } else {
+                // Retried on the next watch() call
+                scriptHashes[chain].remove(hash);
+            }
+        });
+    }
+}
+
+void AddressWatcher::watchSocket(const QString &chain, SubscriptionClient *client,
+                                 const QStringList &addresses)
+{
+    bool isEvm = AddressValidator::isEvmChain(chain);
+    if (!attachedChains.contains(chain)) {
+        attach(chain, client);
+
+        // One head feed per chain; every new block ages the cached balances
+        if (isEvm) {
+            int handle = client->subscribe("eth_subscribe", QJsonArray{"newHeads"});
+            socketFeeds[chain].insert(handle, {Feed::Heads, QString()});
+        }
+    }
+
+    QSet<QString> &watched = socketAddresses[chain];
+    for (const QString &address : addresses) {
+        if (address.isEmpty() || watched.contains(address)) {
+            continue;
+        }
+        watched.insert(address);
+
+        QHash<int, Subscription> &feeds = socketFeeds[chain];
+        if (isEvm) {
+            // Token transfers in either direction. Native transfers leave no
+            // log, so native balances follow the pushed head instead.
+            QString topic = "0x000000000000000000000000" + address.mid(2).toLower();
+            QJsonObject incoming;
+            incoming["topics"] = QJsonArray{EthereumAdapter::TRANSFER_TOPIC, QJsonValue(), topic};
+            QJsonObject outgoing;
+            outgoing["topics"] = QJsonArray{EthereumAdapter::TRANSFER_TOPIC, topic};
+
+            feeds.insert(client->subscribe("eth_subscribe", QJsonArray{"logs", incoming}),
+                         {Feed::TokenTransfer, address});
+            feeds.insert(client->subscribe("eth_subscribe", QJsonArray{"logs", outgoing}),
+                         {Feed::TokenTransfer, address});
+        } else {
+            QJsonObject commitment;
+            commitment["commitment"] = "confirmed";
+            QJsonObject accountConfig = commitment;
+            accountConfig["encoding"] = "base64";
+            QJsonObject mentions;
+            mentions["mentions"] = QJsonArray{address};
+
+            feeds.insert(client->subscribe("accountSubscribe", QJsonArray{address, accountConfig}),
+                         {Feed::Account, address});
+            feeds.insert(client->subscribe("logsSubscribe", QJsonArray{mentions, commitment}),
+                         {Feed::Logs, address});
+        }
+    }
+}
+
+void AddressWatcher::attach(const QString &chain, ElectrumClient *client)
+{
+    attachedChains.insert(chain);
+
+    // Both signals are queued over from the network thread
+    connect(client, &ElectrumClient::scriptHashStatusChanged, this,
+            [this, chain](const QString &scriptHash, const QString &) {
+        QString address = scriptHashes[chain].value(scriptHash);
+        if (!address.isEmpty()) {
+            qDebug() << "[AddressWatcher]" << chain << "activity on" << address;
+            emit addressChanged(chain, address);
+        }
+    });
+
+    connect(client, &ElectrumClient::connectionChanged, this, [this, chain](bool connected) {
+        // Without a session nothing is pushed; fall back to TTL expiry
+        BalanceCache *cache = BalanceCache::instance();
+        if (!connected) {
+            cache->clearWatched(chain);
+            return;
+        }
+        for (const QString &address : scriptHashes[chain]) {
+            cache->setWatched(chain, address, true);
+        }
+    });
+}
+
+void AddressWatcher::attach(const QString &chain, SubscriptionClient *client)
+{
+    attachedChains.insert(chain);
+
+    // All signals are queued over from the network thread
+    connect(client, &SubscriptionClient::notification, this,
+            [this, chain](int handle, const QJsonValue &result) {
+        onNotification(chain, handle, result);
+    });
+
+    connect(client, &SubscriptionClient::subscribed, this, [this, chain](int handle) {
+        // Only an account feed covers every change to the native balance
+        Subscription subscription = socketFeeds[chain].value(handle, {Feed::Heads, QString()});
+        if (subscription.feed == Feed::Account) {
+            BalanceCache::instance()->setWatched(chain, subscription.address, true);
+        }
+    });
+
+    connect(client, &SubscriptionClient::subscriptionFailed, this,
+            [this, chain](int handle, const QString &error) {
+        Subscription subscription = socketFeeds[chain].take(handle);
+        qDebug() << "[AddressWatcher]" << chain << "subscription rejected:" << error;
+
+        // Retried on the next watch() call
+        if (!subscription.address.isEmpty()) {
+            socketAddresses[chain].remove(subscription.address);
+        }
+    });
+
+    connect(client, &SubscriptionClient::connectionChanged, this, [this, chain](bool connected) {
+        if (!connected) {
+            BalanceCache::instance()->clearWatched(chain);
+            droppedChains.insert(chain);
+            return;
+        }
+
+        // Renewed subscriptions only report what happens from now on;
+        // anything that landed while we were away needs a refetch
+        if (droppedChains.remove(chain)) {
+            for (const QString &address : socketAddresses.value(chain)) {
+                emit addressChanged(chain, address);
+            }
+        }
+    });
+}
+
+void AddressWatcher::onNotification(const QString &chain, int handle, const QJsonValue &result)
+{
+    auto it = socketFeeds[chain].constFind(handle);
+    if (it == socketFeeds[chain].constEnd()) {
+        return;
+    }
+
+    QJsonObject obj = result.toObject();
+    switch (it->feed) {
+    case Feed::Heads: {
+        qint64 height = static_cast<qint64>(UInt256::fromHex(obj["number"].toString()).toUInt64());
+        if (height > 0) {
+            BalanceCache::instance()->reportHead(chain, height);
+        }
+        break;
+    }
+    case Feed::TokenTransfer:
+        // Reorged-out logs arrive again with removed = true; still a change
+        qDebug() << "[AddressWatcher]" << chain << "token transfer on" << it->address;
+        emit addressChanged(chain, it->address);
+        break;
+    case Feed::Account: {
+        quint64 lamports = obj["value"].toObject()["lamports"].toVariant().toULongLong();
+        emit balancePushed(chain, it->address, Amount(lamports, 9).toString());
+        break;
+    }
+    case Feed::Logs:
+        // Failed transactions still touch the address (fees)
+        qDebug() << "[AddressWatcher]" << chain << "activity on" << it->address;
+        emit addressChanged(chain, it->address);
+        break;
+    }
+}
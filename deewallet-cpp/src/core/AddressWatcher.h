@@ -0,0 +1,68 @@
+/**
+ * DEE WALLET - Address Watcher
+ * Push subscriptions for wallet addresses; keeps subscribed balances fresh
+ * in the cache without polling
+ */
+
+#ifndef ADDRESSWATCHER_H
+#define ADDRESSWATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QJsonValue>
+
+class ElectrumClient;
+class SubscriptionClient;
+
+class AddressWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AddressWatcher(QObject *parent = nullptr);
+
+    // Subscribe to change notifications for addresses on chains with a push
+    // backend (Electrum for UTXO chains, WebSocket for EVM chains and
+    // Solana); other chains are ignored. Already watched addresses are
+    // skipped, failed subscriptions retried.
+    void watch(const QString &chain, const QStringList &addresses);
+
+    bool canWatch(const QString &chain) const;
+
+signals:
+    // New or newly confirmed activity on a watched address
+    void addressChanged(const QString &chain, const QString &address);
+
+    // Native balance delivered with the notification itself (Solana
+    // accountSubscribe); no refetch needed
+    void balancePushed(const QString &chain, const QString &address, const QString &balance);
+
+private:
+    enum class Feed {
+        Heads,          // eth_subscribe newHeads
+        TokenTransfer,  // eth_subscribe logs, ERC-20 Transfer from/to the address
+        Account,        // Solana accountSubscribe
+        Logs            // Solana logsSubscribe mentioning the address
+    };
+
+    struct Subscription {
+        Feed feed;
+        QString address;
+    };
+
+    void watchElectrum(const QString &chain, ElectrumClient *client, const QStringList &addresses);
+    void watchSocket(const QString &chain, SubscriptionClient *client, const QStringList &addresses);
+    void attach(const QString &chain, ElectrumClient *client);
+    void attach(const QString &chain, SubscriptionClient *client);
+    void onNotification(const QString &chain, int handle, const QJsonValue &result);
+
+    QHash<QString, QHash<QString, QString>> scriptHashes;   // chain -> script hash -> address
+    QHash<QString, QHash<int, Subscription>> socketFeeds;   // chain -> handle -> subscription
+    QHash<QString, QSet<QString>> socketAddresses;          // chain -> addresses with feeds
+    QSet<QString> attachedChains;
+    QSet<QString> droppedChains;                            // lost their socket; catch up on reconnect
+};
+
+#endif // ADDRESSWATCHER_H
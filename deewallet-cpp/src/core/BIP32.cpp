@@ -3,10 +3,8 @@
  */
 
 #include "BIP32.h"
+#include "../utils/Secp256k1.h"
 #include <openssl/hmac.h>
-#include <openssl/ec.h>
-#include <openssl/obj_mac.h>
-#include <openssl/bn.h>
 #include <QRegularExpression>
 
 const char* BIP32::MASTER_SECRET = "Bitcoin seed";
@@ -103,46 +101,8 @@ QByteArray BIP32::getPublicKey(const ExtendedKey &privateKey)
         return privateKey.key;
     }
 
-    // Create EC_KEY
-    EC_KEY *eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
-        return QByteArray();
-    }
-
-    // Set private key
-    BIGNUM *priv = BN_bin2bn(
-        reinterpret_cast<const unsigned char*>(privateKey.key.constData()),
-        privateKey.key.size(),
-        nullptr
-    );
-
-    EC_KEY_set_private_key(eckey, priv);
-
-    // Compute public key
-    const EC_GROUP *group = EC_KEY_get0_group(eckey);
-    EC_POINT *pub = EC_POINT_new(group);
-    EC_POINT_mul(group, pub, priv, nullptr, nullptr, nullptr);
-    EC_KEY_set_public_key(eckey, pub);
-
-    // Serialize public key (uncompressed format for Ethereum/Tron compatibility)
-    unsigned char pubkey[65];
-    size_t len = EC_POINT_point2oct(
-        group,
-        pub,
-        POINT_CONVERSION_UNCOMPRESSED,
-        pubkey,
-        sizeof(pubkey),
-        nullptr
-    );
-
-    QByteArray result(reinterpret_cast<const char*>(pubkey), len);
-
-    // Cleanup
-    EC_POINT_free(pub);
-    BN_free(priv);
-    EC_KEY_free(eckey);
-
-    return result;
+    // Uncompressed for Ethereum/Tron compatibility
+    return Secp256k1::publicKey(privateKey.key, false);
 }
 
 QString BIP32::serializeKey(const ExtendedKey &key)
@@ -0,0 +1,234 @@
+/**
+ * DEE WALLET - Balance Cache Implementation
+ */
+
+#include "BalanceCache.h"
+#include "../rpc/NetworkService.h"
+#include "../rpc/RPCManager.h"
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <algorithm>
+
+BalanceCache *BalanceCache::currentInstance = nullptr;
+
+BalanceCache::BalanceCache(QObject *parent)
+    : QObject(parent)
+{
+    // Roughly one block time; a newer head seen by the prober expires entries sooner
+    ttls["BTC"] = 5 * 60 * 1000;
+    ttls["LTC"] = 2 * 60 * 1000;
+    ttls["DOGE"] = 60 * 1000;
+    ttls["TRX"] = 15 * 1000;
+    ttls["SOL"] = 10 * 1000;
+
+    currentInstance = this;
+}
+
+BalanceCache::~BalanceCache()
+{
+    // Pending revalidations still reference this cache
+    QThreadPool::globalInstance()->waitForDone();
+
+    if (currentInstance == this) {
+        currentInstance = nullptr;
+    }
+}
+
+BalanceCache *BalanceCache::instance()
+{
+    return currentInstance;
+}
+
+QString BalanceCache::getAndRevalidate(const QString &chain, const QString &address,
+                                       const QString &asset, const Fetcher &fetcher)
+{
+    QString balance;
+    bool fresh = false;
+    bool found = lookup(chain, address, asset, &balance, &fresh);
+
+    if (!found || !fresh) {
+        revalidate(makeKey(chain, address, asset), chain, address, asset, fetcher);
+    }
+
+    return balance;
+}
+
+bool BalanceCache::lookup(const QString &chain, const QString &address, const QString &asset,
+                          QString *balance, bool *isFresh)
+{
+    QMutexLocker locker(&mutex);
+    auto it = entries.constFind(makeKey(chain, address, asset));
+    if (it == entries.constEnd()) {
+        return false;
+    }
+
+    if (balance) {
+        *balance = it->balance;
+    }
+    if (isFresh) {
+        *isFresh = this->isFresh(*it);
+    }
+    return true;
+}
+
+void BalanceCache::store(const QString &chain, const QString &address, const QString &asset,
+                         const QString &balance)
+{
+    Entry entry;
+    entry.chain = chain;
+    entry.address = address;
+    entry.balance = balance;
+    entry.fetchedAt = QDateTime::currentMSecsSinceEpoch();
+
+    {
+        QMutexLocker locker(&mutex);
+        entry.height = currentHead(chain);
+        entries.insert(makeKey(chain, address, asset), entry);
+    }
+
+    // Write through so the next launch starts from this value
+    WalletStore *walletStore = WalletStore::instance();
+    if (walletStore && walletStore->isOpen()) {
+        walletStore->putBalance(chain, address, asset, balance);
+    }
+}
+
+void BalanceCache::preload(const QVector<WalletStore::BalanceRecord> &records)
+{
+    QMutexLocker locker(&mutex);
+    for (const WalletStore::BalanceRecord &record : records) {
+        QString key = makeKey(record.chain, record.address, record.asset);
+        if (entries.contains(key)) {
+            continue;
+        }
+
+        Entry entry;
+        entry.chain = record.chain;
+        entry.address = record.address;
+        entry.balance = record.balance;
+        entry.fetchedAt = record.updatedAt;
+        entries.insert(key, entry);
+    }
+}
+
+void BalanceCache::invalidate(const QString &chain, const QString &address)
+{
+    QMutexLocker locker(&mutex);
+    for (Entry &entry : entries) {
+        if (entry.chain == chain && (address.isEmpty() || entry.address == address)) {
+            entry.invalidated = true;
+        }
+    }
+}
+
+void BalanceCache::setTtl(const QString &chain, qint64 milliseconds)
+{
+    QMutexLocker locker(&mutex);
+    ttls[chain] = milliseconds;
+}
+
+void BalanceCache::setWatched(const QString &chain, const QString &address, bool isWatched)
+{
+    QMutexLocker locker(&mutex);
+    if (isWatched) {
+        watched.insert(chain + '|' + address);
+    } else {
+        watched.remove(chain + '|' + address);
+    }
+}
+
+void BalanceCache::clearWatched(const QString &chain)
+{
+    QMutexLocker locker(&mutex);
+    QString prefix = chain + '|';
+    for (auto it = watched.begin(); it != watched.end();) {
+        if (it->startsWith(prefix)) {
+            it = watched.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void BalanceCache::reportHead(const QString &chain, qint64 height)
+{
+    QMutexLocker locker(&mutex);
+    if (height > pushedHeads.value(chain)) {
+        pushedHeads[chain] = height;
+    }
+}
+
+QString BalanceCache::makeKey(const QString &chain, const QString &address, const QString &asset)
+{
+    return chain + '|' + address + '|' + asset;
+}
+
+bool BalanceCache::isFresh(const Entry &entry) const
+{
+    // Caller holds the mutex
+    if (entry.invalidated) {
+        return false;
+    }
+    if (watched.contains(entry.chain + '|' + entry.address)) {
+        return true;
+    }
+
+    qint64 age = QDateTime::currentMSecsSinceEpoch() - entry.fetchedAt;
+    if (age > ttlFor(entry.chain)) {
+        return false;
+    }
+
+    // A new block may have moved funds
+    qint64 head = currentHead(entry.chain);
+    return head == 0 || entry.height == 0 || head <= entry.height;
+}
+
+qint64 BalanceCache::ttlFor(const QString &chain) const
+{
+    // EVM chains share one default
+    return ttls.value(chain, 30 * 1000);
+}
+
+qint64 BalanceCache::currentHead(const QString &chain) const
+{
+    // Caller holds the mutex
+    NetworkService *network = NetworkService::instance();
+    qint64 probed = network && network->rpcManager() ? network->rpcManager()->headHeight(chain) : 0;
+    return std::max(probed, pushedHeads.value(chain));
+}
+
+void BalanceCache::revalidate(const QString &key, const QString &chain, const QString &address,
+                              const QString &asset, const Fetcher &fetcher)
+{
+    {
+        // One refetch per key at a time
+        QMutexLocker locker(&mutex);
+        if (revalidating.contains(key)) {
+            return;
+        }
+        revalidating.insert(key);
+    }
+
+    QThreadPool::globalInstance()->start([this, key, chain, address, asset, fetcher]() {
+        bool ok = false;
+        QString balance = fetcher(address, &ok);
+        if (ok) {
+            store(chain, address, asset, balance);
+        }
+
+        {
+            QMutexLocker locker(&mutex);
+            revalidating.remove(key);
+        }
+
+        // An error is not a zero balance: the last known value stays,
+        // stale, and is retried on the next read
+        if (!ok) {
+            return;
+        }
+
+        // Queued to receivers on the GUI thread
+        emit balanceUpdated(chain, address, asset, balance);
+    });
+}
@@ -0,0 +1,95 @@
+/**
+ * DEE WALLET - Balance Cache
+ * TTL and block-height aware cache for balances (stale-while-revalidate)
+ */
+
+#ifndef BALANCECACHE_H
+#define BALANCECACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <functional>
+#include "WalletStore.h"
+
+class BalanceCache : public QObject {
+    Q_OBJECT
+
+public:
+    // Produces the current balance for an address, setting ok to false when
+    // the query failed; must be safe to call on a worker thread (no widget access)
+    using Fetcher = std::function<QString(const QString &address, bool *ok)>;
+
+    static constexpr const char *NATIVE_ASSET = "native";
+
+    explicit BalanceCache(QObject *parent = nullptr);
+    ~BalanceCache() override;
+
+    // The cache created in main()
+    static BalanceCache *instance();
+
+    // Stale-while-revalidate: returns the cached value right away (empty if
+    // none). A missing or stale entry is refetched on a worker thread and
+    // balanceUpdated is emitted when it lands; a failed refetch keeps the
+    // old entry and emits nothing.
+    QString getAndRevalidate(const QString &chain, const QString &address, const QString &asset,
+                             const Fetcher &fetcher);
+
+    bool lookup(const QString &chain, const QString &address, const QString &asset,
+                QString *balance, bool *isFresh = nullptr);
+    void store(const QString &chain, const QString &address, const QString &asset,
+               const QString &balance);
+
+    // Seed from persisted balances; they are served until their TTL runs out
+    // and are never written back to the store
+    void preload(const QVector<WalletStore::BalanceRecord> &records);
+
+    // Mark entries for an address (all assets), or for a whole chain, stale:
+    // the next read still returns the last known value and refetches it
+    void invalidate(const QString &chain, const QString &address = QString());
+
+    void setTtl(const QString &chain, qint64 milliseconds);
+
+    // Addresses with a live push subscription: their entries stay fresh until
+    // invalidated by a change notification, instead of expiring on TTL
+    void setWatched(const QString &chain, const QString &address, bool watched);
+    void clearWatched(const QString &chain);
+
+    // Chain head pushed by a newHeads subscription; entries read at an older
+    // height go stale without waiting for the prober
+    void reportHead(const QString &chain, qint64 height);
+
+signals:
+    void balanceUpdated(const QString &chain, const QString &address,
+                        const QString &asset, const QString &balance);
+
+private:
+    struct Entry {
+        QString chain;
+        QString address;
+        QString balance;
+        qint64 height = 0;      // chain head when read (0 = unknown)
+        qint64 fetchedAt = 0;   // ms since epoch
+        bool invalidated = false;   // stale even if watched or within TTL
+    };
+
+    static QString makeKey(const QString &chain, const QString &address, const QString &asset);
+    bool isFresh(const Entry &entry) const;
+    qint64 ttlFor(const QString &chain) const;
+    qint64 currentHead(const QString &chain) const;
+    void revalidate(const QString &key, const QString &chain, const QString &address,
+                    const QString &asset, const Fetcher &fetcher);
+
+    mutable QMutex mutex;
+    QHash<QString, Entry> entries;
+    QSet<QString> revalidating;
+    QSet<QString> watched;          // chain|address
+    QHash<QString, qint64> ttls;
+    QHash<QString, qint64> pushedHeads;
+
+    static BalanceCache *currentInstance;
+};
+
+#endif // BALANCECACHE_H
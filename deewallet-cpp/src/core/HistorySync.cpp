@@ -0,0 +1,50 @@
+/**
+ * DEE WALLET - History Sync Implementation
+ */
+
+#include "HistorySync.h"
+#include "WalletStore.h"
+#include "../chains/ChainAdapterFactory.h"
+#include <QDebug>
+
+QVector<Transaction> HistorySync::sync(const QString &chainSymbol, const QString &address)
+{
+    WalletStore *store = WalletStore::instance();
+    // Dogecoin has no Esplora backend; its adapter returns no history
+    std::unique_ptr<ChainAdapter> adapter = ChainAdapterFactory::create(chainSymbol);
+    if (!adapter || address.isEmpty()) {
+        return cached(chainSymbol, address);
+    }
+
+    QString cursor = store && store->isOpen() ? store->cursor(chainSymbol, address) : QString();
+    QString nextCursor;
+    QVector<Transaction> fresh = adapter->getTransactionsSince(address, cursor, nextCursor);
+
+    qDebug() << "[HistorySync]" << chainSymbol << address << "fetched" << fresh.size()
+             << "new transactions, cursor" << cursor << "->" << nextCursor;
+
+    if (!store || !store->isOpen()) {
+        return fresh;
+    }
+
+    for (Transaction &tx : fresh) {
+        tx.chainType = chainSymbol;
+    }
+
+    // Transactions first, so a crash in between refetches rather than skips
+    store->putTransactions(chainSymbol, fresh);
+    if (!nextCursor.isEmpty()) {
+        store->putCursor(chainSymbol, address, nextCursor);
+    }
+
+    return store->transactions(chainSymbol, address);
+}
+
+QVector<Transaction> HistorySync::cached(const QString &chainSymbol, const QString &address)
+{
+    WalletStore *store = WalletStore::instance();
+    if (!store || !store->isOpen()) {
+        return QVector<Transaction>();
+    }
+    return store->transactions(chainSymbol, address);
+}
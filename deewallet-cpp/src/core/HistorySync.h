@@ -0,0 +1,24 @@
+/**
+ * DEE WALLET - History Sync
+ * Incremental transaction-history sync using per-address cursors
+ */
+
+#ifndef HISTORYSYNC_H
+#define HISTORYSYNC_H
+
+#include <QString>
+#include <QVector>
+#include "../chains/ChainAdapter.h"
+
+class HistorySync {
+public:
+    // Fetch transactions newer than the stored cursor, persist them, advance
+    // the cursor and return the full stored history for the address (newest
+    // first). Blocking; call from a worker thread.
+    static QVector<Transaction> sync(const QString &chainSymbol, const QString &address);
+
+    // Stored history only, no network
+    static QVector<Transaction> cached(const QString &chainSymbol, const QString &address);
+};
+
+#endif // HISTORYSYNC_H
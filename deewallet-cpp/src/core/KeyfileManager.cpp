@@ -9,6 +9,7 @@
 #include <QDebug>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
+#include <openssl/hmac.h>
 
 KeyfileManager::KeyfileManager()
 {
@@ -166,6 +167,42 @@ QJsonObject KeyfileManager::getKeyfileMetadata(const QString &filePath)
     return metadata;
 }
 
+QByteArray KeyfileManager::deriveSessionKey(const QByteArray &secret, const QByteArray &purpose)
+{
+    // HMAC-SHA256(Key = purpose, Data = secret); the secret already carries full entropy
+    QByteArray key(KEY_SIZE, 0);
+    unsigned int keyLen = KEY_SIZE;
+
+    HMAC(EVP_sha256(),
+         purpose.constData(), purpose.size(),
+         reinterpret_cast<const unsigned char*>(secret.constData()), secret.size(),
+         reinterpret_cast<unsigned char*>(key.data()), &keyLen);
+
+    return key;
+}
+
+QByteArray KeyfileManager::seal(const QByteArray &plaintext, const QByteArray &key)
+{
+    QByteArray iv;
+    QByteArray tag;
+    QByteArray ciphertext = encryptAES256GCM(plaintext, key, iv, tag);
+    if (ciphertext.isEmpty() && !plaintext.isEmpty()) {
+        return QByteArray();
+    }
+
+    return iv + tag + ciphertext;
+}
+
+QByteArray KeyfileManager::unseal(const QByteArray &sealed, const QByteArray &key)
+{
+    if (sealed.size() < IV_SIZE + TAG_SIZE) {
+        return QByteArray();
+    }
+
+    return decryptAES256GCM(sealed.mid(IV_SIZE + TAG_SIZE), key,
+                            sealed.left(IV_SIZE), sealed.mid(IV_SIZE, TAG_SIZE));
+}
+
 QByteArray KeyfileManager::deriveKey(const QString &password, const QByteArray &salt)
 {
     QByteArray key(KEY_SIZE, 0);
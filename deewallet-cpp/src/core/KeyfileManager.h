@@ -27,6 +27,12 @@ public:
     bool validateKeyfile(const QString &filePath);
     QJsonObject getKeyfileMetadata(const QString &filePath);
 
+    // Session encryption for local wallet data, keyed from the decrypted
+    // keyfile secret (no second PBKDF2 run). Sealed layout: iv | tag | ciphertext
+    QByteArray deriveSessionKey(const QByteArray &secret, const QByteArray &purpose);
+    QByteArray seal(const QByteArray &plaintext, const QByteArray &key);
+    QByteArray unseal(const QByteArray &sealed, const QByteArray &key);
+
 private:
     QByteArray deriveKey(const QString &password, const QByteArray &salt);
     QByteArray encryptAES256GCM(const QByteArray &plaintext,
@@ -0,0 +1,164 @@
+/**
+ * DEE WALLET - Portfolio Refresher Implementation
+ */
+
+#include "PortfolioRefresher.h"
+#include "BalanceCache.h"
+#include "WalletService.h"
+#include "../chains/ChainAdapterFactory.h"
+#include "../chains/UtxoNetwork.h"
+#include "../rpc/HttpTransport.h"
+#include <QtConcurrent>
+#include <QDebug>
+
+PortfolioRefresher::PortfolioRefresher(QObject *parent)
+    : QObject(parent)
+    , generation(0)
+{
+    // Workers only wait on the network thread; wide enough that one slow
+    // chain never queues another behind it
+    pool.setMaxThreadCount(32);
+
+    deadline.setSingleShot(true);
+    connect(&deadline, &QTimer::timeout, this, &PortfolioRefresher::onDeadline);
+}
+
+PortfolioRefresher::~PortfolioRefresher()
+{
+    pool.waitForDone();
+}
+
+void PortfolioRefresher::start(const QVector<Target> &targets, bool force, int deadlineMs)
+{
+    ++generation;
+    pending.clear();
+
+    QHash<QString, QStringList> toFetch;
+    QStringList chainOrder;
+
+    BalanceCache *cache = BalanceCache::instance();
+    for (const Target &target : targets) {
+        if (target.address.isEmpty()) {
+            continue;
+        }
+
+        QString balance;
+        bool fresh = false;
+        if (cache->lookup(target.chain, target.address, BalanceCache::NATIVE_ASSET, &balance, &fresh)) {
+            emit balanceReady(target.chain, target.address, balance);
+            if (fresh && !force) {
+                continue;
+            }
+        }
+
+        QString key = makeKey(target);
+        if (pending.contains(key)) {
+            continue;
+        }
+        pending.insert(key, target.chain);
+        if (!toFetch.contains(target.chain)) {
+            chainOrder.append(target.chain);
+        }
+        toFetch[target.chain].append(target.address);
+    }
+
+    for (const QString &chain : chainOrder) {
+        const QStringList &addressList = toFetch[chain];
+        if (UtxoNetwork::isUtxoChain(chain)) {
+            // One multi-address query (a single Electrum batch) per UTXO chain
+            fetchGroup(chain, addressList);
+        } else {
+            for (const QString &address : addressList) {
+                fetchGroup(chain, {address});
+            }
+        }
+    }
+
+    if (pending.isEmpty()) {
+        deadline.stop();
+        emit finished(true);
+        return;
+    }
+
+    deadline.start(deadlineMs);
+}
+
+void PortfolioRefresher::fetchGroup(const QString &chain, const QStringList &addresses)
+{
+    int current = generation;
+    QtConcurrent::run(&pool, [chain, addresses]() {
+        HttpTransport::PriorityScope visiblePriority(HttpTransport::Priority::Visible);
+        QHash<QString, QString> balances;
+        std::unique_ptr<ChainAdapter> adapter = ChainAdapterFactory::create(chain);
+        if (adapter && addresses.size() > 1) {
+            try {
+                balances = adapter->getBalances(addresses);
+            } catch (const std::exception &e) {
+                qDebug() << "[PortfolioRefresher]" << chain << "batch query failed:" << e.what();
+            }
+        }
+        // Failed addresses are left out: they stay pending, and the deadline
+        // marks their chain stale instead of reporting a zero balance
+        for (const QString &address : addresses) {
+            if (!balances.contains(address)) {
+                bool ok = false;
+                QString balance = WalletService::fetchBalance(chain, address, &ok);
+                if (!ok) {
+                    continue;
+                }
+                balances.insert(address, balance);
+            }
+            BalanceCache::instance()->store(chain, address, BalanceCache::NATIVE_ASSET,
+                                            balances[address]);
+        }
+        return balances;
+    }).then(this, [this, current, chain](const QHash<QString, QString> &balances) {
+        for (auto it = balances.constBegin(); it != balances.constEnd(); ++it) {
+            onResult(current, {chain, it.key()}, it.value());
+        }
+    });
+}
+
+bool PortfolioRefresher::isRunning() const
+{
+    return deadline.isActive();
+}
+
+void PortfolioRefresher::onResult(int resultGeneration, const Target &target, const QString &balance)
+{
+    emit balanceReady(target.chain, target.address, balance);
+
+    if (resultGeneration != generation || !deadline.isActive()) {
+        return;
+    }
+
+    pending.remove(makeKey(target));
+    if (pending.isEmpty()) {
+        deadline.stop();
+        emit finished(true);
+    }
+}
+
+void PortfolioRefresher::onDeadline()
+{
+    // Late results keep landing through balanceReady
+    QSet<QString> staleChains;
+    for (const QString &chain : pending) {
+        staleChains.insert(chain);
+    }
+
+    qDebug() << "[PortfolioRefresher] Deadline passed with" << pending.size()
+             << "queries outstanding on" << staleChains.values();
+
+    for (const QString &chain : staleChains) {
+        emit chainStale(chain);
+    }
+
+    pending.clear();
+    emit finished(false);
+}
+
+QString PortfolioRefresher::makeKey(const Target &target)
+{
+    return target.chain + '|' + target.address;
+}
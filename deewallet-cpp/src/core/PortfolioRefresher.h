@@ -0,0 +1,62 @@
+/**
+ * DEE WALLET - Portfolio Refresher
+ * Fans out balance queries for every chain and address at once under a
+ * single refresh deadline
+ */
+
+#ifndef PORTFOLIOREFRESHER_H
+#define PORTFOLIOREFRESHER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QThreadPool>
+
+class PortfolioRefresher : public QObject {
+    Q_OBJECT
+
+public:
+    struct Target {
+        QString chain;
+        QString address;
+    };
+
+    static constexpr int DEFAULT_DEADLINE_MS = 8000;
+
+    explicit PortfolioRefresher(QObject *parent = nullptr);
+    ~PortfolioRefresher() override;
+
+    // Serve cached balances right away and query every missing or stale one
+    // (all of them when force is set) concurrently. A new start supersedes
+    // the previous refresh; its late results are still delivered.
+    void start(const QVector<Target> &targets, bool force = false,
+               int deadlineMs = DEFAULT_DEADLINE_MS);
+    bool isRunning() const;
+
+signals:
+    // Emitted on the GUI thread, including for results that miss the deadline
+    void balanceReady(const QString &chain, const QString &address, const QString &balance);
+    // The deadline passed with results outstanding for this chain
+    void chainStale(const QString &chain);
+    // Every query landed (complete) or the deadline passed
+    void finished(bool complete);
+
+private:
+    // Query addresses of one chain on a worker; results land through onResult
+    void fetchGroup(const QString &chain, const QStringList &addresses);
+    void onResult(int generation, const Target &target, const QString &balance);
+    void onDeadline();
+
+    static QString makeKey(const Target &target);
+
+    QThreadPool pool;
+    QTimer deadline;
+    int generation;
+    QHash<QString, QString> pending;   // chain|address -> chain
+};
+
+#endif // PORTFOLIOREFRESHER_H
@@ -9,7 +9,9 @@
 #include "../chains/EthereumAdapter.h"
 #include "../chains/TronAdapter.h"
 #include "../chains/SolanaAdapter.h"
+#include "../utils/AddressValidator.h"
 #include <openssl/crypto.h>
+#include <QHash>
 
 class WalletCore::Impl
 {
@@ -18,6 +20,9 @@ public:
     BIP32 bip32;
     ExtendedKey masterKey;
     bool isInitialized = false;
+
+    // All EVM chains share one address per account; derive + checksum it once
+    QHash<uint32_t, QString> evmAddressCache;
 };
 
 WalletCore::WalletCore()
@@ -51,6 +56,7 @@ bool WalletCore::restoreFromMnemonic(const QString &mnemonic)
 
     // Generate master key (BIP32)
     pImpl->masterKey = pImpl->bip32.generateMasterKey(seed);
+    pImpl->evmAddressCache.clear();
     pImpl->isInitialized = true;
 
     // Securely wipe seed
@@ -65,6 +71,7 @@ void WalletCore::clear()
         // Securely wipe master key
         OPENSSL_cleanse(pImpl->masterKey.key.data(), pImpl->masterKey.key.size());
         OPENSSL_cleanse(pImpl->masterKey.chainCode.data(), pImpl->masterKey.chainCode.size());
+        pImpl->evmAddressCache.clear();
         pImpl->isInitialized = false;
     }
 }
@@ -99,41 +106,116 @@ QString WalletCore::deriveAddress(const QString &chainType, uint32_t accountInde
     // Tron:     m/44'/195'/0'/0/0
     // Solana:   m/44'/501'/0'/0/0
 
-    QString path;
+    bool isEvm = AddressValidator::isEvmChain(chainType);
+    if (isEvm) {
+        auto cached = pImpl->evmAddressCache.constFind(accountIndex);
+        if (cached != pImpl->evmAddressCache.constEnd()) {
+            return cached.value();
+        }
+    }
+
+    int coin = coinType(chainType);
+    if (coin < 0) {
+        return QString();
+    }
+
+    // All EVM chains use Ethereum's BIP44 path (m/44'/60'/0'/0/0)
+    QString path = QString("m/44'/%1'/%2'/0/0").arg(coin).arg(accountIndex);
+
+    QByteArray publicKey = derivePublicKey(path);
+    if (publicKey.isEmpty()) {
+        return QString();
+    }
+
+    QString address = addressFromPublicKey(chainType, publicKey);
+    if (isEvm && !address.isEmpty()) {
+        pImpl->evmAddressCache.insert(accountIndex, address);
+    }
+    return address;
+}
+
+QStringList WalletCore::deriveAddresses(const QString &chainType, uint32_t change,
+                                        uint32_t firstIndex, int count)
+{
+    QStringList addresses;
+    int coin = coinType(chainType);
+    if (!pImpl->isInitialized || coin < 0 || count <= 0) {
+        return addresses;
+    }
+
+    BIP32 &bip32 = pImpl->bip32;
+    ExtendedKey coinNode = bip32.derivePath(pImpl->masterKey, QString("m/44'/%1'").arg(coin));
+
+    if (usesChangeAddresses(chainType)) {
+        // m/44'/coin'/0'/change, then one non-hardened step per address
+        ExtendedKey accountNode = bip32.deriveChild(coinNode, 0, true);
+        ExtendedKey branchNode = bip32.deriveChild(accountNode, change);
+        for (int i = 0; i < count; ++i) {
+            ExtendedKey child = bip32.deriveChild(branchNode, firstIndex + i);
+            addresses.append(addressFromPublicKey(chainType, bip32.getPublicKey(child)));
+            OPENSSL_cleanse(child.key.data(), child.key.size());
+        }
+        OPENSSL_cleanse(accountNode.key.data(), accountNode.key.size());
+        OPENSSL_cleanse(branchNode.key.data(), branchNode.key.size());
+    } else if (change == 0) {
+        for (int i = 0; i < count; ++i) {
+            ExtendedKey accountNode = bip32.deriveChild(coinNode, firstIndex + i, true);
+            ExtendedKey child = bip32.deriveChild(bip32.deriveChild(accountNode, 0), 0);
+            addresses.append(addressFromPublicKey(chainType, bip32.getPublicKey(child)));
+            OPENSSL_cleanse(accountNode.key.data(), accountNode.key.size());
+            OPENSSL_cleanse(child.key.data(), child.key.size());
+        }
+    }
+
+    OPENSSL_cleanse(coinNode.key.data(), coinNode.key.size());
+    return addresses;
+}
+
+bool WalletCore::usesChangeAddresses(const QString &chainType)
+{
+    return chainType == "BTC" || chainType == "bitcoin"
+        || chainType == "LTC" || chainType == "litecoin"
+        || chainType == "DOGE" || chainType == "dogecoin";
+}
+
+QString WalletCore::derivationPath(const QString &chainType, uint32_t change, uint32_t index)
+{
+    int coin = coinType(chainType);
+    if (usesChangeAddresses(chainType)) {
+        return QString("m/44'/%1'/0'/%2/%3").arg(coin).arg(change).arg(index);
+    }
+    return QString("m/44'/%1'/%2'/0/0").arg(coin).arg(index);
+}
+
+int WalletCore::coinType(const QString &chainType)
+{
+    // SLIP-44 coin types
     if (chainType == "BTC" || chainType == "bitcoin") {
-        path = QString("m/44'/0'/%1'/0/0").arg(accountIndex);
+        return 0;
     } else if (chainType == "LTC" || chainType == "litecoin") {
-        path = QString("m/44'/2'/%1'/0/0").arg(accountIndex);
+        return 2;
     } else if (chainType == "DOGE" || chainType == "dogecoin") {
-        path = QString("m/44'/3'/%1'/0/0").arg(accountIndex);
+        return 3;
     } else if (chainType == "TRX" || chainType == "tron") {
-        path = QString("m/44'/195'/%1'/0/0").arg(accountIndex);
+        return 195;
     } else if (chainType == "SOL" || chainType == "solana") {
-        path = QString("m/44'/501'/%1'/0/0").arg(accountIndex);
-    } else if (chainType == "ETH" || chainType == "BNB" || chainType == "POL" || 
-               chainType == "ARB" || chainType == "OP" || chainType == "AVAX" ||
-               chainType == "BASE" || chainType == "FTM" || chainType == "CRO" || 
-               chainType == "xDAI") {
-        // All EVM chains use Ethereum's BIP44 path (m/44'/60'/0'/0/0)
-        path = QString("m/44'/60'/%1'/0/0").arg(accountIndex);
-    } else {
-        return QString();
+        return 501;
+    } else if (AddressValidator::isEvmChain(chainType)) {
+        return 60;
     }
+    return -1;
+}
 
-    QByteArray publicKey = derivePublicKey(path);
+QString WalletCore::addressFromPublicKey(const QString &chainType, const QByteArray &publicKey)
+{
     if (publicKey.isEmpty()) {
         return QString();
     }
 
     // Use chain adapters to convert public key to address
-    if (chainType == "BTC" || chainType == "bitcoin") {
-        BitcoinAdapter adapter("", false);
-        return adapter.deriveAddress(publicKey);
-    } else if (chainType == "LTC" || chainType == "litecoin") {
-        BitcoinAdapter adapter("", false);
-        return adapter.deriveAddress(publicKey);
-    } else if (chainType == "DOGE" || chainType == "dogecoin") {
-        BitcoinAdapter adapter("", false);
+    if (UtxoNetwork::isUtxoChain(chainType)) {
+        // Each Bitcoin-family chain encodes with its own prefix / version byte
+        BitcoinAdapter adapter("", UtxoNetwork::forChain(chainType));
         return adapter.deriveAddress(publicKey);
     } else if (chainType == "TRX" || chainType == "tron") {
         TronAdapter adapter("");
@@ -141,11 +223,8 @@ QString WalletCore::deriveAddress(const QString &chainType, uint32_t accountInde
     } else if (chainType == "SOL" || chainType == "solana") {
         SolanaAdapter adapter("");
         return adapter.deriveAddress(publicKey);
-    } else if (chainType == "ETH" || chainType == "BNB" || chainType == "POL" || 
-               chainType == "ARB" || chainType == "OP" || chainType == "AVAX" ||
-               chainType == "BASE" || chainType == "FTM" || chainType == "CRO" || 
-               chainType == "xDAI") {
-        // All EVM chains use same address derivation (Ethereum style)
+    } else if (AddressValidator::isEvmChain(chainType)) {
+        // All EVM chains use same address derivation (Ethereum style, EIP-55 checksummed)
         EthereumAdapter adapter("", EthereumAdapter::getChainId(chainType));
         return adapter.deriveAddress(publicKey);
     }
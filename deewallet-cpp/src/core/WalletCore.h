@@ -7,6 +7,7 @@
 #define WALLETCORE_H
 
 #include <QString>
+#include <QStringList>
 #include <QByteArray>
 #include <memory>
 
@@ -31,7 +32,24 @@ public:
     // Address generation
     QString deriveAddress(const QString &chainType, uint32_t accountIndex = 0);
 
+    // Consecutive wallet addresses, deriving the shared parent node once.
+    // UTXO chains: m/44'/coin'/0'/change/i (change 0 = receive, 1 = change).
+    // Account chains: one address per account, m/44'/coin'/i'/0/0 (change must be 0).
+    QStringList deriveAddresses(const QString &chainType, uint32_t change,
+                                uint32_t firstIndex, int count);
+
+    // BTC, LTC and DOGE keep separate receive and change chains
+    static bool usesChangeAddresses(const QString &chainType);
+
+    // Path of the key behind deriveAddresses(chainType, change, index, 1)
+    static QString derivationPath(const QString &chainType, uint32_t change, uint32_t index);
+
+    // SLIP-44 coin type (-1 if unknown); EVM chains share Ethereum's 60
+    static int coinType(const QString &chainType);
+
 private:
+    static QString addressFromPublicKey(const QString &chainType, const QByteArray &publicKey);
+
     class Impl;
     std::unique_ptr<Impl> pImpl;
 };
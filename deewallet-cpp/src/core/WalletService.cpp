@@ -0,0 +1,210 @@
+/**
+ * DEE WALLET - Wallet Service Implementation
+ */
+
+#include "WalletService.h"
+#include "WalletCore.h"
+#include "BalanceCache.h"
+#include "HistorySync.h"
+#include "../chains/ChainAdapterFactory.h"
+#include "../chains/UtxoNetwork.h"
+#include "../utils/CoinSelector.h"
+#include "../rpc/HttpTransport.h"
+#include <QtConcurrent>
+#include <QDebug>
+
+WalletService *WalletService::currentInstance = nullptr;
+
+WalletService::WalletService(QObject *parent)
+    : QObject(parent)
+{
+    // Sends and history syncs; balance refetches use the cache's own workers
+    pool.setMaxThreadCount(4);
+
+    if (BalanceCache::instance()) {
+        connect(BalanceCache::instance(), &BalanceCache::balanceUpdated, this,
+                [this](const QString &chain, const QString &address,
+                       const QString &asset, const QString &balance) {
+            if (asset == BalanceCache::NATIVE_ASSET) {
+                emit balanceUpdated(chain, address, balance);
+            }
+        });
+    }
+
+    connect(&watcher, &AddressWatcher::addressChanged, this,
+            [this](const QString &chain, const QString &address) {
+        refreshBalance(chain, address);
+        emit activityDetected(chain, address);
+    });
+
+    connect(&watcher, &AddressWatcher::balancePushed, this,
+            [this](const QString &chain, const QString &address, const QString &balance) {
+        BalanceCache::instance()->store(chain, address, BalanceCache::NATIVE_ASSET, balance);
+        emit balanceUpdated(chain, address, balance);
+    });
+
+    currentInstance = this;
+}
+
+WalletService::~WalletService()
+{
+    pool.waitForDone();
+
+    if (currentInstance == this) {
+        currentInstance = nullptr;
+    }
+}
+
+WalletService *WalletService::instance()
+{
+    return currentInstance;
+}
+
+QString WalletService::balance(const QString &chain, const QString &address)
+{
+    if (address.isEmpty()) {
+        return QString();
+    }
+
+    return BalanceCache::instance()->getAndRevalidate(
+        chain, address, BalanceCache::NATIVE_ASSET,
+        [chain](const QString &addr, bool *ok) { return fetchBalance(chain, addr, ok); });
+}
+
+void WalletService::refreshBalance(const QString &chain, const QString &address)
+{
+    BalanceCache::instance()->invalidate(chain, address);
+    balance(chain, address);
+}
+
+void WalletService::watch(const QString &chain, const QStringList &addresses)
+{
+    watcher.watch(chain, addresses);
+}
+
+QFuture<void> WalletService::syncHistory(const QString &chain, const QStringList &addresses)
+{
+    return QtConcurrent::run(&pool, [chain, addresses]() {
+        HttpTransport::PriorityScope syncPriority(HttpTransport::Priority::Background);
+        for (const QString &address : addresses) {
+            HistorySync::sync(chain, address);
+        }
+    });
+}
+
+QFuture<QString> WalletService::estimateFee(const QString &chain, const QString &from,
+                                            const QString &to, const QString &amount)
+{
+    return QtConcurrent::run(&pool, [chain, from, to, amount]() {
+        HttpTransport::PriorityScope feePriority(HttpTransport::Priority::UserAction);
+        try {
+            std::unique_ptr<ChainAdapter> adapter = ChainAdapterFactory::create(chain);
+            return adapter ? adapter->estimateFee(from, to, amount) : QString();
+        } catch (const std::exception &e) {
+            qDebug() << "[WalletService] ERROR: Fee estimate failed for" << chain << ":" << e.what();
+            return QString();
+        }
+    });
+}
+
+QFuture<WalletService::SendResult> WalletService::send(const SendRequest &request)
+{
+    return QtConcurrent::run(&pool, [request]() {
+        SendResult result = signAndBroadcast(request);
+        if (!result.txHash.isEmpty() && BalanceCache::instance()) {
+            // The pre-send balance is no longer valid
+            BalanceCache::instance()->invalidate(request.chain, request.from);
+        }
+        return result;
+    });
+}
+
+WalletService::SendResult WalletService::signAndBroadcast(const SendRequest &request)
+{
+    // Sending jumps ahead of any queued refresh or scan traffic
+    HttpTransport::PriorityScope sendPriority(HttpTransport::Priority::UserAction);
+
+    SendResult result;
+    result.error = sendUnsupportedReason(request.chain, request.from);
+    if (!result.error.isEmpty()) {
+        return result;
+    }
+
+    try {
+        std::unique_ptr<ChainAdapter> adapter = ChainAdapterFactory::create(request.chain);
+        if (!adapter) {
+            result.error = "Unsupported chain: " + request.chain;
+            return result;
+        }
+
+        WalletCore wallet;
+        if (!wallet.restoreFromMnemonic(request.mnemonic)) {
+            result.error = "Failed to restore wallet.";
+            return result;
+        }
+
+        // Each step returns empty on failure; nothing empty reaches the node
+        QString rawTx = adapter->createTransaction(request.from, request.to,
+                                                   request.amount, request.gasPrice);
+        if (rawTx.isEmpty()) {
+            result.error = "Could not build the transaction: insufficient funds, "
+                           "no spendable inputs or no fee quote from the network.";
+            return result;
+        }
+
+        QByteArray privateKey = wallet.derivePrivateKey(request.derivationPath);
+        QString signedTx = adapter->signTransaction(rawTx, privateKey);
+        privateKey.fill(0);
+        if (signedTx.isEmpty()) {
+            result.error = "Signing failed.";
+            return result;
+        }
+
+        result.txHash = adapter->broadcastTransaction(signedTx);
+        if (result.txHash.isEmpty()) {
+            result.error = "Broadcast was rejected by the node.";
+        }
+    } catch (const std::exception &e) {
+        result.error = QString("Transaction failed:\n%1").arg(e.what());
+    }
+
+    return result;
+}
+
+QString WalletService::sendUnsupportedReason(const QString &chain, const QString &from)
+{
+    // The UTXO signer handles SegWit v0 and Taproot key-path inputs only
+    if (!UtxoNetwork::isUtxoChain(chain)) {
+        return QString();
+    }
+    QByteArray script = UtxoNetwork::forChain(chain).scriptPubKey(from);
+    if (!script.isEmpty() && CoinSelector::inputVSize(script) == 0) {
+        return QString("Sending from legacy %1 addresses is not supported: only SegWit "
+                       "and Taproot inputs can be signed.").arg(chain);
+    }
+    return QString();
+}
+
+QString WalletService::fetchBalance(const QString &chain, const QString &address, bool *ok)
+{
+    QString balance;
+
+    try {
+        std::unique_ptr<ChainAdapter> adapter = ChainAdapterFactory::create(chain);
+        if (!adapter) {
+            qDebug() << "[WalletService] WARNING: Unknown chain symbol" << chain;
+        } else {
+            balance = adapter->getBalance(address);
+        }
+    } catch (const std::exception &e) {
+        qDebug() << "[WalletService] ERROR: Balance query failed for" << address << ":" << e.what();
+        balance.clear();
+    } catch (...) {
+        balance.clear();
+    }
+
+    if (ok) {
+        *ok = !balance.isEmpty();
+    }
+    return balance;
+}
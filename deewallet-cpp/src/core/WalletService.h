@@ -0,0 +1,89 @@
+/**
+ * DEE WALLET - Wallet Service
+ * Worker-thread front for balance, history and broadcast network calls;
+ * screens subscribe to its signals and futures instead of blocking
+ */
+
+#ifndef WALLETSERVICE_H
+#define WALLETSERVICE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QFuture>
+#include <QThreadPool>
+#include "AddressWatcher.h"
+
+class WalletService : public QObject {
+    Q_OBJECT
+
+public:
+    struct SendRequest {
+        QString chain;
+        QString mnemonic;
+        QString derivationPath;  // signing key, e.g. m/44'/60'/0'/0/0
+        QString from;
+        QString to;
+        QString amount;
+        QString gasPrice;        // empty = adapter default
+    };
+
+    struct SendResult {
+        QString txHash;          // empty on failure
+        QString error;
+    };
+
+    explicit WalletService(QObject *parent = nullptr);
+    ~WalletService() override;
+
+    // The service created in main()
+    static WalletService *instance();
+
+    // Native balance: cached value right away (empty if none). Missing or
+    // stale values are refetched on a worker thread and arrive through
+    // balanceUpdated.
+    QString balance(const QString &chain, const QString &address);
+
+    // Mark the cached value stale and refetch in the background; balance()
+    // keeps returning the last known value until the new one arrives
+    void refreshBalance(const QString &chain, const QString &address);
+
+    // Push updates for these addresses where the chain supports it; a
+    // change refetches the balance and emits activityDetected
+    void watch(const QString &chain, const QStringList &addresses);
+
+    // Incremental history sync at background priority; read the result with
+    // HistorySync::cached once the future finishes
+    QFuture<void> syncHistory(const QString &chain, const QStringList &addresses);
+
+    // Fee the adapter would pay for this send, at user-action priority; an
+    // empty amount gives the fee of sending the whole balance. Empty when
+    // it could not be estimated.
+    QFuture<QString> estimateFee(const QString &chain, const QString &from,
+                                 const QString &to, const QString &amount);
+
+    // Restore, sign and broadcast at user-action priority
+    QFuture<SendResult> send(const SendRequest &request);
+
+    // Why sends from this address cannot be signed (e.g. a legacy P2PKH
+    // Dogecoin address); empty when they can
+    static QString sendUnsupportedReason(const QString &chain, const QString &from);
+
+    // Blocking adapter query; for worker threads only. Empty, with ok set
+    // to false, when the query failed.
+    static QString fetchBalance(const QString &chain, const QString &address, bool *ok = nullptr);
+
+signals:
+    void balanceUpdated(const QString &chain, const QString &address, const QString &balance);
+    void activityDetected(const QString &chain, const QString &address);
+
+private:
+    static SendResult signAndBroadcast(const SendRequest &request);
+
+    QThreadPool pool;
+    AddressWatcher watcher;
+
+    static WalletService *currentInstance;
+};
+
+#endif // WALLETSERVICE_H
@@ -0,0 +1,592 @@
+/**
+ * DEE WALLET - Wallet Store Implementation
+ */
+
+#include "WalletStore.h"
+#include "../utils/AddressValidator.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QDebug>
+#include <openssl/crypto.h>
+#include <algorithm>
+
+WalletStore *WalletStore::currentInstance = nullptr;
+
+// Record framing: 4-byte little-endian length, then the sealed JSON record
+static QByteArray encodeLength(quint32 length)
+{
+    QByteArray bytes(4, 0);
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+    return bytes;
+}
+
+static quint32 decodeLength(const char *data)
+{
+    quint32 length = 0;
+    for (int i = 0; i < 4; i++) {
+        length |= static_cast<quint32>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return length;
+}
+
+WalletStore::WalletStore(QObject *parent)
+    : QObject(parent)
+    , recordCount(0)
+{
+    currentInstance = this;
+}
+
+WalletStore::~WalletStore()
+{
+    close();
+
+    if (currentInstance == this) {
+        currentInstance = nullptr;
+    }
+}
+
+WalletStore *WalletStore::instance()
+{
+    return currentInstance;
+}
+
+bool WalletStore::open(const QString &mnemonic)
+{
+    close();
+
+    QMutexLocker locker(&mutex);
+
+    QByteArray secret = mnemonic.toUtf8();
+    key = crypto.deriveSessionKey(secret, "DEE WALLET store key");
+    QByteArray storeId = crypto.deriveSessionKey(secret, "DEE WALLET store id").left(8).toHex();
+    OPENSSL_cleanse(secret.data(), secret.size());
+
+    // Kept next to the executable, like addressbook.json
+    QString dirPath = QCoreApplication::applicationDirPath() + "/wallets";
+    QDir().mkpath(dirPath);
+    file.setFileName(dirPath + "/" + QString::fromLatin1(storeId) + ".store");
+
+    if (file.exists() && !replay()) {
+        qDebug() << "[WalletStore] Unreadable store, starting fresh:" << file.fileName();
+        file.remove();
+    }
+
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qDebug() << "[WalletStore] Failed to open" << file.fileName();
+        OPENSSL_cleanse(key.data(), key.size());
+        key.clear();
+        return false;
+    }
+
+    if (file.size() == 0) {
+        file.write(QByteArray(FILE_MAGIC) + QByteArray(1, FILE_VERSION));
+        file.flush();
+        recordCount = 0;
+    }
+
+    compactIfNeeded();
+
+    qDebug() << "[WalletStore] Opened" << file.fileName() << "with" << recordCount << "records";
+    return true;
+}
+
+void WalletStore::close()
+{
+    QMutexLocker locker(&mutex);
+
+    if (file.isOpen()) {
+        file.close();
+    }
+    if (!key.isEmpty()) {
+        OPENSSL_cleanse(key.data(), key.size());
+        key.clear();
+    }
+
+    recordCount = 0;
+    addressesByChain.clear();
+    balanceRecords.clear();
+    tokensByAddress.clear();
+    txByChain.clear();
+    historyCursors.clear();
+}
+
+bool WalletStore::isOpen() const
+{
+    QMutexLocker locker(&mutex);
+    return file.isOpen();
+}
+
+void WalletStore::putAddress(const QString &chain, int index, const QString &address, int change)
+{
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen() || addressesByChain.value(branchKey(chain, change)).value(index) == address) {
+        return;
+    }
+
+    QJsonObject record;
+    record["k"] = "a";
+    record["chain"] = chain;
+    record["index"] = index;
+    record["address"] = address;
+    if (change != 0) {
+        record["change"] = change;
+    }
+    append(record);
+}
+
+void WalletStore::putBalance(const QString &chain, const QString &address, const QString &asset,
+                             const QString &balance)
+{
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return;
+    }
+
+    // Timestamps only matter for display; skip rewriting an unchanged balance
+    auto it = balanceRecords.constFind(balanceKey(chain, address, asset));
+    if (it != balanceRecords.constEnd() && it->balance == balance) {
+        return;
+    }
+
+    QJsonObject record;
+    record["k"] = "b";
+    record["chain"] = chain;
+    record["address"] = address;
+    record["asset"] = asset;
+    record["balance"] = balance;
+    record["ts"] = QDateTime::currentMSecsSinceEpoch();
+    append(record);
+}
+
+void WalletStore::putTokens(const QString &chain, const QString &address, const QVector<Token> &tokens)
+{
+    QJsonArray tokenArray;
+    for (const Token &token : tokens) {
+        tokenArray.append(tokenToJson(token));
+    }
+
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return;
+    }
+
+    QJsonArray existing;
+    for (const Token &token : tokensByAddress.value(chain + '|' + address)) {
+        existing.append(tokenToJson(token));
+    }
+    if (existing == tokenArray && tokensByAddress.contains(chain + '|' + address)) {
+        return;
+    }
+
+    QJsonObject record;
+    record["k"] = "k";
+    record["chain"] = chain;
+    record["address"] = address;
+    record["tokens"] = tokenArray;
+    append(record);
+}
+
+void WalletStore::putTransactions(const QString &chain, const QVector<Transaction> &transactions)
+{
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return;
+    }
+
+    // Only new or changed (e.g. pending -> confirmed) transactions are logged
+    const QMap<QString, Transaction> known = txByChain.value(chain);
+    QJsonArray changed;
+    for (const Transaction &tx : transactions) {
+        QJsonObject txJson = transactionToJson(tx);
+        auto it = known.constFind(transactionKey(tx));
+        if (it == known.constEnd() || transactionToJson(*it) != txJson) {
+            changed.append(txJson);
+        }
+    }
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    QJsonObject record;
+    record["k"] = "t";
+    record["chain"] = chain;
+    record["txs"] = changed;
+    append(record);
+}
+
+void WalletStore::putCursor(const QString &chain, const QString &address, const QString &cursor)
+{
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen() || historyCursors.value(chain + '|' + address) == cursor) {
+        return;
+    }
+
+    QJsonObject record;
+    record["k"] = "c";
+    record["chain"] = chain;
+    record["address"] = address;
+    record["cursor"] = cursor;
+    append(record);
+}
+
+QString WalletStore::address(const QString &chain, int index, int change) const
+{
+    QMutexLocker locker(&mutex);
+    return addressesByChain.value(branchKey(chain, change)).value(index);
+}
+
+QMap<int, QString> WalletStore::addresses(const QString &chain, int change) const
+{
+    QMutexLocker locker(&mutex);
+    return addressesByChain.value(branchKey(chain, change));
+}
+
+QVector<WalletStore::BalanceRecord> WalletStore::balances() const
+{
+    QMutexLocker locker(&mutex);
+    return balanceRecords.values();
+}
+
+QVector<Token> WalletStore::tokens(const QString &chain, const QString &address) const
+{
+    QMutexLocker locker(&mutex);
+    return tokensByAddress.value(chain + '|' + address);
+}
+
+QVector<Transaction> WalletStore::transactions(const QString &chain, const QString &address) const
+{
+    QVector<Transaction> result;
+    {
+        QMutexLocker locker(&mutex);
+        for (const Transaction &tx : txByChain.value(chain)) {
+            if (address.isEmpty() || tx.from == address || tx.to == address) {
+                result.append(tx);
+            }
+        }
+    }
+
+    // Newest first
+    std::sort(result.begin(), result.end(), [](const Transaction &a, const Transaction &b) {
+        return a.timestamp > b.timestamp;
+    });
+    return result;
+}
+
+QString WalletStore::cursor(const QString &chain, const QString &address) const
+{
+    QMutexLocker locker(&mutex);
+    return historyCursors.value(chain + '|' + address);
+}
+
+bool WalletStore::compact()
+{
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    return rewrite();
+}
+
+bool WalletStore::rewrite()
+{
+    // Caller holds the mutex
+    QVector<QJsonObject> records = snapshot();
+
+    QSaveFile output(file.fileName());
+    if (!output.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    output.write(QByteArray(FILE_MAGIC) + QByteArray(1, FILE_VERSION));
+    for (const QJsonObject &record : records) {
+        QByteArray sealed = crypto.seal(QJsonDocument(record).toJson(QJsonDocument::Compact), key);
+        output.write(encodeLength(static_cast<quint32>(sealed.size())));
+        output.write(sealed);
+    }
+
+    // Atomic replace; the old log stays intact if anything above failed
+    file.close();
+    bool committed = output.commit();
+    if (committed) {
+        recordCount = records.size();
+    }
+
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qDebug() << "[WalletStore] Failed to reopen after compaction";
+        return false;
+    }
+    return committed;
+}
+
+bool WalletStore::replay()
+{
+    // Caller holds the mutex
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    QByteArray header = QByteArray(FILE_MAGIC) + QByteArray(1, FILE_VERSION);
+    if (!data.startsWith(header)) {
+        return false;
+    }
+
+    int offset = header.size();
+    int validEnd = offset;
+    recordCount = 0;
+
+    while (offset + 4 <= data.size()) {
+        quint32 length = decodeLength(data.constData() + offset);
+        if (length > MAX_RECORD_SIZE || offset + 4 + static_cast<qint64>(length) > data.size()) {
+            break;
+        }
+
+        QByteArray plaintext = crypto.unseal(data.mid(offset + 4, static_cast<int>(length)), key);
+        QJsonDocument doc = QJsonDocument::fromJson(plaintext);
+        if (!doc.isObject()) {
+            break;
+        }
+
+        apply(doc.object());
+        recordCount++;
+        offset += 4 + static_cast<int>(length);
+        validEnd = offset;
+    }
+
+    // A torn write from a crash leaves a partial record at the tail; drop it
+    if (validEnd < data.size()) {
+        qDebug() << "[WalletStore] Truncating" << (data.size() - validEnd) << "trailing bytes";
+        file.resize(validEnd);
+    }
+
+    return true;
+}
+
+bool WalletStore::append(const QJsonObject &record)
+{
+    // Caller holds the mutex
+    QByteArray sealed = crypto.seal(QJsonDocument(record).toJson(QJsonDocument::Compact), key);
+    if (sealed.isEmpty()) {
+        return false;
+    }
+
+    // Length and payload in one write so a crash tears at most the last record
+    QByteArray framed = encodeLength(static_cast<quint32>(sealed.size())) + sealed;
+    if (file.write(framed) != framed.size()) {
+        return false;
+    }
+    file.flush();
+
+    apply(record);
+    recordCount++;
+    compactIfNeeded();
+    return true;
+}
+
+void WalletStore::apply(const QJsonObject &record)
+{
+    QString kind = record["k"].toString();
+    QString chain = record["chain"].toString();
+
+    if (kind == "a") {
+        // LTC/DOGE addresses from before they had their own network
+        // parameters were bc1 addresses; drop them so they are re-derived
+        QString address = record["address"].toString();
+        if (!AddressValidator::validate(chain, address)) {
+            return;
+        }
+        addressesByChain[branchKey(chain, record["change"].toInt())]
+            .insert(record["index"].toInt(), address);
+    } else if (kind == "b") {
+        BalanceRecord balance;
+        balance.chain = chain;
+        balance.address = record["address"].toString();
+        balance.asset = record["asset"].toString();
+        balance.balance = record["balance"].toString();
+        balance.updatedAt = static_cast<qint64>(record["ts"].toDouble());
+        balanceRecords.insert(balanceKey(chain, balance.address, balance.asset), balance);
+    } else if (kind == "k") {
+        QVector<Token> tokenList;
+        for (const QJsonValue &value : record["tokens"].toArray()) {
+            tokenList.append(tokenFromJson(value.toObject()));
+        }
+        tokensByAddress.insert(chain + '|' + record["address"].toString(), tokenList);
+    } else if (kind == "t") {
+        QMap<QString, Transaction> &chainTxs = txByChain[chain];
+        for (const QJsonValue &value : record["txs"].toArray()) {
+            Transaction tx = transactionFromJson(value.toObject());
+            chainTxs.insert(transactionKey(tx), tx);
+        }
+    } else if (kind == "c") {
+        historyCursors.insert(chain + '|' + record["address"].toString(), record["cursor"].toString());
+    }
+}
+
+QVector<QJsonObject> WalletStore::snapshot() const
+{
+    // Caller holds the mutex
+    QVector<QJsonObject> records;
+
+    for (auto chainIt = addressesByChain.constBegin(); chainIt != addressesByChain.constEnd(); ++chainIt) {
+        int separator = chainIt.key().indexOf('|');
+        int change = chainIt.key().mid(separator + 1).toInt();
+        for (auto it = chainIt->constBegin(); it != chainIt->constEnd(); ++it) {
+            QJsonObject record;
+            record["k"] = "a";
+            record["chain"] = chainIt.key().left(separator);
+            record["index"] = it.key();
+            record["address"] = it.value();
+            if (change != 0) {
+                record["change"] = change;
+            }
+            records.append(record);
+        }
+    }
+
+    for (const BalanceRecord &balance : balanceRecords) {
+        QJsonObject record;
+        record["k"] = "b";
+        record["chain"] = balance.chain;
+        record["address"] = balance.address;
+        record["asset"] = balance.asset;
+        record["balance"] = balance.balance;
+        record["ts"] = balance.updatedAt;
+        records.append(record);
+    }
+
+    for (auto it = tokensByAddress.constBegin(); it != tokensByAddress.constEnd(); ++it) {
+        QJsonArray tokenArray;
+        for (const Token &token : it.value()) {
+            tokenArray.append(tokenToJson(token));
+        }
+
+        int separator = it.key().indexOf('|');
+        QJsonObject record;
+        record["k"] = "k";
+        record["chain"] = it.key().left(separator);
+        record["address"] = it.key().mid(separator + 1);
+        record["tokens"] = tokenArray;
+        records.append(record);
+    }
+
+    for (auto it = txByChain.constBegin(); it != txByChain.constEnd(); ++it) {
+        QJsonArray txArray;
+        for (const Transaction &tx : it.value()) {
+            txArray.append(transactionToJson(tx));
+        }
+
+        QJsonObject record;
+        record["k"] = "t";
+        record["chain"] = it.key();
+        record["txs"] = txArray;
+        records.append(record);
+    }
+
+    for (auto it = historyCursors.constBegin(); it != historyCursors.constEnd(); ++it) {
+        int separator = it.key().indexOf('|');
+        QJsonObject record;
+        record["k"] = "c";
+        record["chain"] = it.key().left(separator);
+        record["address"] = it.key().mid(separator + 1);
+        record["cursor"] = it.value();
+        records.append(record);
+    }
+
+    return records;
+}
+
+int WalletStore::liveCount() const
+{
+    int count = balanceRecords.size() + tokensByAddress.size() + txByChain.size()
+              + historyCursors.size();
+    for (const auto &chainAddresses : addressesByChain) {
+        count += chainAddresses.size();
+    }
+    return count;
+}
+
+void WalletStore::compactIfNeeded()
+{
+    // Caller holds the mutex. Rewrite once superseded records dominate the log.
+    if (recordCount > 2 * liveCount() + 64) {
+        rewrite();
+    }
+}
+
+QString WalletStore::branchKey(const QString &chain, int change)
+{
+    return chain + '|' + QString::number(change);
+}
+
+QString WalletStore::balanceKey(const QString &chain, const QString &address, const QString &asset)
+{
+    return chain + '|' + address + '|' + asset;
+}
+
+QJsonObject WalletStore::tokenToJson(const Token &token)
+{
+    QJsonObject obj;
+    obj["symbol"] = token.symbol;
+    obj["name"] = token.name;
+    obj["contract"] = token.contractAddress;
+    obj["balance"] = token.balance;
+    obj["decimals"] = token.decimals;
+    return obj;
+}
+
+Token WalletStore::tokenFromJson(const QJsonObject &obj)
+{
+    Token token;
+    token.symbol = obj["symbol"].toString();
+    token.name = obj["name"].toString();
+    token.contractAddress = obj["contract"].toString();
+    token.balance = obj["balance"].toString();
+    token.decimals = obj["decimals"].toInt();
+    return token;
+}
+
+QString WalletStore::transactionKey(const Transaction &tx)
+{
+    return tx.logIndex < 0 ? tx.hash : tx.hash + ':' + QString::number(tx.logIndex);
+}
+
+QJsonObject WalletStore::transactionToJson(const Transaction &tx)
+{
+    QJsonObject obj;
+    obj["hash"] = tx.hash;
+    obj["from"] = tx.from;
+    obj["to"] = tx.to;
+    obj["value"] = tx.value;
+    obj["chainType"] = tx.chainType;
+    obj["timestamp"] = tx.timestamp;
+    obj["status"] = tx.status;
+    obj["fee"] = tx.fee;
+    if (tx.logIndex >= 0) {
+        obj["logIndex"] = tx.logIndex;
+    }
+    return obj;
+}
+
+Transaction WalletStore::transactionFromJson(const QJsonObject &obj)
+{
+    Transaction tx;
+    tx.hash = obj["hash"].toString();
+    tx.from = obj["from"].toString();
+    tx.to = obj["to"].toString();
+    tx.value = obj["value"].toString();
+    tx.chainType = obj["chainType"].toString();
+    tx.timestamp = static_cast<qint64>(obj["timestamp"].toDouble());
+    tx.status = obj["status"].toString();
+    tx.fee = obj["fee"].toString();
+    tx.logIndex = obj["logIndex"].toInt(-1);
+    return tx;
+}
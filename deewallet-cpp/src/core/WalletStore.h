@@ -0,0 +1,106 @@
+/**
+ * DEE WALLET - Wallet Store
+ * Encrypted append-only on-disk store for derived addresses, last-known
+ * balances, token holdings and transaction history
+ */
+
+#ifndef WALLETSTORE_H
+#define WALLETSTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QVector>
+#include <QFile>
+#include <QMutex>
+#include <QJsonObject>
+#include "KeyfileManager.h"
+#include "../chains/ChainAdapter.h"
+
+class WalletStore : public QObject {
+    Q_OBJECT
+
+public:
+    struct BalanceRecord {
+        QString chain;
+        QString address;
+        QString asset;
+        QString balance;
+        qint64 updatedAt = 0;   // ms since epoch
+    };
+
+    explicit WalletStore(QObject *parent = nullptr);
+    ~WalletStore() override;
+
+    // The store created in main()
+    static WalletStore *instance();
+
+    // Open (or create) the store for a wallet. The file name and encryption
+    // key are both derived from the mnemonic; the log is replayed into memory.
+    bool open(const QString &mnemonic);
+    void close();
+    bool isOpen() const;
+
+    // Writes are appended to the log; unchanged values are not rewritten
+    // change 1 = BIP44 change chain (UTXO chains only)
+    void putAddress(const QString &chain, int index, const QString &address, int change = 0);
+    void putBalance(const QString &chain, const QString &address, const QString &asset,
+                    const QString &balance);
+    void putTokens(const QString &chain, const QString &address, const QVector<Token> &tokens);
+    void putTransactions(const QString &chain, const QVector<Transaction> &transactions);
+    void putCursor(const QString &chain, const QString &address, const QString &cursor);
+
+    // Reads are served from memory
+    QString address(const QString &chain, int index, int change = 0) const;
+    QMap<int, QString> addresses(const QString &chain, int change = 0) const;
+    QVector<BalanceRecord> balances() const;
+    QVector<Token> tokens(const QString &chain, const QString &address) const;
+    QVector<Transaction> transactions(const QString &chain, const QString &address = QString()) const;
+    QString cursor(const QString &chain, const QString &address) const;
+
+    // Identity of a history entry: the hash, plus the log index for a token
+    // transfer, since one transaction can emit several
+    static QString transactionKey(const Transaction &tx);
+
+    // Rewrite the log as one record per live value
+    bool compact();
+
+private:
+    bool replay();
+    bool append(const QJsonObject &record);
+    void apply(const QJsonObject &record);
+    QVector<QJsonObject> snapshot() const;
+    int liveCount() const;
+    bool rewrite();
+    void compactIfNeeded();
+
+    static QString branchKey(const QString &chain, int change);
+    static QString balanceKey(const QString &chain, const QString &address, const QString &asset);
+    static QJsonObject tokenToJson(const Token &token);
+    static Token tokenFromJson(const QJsonObject &obj);
+    static QJsonObject transactionToJson(const Transaction &tx);
+    static Transaction transactionFromJson(const QJsonObject &obj);
+
+    static constexpr const char *FILE_MAGIC = "DEESTORE";
+    static constexpr char FILE_VERSION = 1;
+    static constexpr quint32 MAX_RECORD_SIZE = 16 * 1024 * 1024;
+
+    mutable QMutex mutex;
+    KeyfileManager crypto;
+    QByteArray key;
+    QFile file;
+    int recordCount;
+
+    QHash<QString, QMap<int, QString>> addressesByChain;      // chain|change -> index
+    QHash<QString, BalanceRecord> balanceRecords;
+    QHash<QString, QVector<Token>> tokensByAddress;            // chain|address
+    QHash<QString, QMap<QString, Transaction>> txByChain;      // chain -> transactionKey -> tx
+    QHash<QString, QString> historyCursors;                    // chain|address
+
+    static WalletStore *currentInstance;
+};
+
+#endif // WALLETSTORE_H
@@ -6,6 +6,10 @@
 #include <QApplication>
 #include <QDir>
 #include "ui/MainWindow.h"
+#include "rpc/NetworkService.h"
+#include "core/WalletStore.h"
+#include "core/BalanceCache.h"
+#include "core/WalletService.h"
 
 int main(int argc, char *argv[])
 {
@@ -16,6 +20,12 @@ int main(int argc, char *argv[])
     QApplication::setApplicationVersion("1.0.0");
     QApplication::setOrganizationName("DEEWALLET Team");
 
+    // Shared network stack (one persistent transport for every adapter)
+    NetworkService networkService;
+    WalletStore walletStore;
+    BalanceCache balanceCache;
+    WalletService walletService;
+
     // Create main window
     MainWindow mainWindow;
     mainWindow.setWindowTitle("DEE WALLET");
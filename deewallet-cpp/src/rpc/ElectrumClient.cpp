@@ -0,0 +1,370 @@
+/**
+ * DEE WALLET - Electrum Client Implementation
+ */
+
+#include "ElectrumClient.h"
+#include <QSslSocket>
+#include <QTimer>
+#include <QPromise>
+#include <QMetaObject>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCryptographicHash>
+#include <QSet>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
+
+ElectrumClient::ElectrumClient(const QString &chainType, const QVector<ElectrumServer> &servers,
+                               QObject *parent)
+    : QObject(parent)
+    , chain(chainType)
+    , servers(servers)
+    , serverIndex(0)
+    , timeoutMs(15000)
+    , socket(nullptr)
+    , keepAlive(nullptr)
+    , reconnectTimer(nullptr)
+    , reconnectDelayMs(RECONNECT_MIN_MS)
+    , ready(false)
+    , nextId(1)
+{
+}
+
+ElectrumClient::~ElectrumClient()
+{
+    failAll("Electrum client destroyed");
+}
+
+QFuture<ElectrumResponse> ElectrumClient::call(const QString &method, const QJsonArray &params)
+{
+    return batch({{method, params}}).then([](const QVector<ElectrumResponse> &responses) {
+        return responses.value(0);
+    });
+}
+
+QFuture<QVector<ElectrumResponse>> ElectrumClient::batch(const QVector<ElectrumCall> &calls)
+{
+    auto pending = std::make_shared<PendingBatch>();
+    pending->promise = std::make_shared<QPromise<QVector<ElectrumResponse>>>();
+    pending->promise->start();
+    QFuture<QVector<ElectrumResponse>> future = pending->promise->future();
+
+    if (calls.isEmpty() || servers.isEmpty()) {
+        ElectrumResponse failed;
+        failed.error = "No Electrum server configured for " + chain;
+        pending->promise->addResult(QVector<ElectrumResponse>(calls.size(), failed));
+        pending->promise->finish();
+        return future;
+    }
+
+    // The socket is not thread-safe; always hop onto the client's thread
+    QMetaObject::invokeMethod(this, [this, pending, calls]() {
+        send(pending, calls);
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+QFuture<ElectrumResponse> ElectrumClient::subscribe(const QString &scriptHash)
+{
+    // Recorded on the client's thread once the server confirms
+    return call("blockchain.scripthash.subscribe", QJsonArray{scriptHash})
+        .then(this, [this, scriptHash](const ElectrumResponse &response) {
+            if (response.ok()) {
+                subscriptions.insert(scriptHash, response.result.toString());
+            }
+            return response;
+        });
+}
+
+QString ElectrumClient::scriptHash(const QByteArray &scriptPubKey)
+{
+    QByteArray hash = QCryptographicHash::hash(scriptPubKey, QCryptographicHash::Sha256);
+    std::reverse(hash.begin(), hash.end());
+    return QString::fromLatin1(hash.toHex());
+}
+
+void ElectrumClient::send(std::shared_ptr<PendingBatch> pending, const QVector<ElectrumCall> &calls)
+{
+    pending->results.resize(calls.size());
+    pending->remaining = calls.size();
+
+    QJsonArray requests;
+    for (const ElectrumCall &electrumCall : calls) {
+        int id = nextId++;
+        pending->ids.append(id);
+        inFlight.insert(id, pending);
+
+        QJsonObject request;
+        request["jsonrpc"] = "2.0";
+        request["id"] = id;
+        request["method"] = electrumCall.method;
+        request["params"] = electrumCall.params;
+        requests.append(request);
+    }
+
+    // Batches go out as one JSON array; a lone call as a plain object
+    QByteArray line = requests.size() == 1
+        ? QJsonDocument(requests.at(0).toObject()).toJson(QJsonDocument::Compact)
+        : QJsonDocument(requests).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    if (ready) {
+        socket->write(line);
+    } else {
+        outbox.append(line);
+        ensureConnected();
+    }
+
+    QTimer::singleShot(timeoutMs, this, [this, pending]() {
+        expire(pending);
+    });
+}
+
+void ElectrumClient::ensureConnected()
+{
+    // Created lazily so they live on the client's thread
+    if (!socket) {
+        socket = new QSslSocket(this);
+        connect(socket, &QSslSocket::connected, this, [this]() {
+            if (!servers[serverIndex].ssl) {
+                onConnected();
+            }
+        });
+        connect(socket, &QSslSocket::encrypted, this, &ElectrumClient::onConnected);
+        connect(socket, &QSslSocket::readyRead, this, &ElectrumClient::onReadyRead);
+        connect(socket, &QSslSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+            if (state == QAbstractSocket::UnconnectedState) {
+                onDisconnected();
+            }
+        });
+
+        keepAlive = new QTimer(this);
+        connect(keepAlive, &QTimer::timeout, this, [this]() {
+            // Servers drop idle sessions; the response is ignored
+            if (ready) {
+                QJsonObject ping;
+                ping["jsonrpc"] = "2.0";
+                ping["id"] = nextId++;
+                ping["method"] = "server.ping";
+                socket->write(QJsonDocument(ping).toJson(QJsonDocument::Compact) + '\n');
+            }
+        });
+
+        reconnectTimer = new QTimer(this);
+        reconnectTimer->setSingleShot(true);
+        connect(reconnectTimer, &QTimer::timeout, this, &ElectrumClient::ensureConnected);
+    }
+
+    if (socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+
+    const ElectrumServer &server = servers[serverIndex];
+    if (server.ssl) {
+        socket->connectToHostEncrypted(server.host, server.port);
+    } else {
+        socket->connectToHost(server.host, server.port);
+    }
+}
+
+void ElectrumClient::onConnected()
+{
+    ready = true;
+
+    // Protocol negotiation comes first; its response is ignored
+    QJsonObject version;
+    version["jsonrpc"] = "2.0";
+    version["id"] = nextId++;
+    version["method"] = "server.version";
+    version["params"] = QJsonArray{CLIENT_NAME, PROTOCOL_VERSION};
+    socket->write(QJsonDocument(version).toJson(QJsonDocument::Compact) + '\n');
+
+    for (const QByteArray &line : outbox) {
+        socket->write(line);
+    }
+    outbox.clear();
+
+    keepAlive->start(KEEPALIVE_MS);
+    reconnectDelayMs = RECONNECT_MIN_MS;
+    emit connectionChanged(true);
+
+    resubscribe();
+}
+
+void ElectrumClient::onReadyRead()
+{
+    readBuffer.append(socket->readAll());
+
+    // Newline-delimited JSON
+    int newline;
+    while ((newline = readBuffer.indexOf('\n')) >= 0) {
+        QByteArray line = readBuffer.left(newline).trimmed();
+        readBuffer.remove(0, newline + 1);
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        handleMessage(doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object()));
+    }
+}
+
+void ElectrumClient::onDisconnected()
+{
+    bool wasReady = ready;
+    ready = false;
+    readBuffer.clear();
+    if (keepAlive) {
+        keepAlive->stop();
+    }
+
+    qDebug() << "[ElectrumClient]" << chain << "disconnected from"
+             << servers[serverIndex].host << (socket ? socket->errorString() : QString());
+
+    failAll(wasReady ? "Electrum connection closed" : "Electrum connection failed");
+    if (wasReady) {
+        emit connectionChanged(false);
+    }
+
+    // Next attempt goes to the next server
+    serverIndex = (serverIndex + 1) % servers.size();
+    scheduleReconnect();
+}
+
+void ElectrumClient::scheduleReconnect()
+{
+    // Only subscriptions need a live connection between calls
+    if (subscriptions.isEmpty() || reconnectTimer->isActive()) {
+        return;
+    }
+
+    reconnectTimer->start(reconnectDelayMs);
+    reconnectDelayMs = qMin(reconnectDelayMs * 2, RECONNECT_MAX_MS);
+}
+
+void ElectrumClient::resubscribe()
+{
+    if (subscriptions.isEmpty()) {
+        return;
+    }
+
+    // A new session has no subscriptions; anything that changed while we
+    // were away shows up as a different status
+    QStringList hashes = subscriptions.keys();
+    QVector<ElectrumCall> calls;
+    for (const QString &hash : hashes) {
+        calls.append({"blockchain.scripthash.subscribe", QJsonArray{hash}});
+    }
+
+    batch(calls).then(this, [this, hashes](const QVector<ElectrumResponse> &responses) {
+        for (int i = 0; i < hashes.size() && i < responses.size(); ++i) {
+            if (!responses[i].ok()) {
+                continue;
+            }
+            QString status = responses[i].result.toString();
+            if (subscriptions.value(hashes[i]) != status) {
+                subscriptions.insert(hashes[i], status);
+                emit scriptHashStatusChanged(hashes[i], status);
+            }
+        }
+    });
+}
+
+void ElectrumClient::handleMessage(const QJsonValue &message)
+{
+    if (message.isArray()) {
+        for (const QJsonValue &item : message.toArray()) {
+            handleMessage(item);
+        }
+        return;
+    }
+
+    QJsonObject obj = message.toObject();
+    if (!obj.contains("id") || obj["id"].isNull()) {
+        // Server-initiated notification: [script hash, new status]
+        QJsonArray params = obj["params"].toArray();
+        if (obj["method"].toString() == "blockchain.scripthash.subscribe" && params.size() >= 2) {
+            QString hash = params.at(0).toString();
+            QString status = params.at(1).toString();
+            if (subscriptions.contains(hash) && subscriptions.value(hash) != status) {
+                subscriptions.insert(hash, status);
+                emit scriptHashStatusChanged(hash, status);
+            }
+        }
+        return;
+    }
+
+    ElectrumResponse response;
+    response.result = obj["result"];
+    QJsonValue error = obj["error"];
+    if (error.isObject()) {
+        response.error = error.toObject()["message"].toString("Electrum error");
+    } else if (error.isString()) {
+        response.error = error.toString();
+    }
+
+    resolve(obj["id"].toInt(), response);
+}
+
+void ElectrumClient::resolve(int id, const ElectrumResponse &response)
+{
+    std::shared_ptr<PendingBatch> pending = inFlight.take(id);
+    if (!pending) {
+        return;
+    }
+
+    int index = pending->ids.indexOf(id);
+    pending->results[index] = response;
+    if (--pending->remaining == 0) {
+        finishBatch(pending);
+    }
+}
+
+void ElectrumClient::finishBatch(std::shared_ptr<PendingBatch> pending)
+{
+    pending->remaining = 0;
+    pending->promise->addResult(pending->results);
+    pending->promise->finish();
+}
+
+void ElectrumClient::failAll(const QString &error)
+{
+    QHash<int, std::shared_ptr<PendingBatch>> failed;
+    failed.swap(inFlight);
+    outbox.clear();
+
+    for (auto it = failed.constBegin(); it != failed.constEnd(); ++it) {
+        const std::shared_ptr<PendingBatch> &pending = it.value();
+        pending->results[pending->ids.indexOf(it.key())].error = error;
+    }
+
+    // A batch spans several ids; finish each once
+    QSet<PendingBatch *> done;
+    for (const std::shared_ptr<PendingBatch> &pending : failed) {
+        if (!done.contains(pending.get())) {
+            done.insert(pending.get());
+            finishBatch(pending);
+        }
+    }
+}
+
+void ElectrumClient::expire(std::shared_ptr<PendingBatch> pending)
+{
+    if (pending->remaining == 0) {
+        return;
+    }
+
+    for (int i = 0; i < pending->ids.size(); ++i) {
+        if (inFlight.remove(pending->ids[i])) {
+            pending->results[i].error = "Electrum request timed out";
+        }
+    }
+    finishBatch(pending);
+
+    // A silent server is usually a dead session; reconnect on the next call
+    if (socket && inFlight.isEmpty()) {
+        socket->abort();
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * DEE WALLET - Electrum Client
+ * Electrum-protocol JSON-RPC over one persistent TCP/TLS connection per chain
+ */
+
+#ifndef ELECTRUMCLIENT_H
+#define ELECTRUMCLIENT_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QFuture>
+#include <memory>
+
+class QSslSocket;
+class QTimer;
+template<typename T> class QPromise;
+
+struct ElectrumServer {
+    QString host;
+    quint16 port = 0;
+    bool ssl = true;
+};
+
+struct ElectrumCall {
+    QString method;
+    QJsonArray params;
+};
+
+struct ElectrumResponse {
+    QJsonValue result;
+    QString error;
+
+    bool ok() const { return error.isEmpty(); }
+};
+
+class ElectrumClient : public QObject {
+    Q_OBJECT
+
+public:
+    ElectrumClient(const QString &chainType, const QVector<ElectrumServer> &servers,
+                   QObject *parent = nullptr);
+    ~ElectrumClient() override;
+
+    // Thread-safe: calls are queued onto the client's thread and written as
+    // one JSON-RPC batch line; the connection is opened on first use and
+    // kept alive between calls
+    QFuture<ElectrumResponse> call(const QString &method, const QJsonArray &params = QJsonArray());
+    QFuture<QVector<ElectrumResponse>> batch(const QVector<ElectrumCall> &calls);
+
+    // Push notifications for a script hash. The current status arrives in the
+    // future; later changes through scriptHashStatusChanged. Subscriptions
+    // are renewed on reconnect, and while any exist a dropped connection is
+    // re-established with backoff.
+    QFuture<ElectrumResponse> subscribe(const QString &scriptHash);
+
+    QString chainType() const { return chain; }
+    bool hasServers() const { return !servers.isEmpty(); }
+
+    void setTimeout(int milliseconds) { timeoutMs = milliseconds; }
+
+    // Electrum script hash: reversed SHA256 of the output script, hex
+    static QString scriptHash(const QByteArray &scriptPubKey);
+
+signals:
+    // Emitted on the client's thread; status is the hash of the script's history
+    void scriptHashStatusChanged(const QString &scriptHash, const QString &status);
+    void connectionChanged(bool connected);
+
+private:
+    struct PendingBatch {
+        std::shared_ptr<QPromise<QVector<ElectrumResponse>>> promise;
+        QVector<ElectrumResponse> results;
+        QVector<int> ids;
+        int remaining = 0;
+    };
+
+    void send(std::shared_ptr<PendingBatch> pending, const QVector<ElectrumCall> &calls);
+    void ensureConnected();
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+    void handleMessage(const QJsonValue &message);
+    void resolve(int id, const ElectrumResponse &response);
+    void finishBatch(std::shared_ptr<PendingBatch> pending);
+    void failAll(const QString &error);
+    void expire(std::shared_ptr<PendingBatch> pending);
+    void resubscribe();
+    void scheduleReconnect();
+
+    static constexpr const char *CLIENT_NAME = "DEE WALLET";
+    static constexpr const char *PROTOCOL_VERSION = "1.4";
+    static constexpr int KEEPALIVE_MS = 60 * 1000;
+    static constexpr int RECONNECT_MIN_MS = 1000;
+    static constexpr int RECONNECT_MAX_MS = 60 * 1000;
+
+    QString chain;
+    QVector<ElectrumServer> servers;
+    int serverIndex;
+    int timeoutMs;
+
+    // Touched only on the client's thread
+    QSslSocket *socket;
+    QTimer *keepAlive;
+    QTimer *reconnectTimer;
+    int reconnectDelayMs;
+    bool ready;
+    int nextId;
+    QByteArray readBuffer;
+    QVector<QByteArray> outbox;     // lines written once the session is up
+    QHash<int, std::shared_ptr<PendingBatch>> inFlight;
+    QHash<QString, QString> subscriptions;  // script hash -> last status
+};
+
+#endif // ELECTRUMCLIENT_H
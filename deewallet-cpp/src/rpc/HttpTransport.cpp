@@ -0,0 +1,234 @@
+/**
+ * DEE WALLET - HTTP Transport Implementation
+ */
+
+#include "HttpTransport.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPromise>
+#include <QTimer>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QCryptographicHash>
+#include <algorithm>
+#include <cmath>
+
+// Default priority for requests issued by this thread (see PriorityScope)
+static thread_local HttpTransport::Priority threadPriority = HttpTransport::Priority::Visible;
+
+HttpTransport::PriorityScope::PriorityScope(Priority priority)
+    : previous(threadPriority)
+{
+    threadPriority = priority;
+}
+
+HttpTransport::PriorityScope::~PriorityScope()
+{
+    threadPriority = previous;
+}
+
+HttpTransport::HttpTransport(QObject *parent)
+    : QObject(parent)
+    , manager(nullptr)
+    , drainTimer(new QTimer(this))
+    , timeoutMs(15000)
+{
+    drainTimer->setSingleShot(true);
+    connect(drainTimer, &QTimer::timeout, this, &HttpTransport::drainQueues);
+}
+
+HttpTransport::~HttpTransport()
+{
+}
+
+HttpTransport::Priority HttpTransport::currentPriority()
+{
+    return threadPriority;
+}
+
+QFuture<HttpResponse> HttpTransport::get(const QUrl &url)
+{
+    return enqueue(Operation::Get, url, QByteArray(), QByteArray(), currentPriority());
+}
+
+QFuture<HttpResponse> HttpTransport::get(const QUrl &url, Priority priority)
+{
+    return enqueue(Operation::Get, url, QByteArray(), QByteArray(), priority);
+}
+
+QFuture<HttpResponse> HttpTransport::post(const QUrl &url,
+                                          const QByteArray &body,
+                                          const QByteArray &contentType)
+{
+    return enqueue(Operation::Post, url, body, contentType, currentPriority());
+}
+
+QFuture<HttpResponse> HttpTransport::post(const QUrl &url,
+                                          const QByteArray &body,
+                                          Priority priority,
+                                          const QByteArray &contentType)
+{
+    return enqueue(Operation::Post, url, body, contentType, priority);
+}
+
+void HttpTransport::setRateLimit(const QUrl &url, int requestsPerSecond)
+{
+    QMutexLocker locker(&rateLimitMutex);
+    rateLimits[url.host()] = requestsPerSecond;
+}
+
+QFuture<HttpResponse> HttpTransport::enqueue(Operation operation,
+                                             const QUrl &url,
+                                             const QByteArray &body,
+                                             const QByteArray &contentType,
+                                             Priority priority)
+{
+    auto promise = std::make_shared<QPromise<HttpResponse>>();
+    promise->start();
+    QFuture<HttpResponse> future = promise->future();
+
+    auto pending = std::make_shared<PendingRequest>();
+    pending->operation = operation;
+    pending->body = body;
+    pending->priority = priority;
+    pending->waiters.append(promise);
+
+    pending->request = QNetworkRequest(url);
+    if (!contentType.isEmpty()) {
+        pending->request.setHeader(QNetworkRequest::ContentTypeHeader, contentType);
+    }
+    // One pooled connection per host: keep-alive for HTTP/1.1, multiplexed streams for HTTP/2
+    pending->request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    pending->request.setTransferTimeout(timeoutMs);
+
+    // Identical queued requests (same verb, URL and body) are sent once
+    QCryptographicHash keyHash(QCryptographicHash::Sha256);
+    keyHash.addData(operation == Operation::Get ? QByteArray("GET ") : QByteArray("POST "));
+    keyHash.addData(url.toEncoded());
+    keyHash.addData(body);
+    pending->key = keyHash.result();
+
+    // QNetworkAccessManager is not thread-safe; always hop onto the transport thread
+    QMetaObject::invokeMethod(this, [this, pending]() {
+        schedule(pending);
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+void HttpTransport::schedule(std::shared_ptr<PendingRequest> pending)
+{
+    QString host = pending->request.url().host();
+    bool isNewHost = !hosts.contains(host);
+    HostQueue &queue = hosts[host];
+
+    {
+        QMutexLocker locker(&rateLimitMutex);
+        queue.rate = rateLimits.value(host, 0);
+    }
+    if (isNewHost) {
+        queue.tokens = queue.rate;
+        queue.refillClock.start();
+    }
+
+    auto existing = queue.queuedByKey.value(pending->key);
+    if (existing && !existing->dispatched) {
+        existing->waiters += pending->waiters;
+
+        // Promote the shared entry if the newcomer is more urgent; the stale
+        // copy in the lower queue is skipped once dispatched
+        if (pending->priority < existing->priority) {
+            existing->priority = pending->priority;
+            queue.queues[static_cast<int>(pending->priority)].enqueue(existing);
+        }
+    } else {
+        queue.queuedByKey.insert(pending->key, pending);
+        queue.queues[static_cast<int>(pending->priority)].enqueue(pending);
+    }
+
+    drainQueues();
+}
+
+void HttpTransport::drainQueues()
+{
+    qint64 nextWakeMs = -1;
+
+    for (auto it = hosts.begin(); it != hosts.end(); ++it) {
+        HostQueue &queue = it.value();
+
+        // Refill; capacity is one second of traffic
+        if (queue.rate > 0.0) {
+            double elapsed = queue.refillClock.restart() / 1000.0;
+            queue.tokens = std::min(queue.rate, queue.tokens + elapsed * queue.rate);
+        }
+
+        for (int level = 0; level < 3; ++level) {
+            QQueue<std::shared_ptr<PendingRequest>> &pendingQueue = queue.queues[level];
+            while (!pendingQueue.isEmpty()) {
+                if (pendingQueue.head()->dispatched) {
+                    pendingQueue.dequeue();
+                    continue;
+                }
+                if (queue.rate > 0.0 && queue.tokens < 1.0) {
+                    break;
+                }
+
+                std::shared_ptr<PendingRequest> pending = pendingQueue.dequeue();
+                pending->dispatched = true;
+                queue.queuedByKey.remove(pending->key);
+                if (queue.rate > 0.0) {
+                    queue.tokens -= 1.0;
+                }
+                startRequest(pending);
+            }
+        }
+
+        // Still waiting on tokens: wake when the next one is available
+        bool hasPending = !queue.queuedByKey.isEmpty();
+        if (hasPending && queue.rate > 0.0) {
+            qint64 waitMs = static_cast<qint64>(std::ceil((1.0 - queue.tokens) * 1000.0 / queue.rate));
+            waitMs = std::max<qint64>(waitMs, 1);
+            nextWakeMs = nextWakeMs < 0 ? waitMs : std::min(nextWakeMs, waitMs);
+        }
+    }
+
+    if (nextWakeMs >= 0 && (!drainTimer->isActive() || drainTimer->remainingTime() > nextWakeMs)) {
+        drainTimer->start(static_cast<int>(nextWakeMs));
+    }
+}
+
+void HttpTransport::startRequest(std::shared_ptr<PendingRequest> pending)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QNetworkReply *reply = pending->operation == Operation::Get
+        ? networkManager()->get(pending->request)
+        : networkManager()->post(pending->request, pending->body);
+
+    connect(reply, &QNetworkReply::finished, this, [reply, pending, timer]() {
+        HttpResponse response;
+        response.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        response.http2 = reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool();
+        response.body = reply->readAll();
+        response.elapsedMs = timer.elapsed();
+        if (reply->error() != QNetworkReply::NoError) {
+            response.error = reply->errorString();
+        }
+
+        for (const auto &promise : pending->waiters) {
+            promise->addResult(response);
+            promise->finish();
+        }
+        reply->deleteLater();
+    });
+}
+
+QNetworkAccessManager *HttpTransport::networkManager()
+{
+    // Created lazily so it lives on the transport thread
+    if (!manager) {
+        manager = new QNetworkAccessManager(this);
+    }
+    return manager;
+}
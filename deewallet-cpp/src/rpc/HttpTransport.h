@@ -0,0 +1,146 @@
+/**
+ * DEE WALLET - HTTP Transport
+ * Long-lived, thread-safe HTTP client shared by all chain adapters
+ */
+
+#ifndef HTTPTRANSPORT_H
+#define HTTPTRANSPORT_H
+
+#include <QObject>
+#include <QUrl>
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QQueue>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QCoreApplication>
+#include <QThread>
+#include <QNetworkRequest>
+#include <memory>
+
+class QNetworkAccessManager;
+class QTimer;
+template<typename T> class QPromise;
+
+struct HttpResponse {
+    int statusCode = 0;
+    QByteArray body;
+    QString error;
+    qint64 elapsedMs = 0;
+    bool http2 = false;
+
+    bool ok() const { return error.isEmpty() && statusCode >= 200 && statusCode < 300; }
+};
+
+class HttpTransport : public QObject {
+    Q_OBJECT
+
+public:
+    // Scheduling classes; a higher class always leaves the queue first
+    enum class Priority {
+        UserAction = 0,     // send, fee estimate
+        Visible = 1,        // balances currently on screen
+        Background = 2      // address discovery, history sync
+    };
+
+    // Sets the default priority for requests issued by the current thread
+    // while in scope, e.g. around a background address scan
+    class PriorityScope {
+    public:
+        explicit PriorityScope(Priority priority);
+        ~PriorityScope();
+
+    private:
+        Priority previous;
+    };
+
+    explicit HttpTransport(QObject *parent = nullptr);
+    ~HttpTransport() override;
+
+    // Thread-safe: requests are queued onto the transport thread, which owns
+    // one QNetworkAccessManager (keep-alive connection pool, HTTP/2 per host)
+    QFuture<HttpResponse> get(const QUrl &url);
+    QFuture<HttpResponse> get(const QUrl &url, Priority priority);
+    QFuture<HttpResponse> post(const QUrl &url,
+                               const QByteArray &body,
+                               const QByteArray &contentType = "application/json");
+    QFuture<HttpResponse> post(const QUrl &url,
+                               const QByteArray &body,
+                               Priority priority,
+                               const QByteArray &contentType = "application/json");
+
+    void setTimeout(int milliseconds) { timeoutMs = milliseconds; }
+
+    // Token bucket per host: at most requestsPerSecond dispatched, bursts up
+    // to one second's worth. Hosts without a limit are not throttled.
+    void setRateLimit(const QUrl &url, int requestsPerSecond);
+
+    static Priority currentPriority();
+
+    // Block until the future resolves; for worker threads only. GUI code
+    // chains on the future with .then(context, ...) instead.
+    template<typename T>
+    static T waitFor(const QFuture<T> &future);
+
+private:
+    enum class Operation {
+        Get,
+        Post
+    };
+
+    // A queued request; identical queued requests share one entry
+    struct PendingRequest {
+        Operation operation;
+        QNetworkRequest request;
+        QByteArray body;
+        QByteArray key;
+        Priority priority;
+        bool dispatched = false;
+        QVector<std::shared_ptr<QPromise<HttpResponse>>> waiters;
+    };
+
+    struct HostQueue {
+        double rate = 0.0;          // tokens per second, 0 = unlimited
+        double tokens = 0.0;
+        QElapsedTimer refillClock;
+        QQueue<std::shared_ptr<PendingRequest>> queues[3];
+        QHash<QByteArray, std::shared_ptr<PendingRequest>> queuedByKey;
+    };
+
+    QFuture<HttpResponse> enqueue(Operation operation,
+                                  const QUrl &url,
+                                  const QByteArray &body,
+                                  const QByteArray &contentType,
+                                  Priority priority);
+    void schedule(std::shared_ptr<PendingRequest> pending);
+    void drainQueues();
+    void startRequest(std::shared_ptr<PendingRequest> pending);
+    QNetworkAccessManager *networkManager();
+
+    QNetworkAccessManager *manager;
+    QTimer *drainTimer;
+    int timeoutMs;
+
+    // Touched only on the transport thread, except rateLimits (mutex)
+    QHash<QString, HostQueue> hosts;
+    QMutex rateLimitMutex;
+    QHash<QString, int> rateLimits;
+};
+
+template<typename T>
+T HttpTransport::waitFor(const QFuture<T> &future)
+{
+    if (!future.isFinished()) {
+        QCoreApplication *app = QCoreApplication::instance();
+        Q_ASSERT_X(!app || QThread::currentThread() != app->thread(), "HttpTransport::waitFor",
+                   "blocking network wait on the GUI thread");
+        QFuture<T> pending = future;
+        pending.waitForFinished();
+    }
+
+    return future.resultCount() > 0 ? future.result() : T();
+}
+
+#endif // HTTPTRANSPORT_H
@@ -0,0 +1,116 @@
+/**
+ * DEE WALLET - Network Service Implementation
+ */
+
+#include "NetworkService.h"
+#include "HttpTransport.h"
+#include "RPCManager.h"
+#include "ElectrumClient.h"
+#include "SubscriptionClient.h"
+#include <QThread>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+NetworkService *NetworkService::currentInstance = nullptr;
+
+NetworkService::NetworkService()
+    : networkThread(new QThread())
+    , httpTransport(new HttpTransport())
+    , router(nullptr)
+{
+    router = new RPCManager(httpTransport);
+    router->loadEndpoints(":/rpc/endpoints.json");
+    loadElectrumServers(":/rpc/endpoints.json");
+    loadWebSocketServers(":/rpc/endpoints.json");
+
+    // All socket work happens on one dedicated thread; the objects are
+    // destroyed there too once its event loop has finished
+    networkThread->setObjectName("NetworkThread");
+    httpTransport->moveToThread(networkThread);
+    router->moveToThread(networkThread);
+    QObject::connect(networkThread, &QThread::finished, router, &QObject::deleteLater);
+    QObject::connect(networkThread, &QThread::finished, httpTransport, &QObject::deleteLater);
+    for (ElectrumClient *client : electrumClients) {
+        client->moveToThread(networkThread);
+        QObject::connect(networkThread, &QThread::finished, client, &QObject::deleteLater);
+    }
+    for (SubscriptionClient *client : subscriptionClients) {
+        client->moveToThread(networkThread);
+        QObject::connect(networkThread, &QThread::finished, client, &QObject::deleteLater);
+    }
+    networkThread->start();
+
+    router->startHealthCheck();
+
+    currentInstance = this;
+}
+
+NetworkService::~NetworkService()
+{
+    if (currentInstance == this) {
+        currentInstance = nullptr;
+    }
+
+    router->stopHealthCheck();
+    networkThread->quit();
+    networkThread->wait();
+
+    delete networkThread;
+}
+
+NetworkService *NetworkService::instance()
+{
+    return currentInstance;
+}
+
+void NetworkService::loadElectrumServers(const QString &configPath)
+{
+    QFile file(configPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonObject electrum = QJsonDocument::fromJson(file.readAll()).object()["electrum"].toObject();
+    for (const QString &chain : electrum.keys()) {
+        QVector<ElectrumServer> servers;
+        for (const QJsonValue &value : electrum[chain].toArray()) {
+            QJsonObject obj = value.toObject();
+            ElectrumServer server;
+            server.host = obj["host"].toString();
+            server.port = static_cast<quint16>(obj["port"].toInt());
+            server.ssl = obj["ssl"].toBool(true);
+            servers.append(server);
+        }
+
+        // Connections open on first use
+        if (!servers.isEmpty()) {
+            electrumClients.insert(chain, new ElectrumClient(chain, servers));
+        }
+    }
+}
+
+void NetworkService::loadWebSocketServers(const QString &configPath)
+{
+    QFile file(configPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonObject websocket = QJsonDocument::fromJson(file.readAll()).object()["websocket"].toObject();
+    for (const QString &chain : websocket.keys()) {
+        QStringList urls;
+        for (const QJsonValue &value : websocket[chain].toArray()) {
+            QString url = value.toObject()["url"].toString();
+            if (!url.isEmpty()) {
+                urls.append(url);
+            }
+        }
+
+        // Sockets open with the first subscription
+        if (!urls.isEmpty()) {
+            subscriptionClients.insert(chain, new SubscriptionClient(chain, urls));
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * DEE WALLET - Network Service
+ * Application-level owner of the shared network stack
+ */
+
+#ifndef NETWORKSERVICE_H
+#define NETWORKSERVICE_H
+
+#include <QHash>
+#include <QString>
+
+class QThread;
+class HttpTransport;
+class RPCManager;
+class ElectrumClient;
+class SubscriptionClient;
+
+class NetworkService {
+public:
+    NetworkService();
+    ~NetworkService();
+
+    // Disable copy
+    NetworkService(const NetworkService&) = delete;
+    NetworkService& operator=(const NetworkService&) = delete;
+
+    // The service created in main(); adapters reach the transport through it
+    static NetworkService *instance();
+
+    HttpTransport *transport() const { return httpTransport; }
+
+    // Endpoint health prober and latency-aware router
+    RPCManager *rpcManager() const { return router; }
+
+    // Persistent Electrum session for a UTXO chain (nullptr if none configured)
+    ElectrumClient *electrum(const QString &chainType) const { return electrumClients.value(chainType); }
+
+    // Persistent WebSocket pub/sub for an EVM chain or Solana (nullptr if none configured)
+    SubscriptionClient *websocket(const QString &chainType) const { return subscriptionClients.value(chainType); }
+
+private:
+    void loadElectrumServers(const QString &configPath);
+    void loadWebSocketServers(const QString &configPath);
+
+    QThread *networkThread;
+    HttpTransport *httpTransport;
+    RPCManager *router;
+    QHash<QString, ElectrumClient *> electrumClients;
+    QHash<QString, SubscriptionClient *> subscriptionClients;
+
+    static NetworkService *currentInstance;
+};
+
+#endif // NETWORKSERVICE_H
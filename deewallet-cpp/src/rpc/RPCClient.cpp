@@ -3,86 +3,216 @@
  */
 
 #include "RPCClient.h"
-#include <QNetworkRequest>
-#include <QNetworkReply>
+#include "HttpTransport.h"
+#include "NetworkService.h"
+#include "RPCManager.h"
+#include "SingleFlight.h"
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QEventLoop>
+#include <QJsonArray>
+#include <QHash>
+#include <QPromise>
+#include <QUrl>
 
 RPCClient::RPCClient(const QString &endpoint, QObject *parent)
     : QObject(parent)
-    , networkManager(new QNetworkAccessManager(this))
     , endpoint(endpoint)
     , requestId(1)
+    , maxBatchSize(50)
 {
 }
 
+void RPCClient::setChainRoute(const QString &chainType)
+{
+    RPCManager *router = NetworkService::instance()->rpcManager();
+    chainRoute = router && router->hasChain(chainType) ? chainType : QString();
+}
+
 QJsonValue RPCClient::call(const QString &method, const QJsonValue &params)
 {
-    QJsonObject request;
-    request["jsonrpc"] = "2.0";
-    request["id"] = requestId++;
-    request["method"] = method;
-    request["params"] = params;
+    return HttpTransport::waitFor(request(method, params));
+}
+
+void RPCClient::callAsync(const QString &method,
+                          const QJsonValue &params,
+                          std::function<void(const QJsonValue&)> callback)
+{
+    QByteArray data = encodeRequest(method, params);
+    QFuture<HttpResponse> reply = postPayload(data, isIdempotent(method));
+
+    reply.then(this, [this, callback](const HttpResponse &response) {
+        if (response.ok()) {
+            QJsonDocument responseDoc = QJsonDocument::fromJson(response.body);
+            if (responseDoc.isObject()) {
+                QJsonObject responseObj = responseDoc.object();
+                if (responseObj.contains("error")) {
+                    emit requestFailed(responseObj["error"].toObject()["message"].toString());
+                    return;
+                }
+                QJsonValue result = responseObj["result"];
+                callback(result);
+                emit requestCompleted(result);
+            }
+        } else {
+            emit requestFailed(response.error);
+        }
+    });
+}
 
-    QNetworkRequest netRequest(endpoint);
-    netRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+QFuture<QJsonValue> RPCClient::request(const QString &method, const QJsonValue &params)
+{
+    // Identical (endpoint, method, params) calls already in flight share one
+    // response; the table is process-wide because adapters build short-lived clients
+    static SingleFlight<QJsonValue> inFlightCalls;
 
-    QJsonDocument doc(request);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+    QByteArray key = (chainRoute.isEmpty() ? endpoint : "route:" + chainRoute).toUtf8();
+    key += '\n' + method.toUtf8() + '\n';
+    key += QJsonDocument(QJsonArray{params}).toJson(QJsonDocument::Compact);
 
-    // Synchronous request
-    QNetworkReply *reply = networkManager->post(netRequest, data);
+    return inFlightCalls.run(key, [this, &method, &params]() {
+        QByteArray data = encodeRequest(method, params);
+        QFuture<HttpResponse> reply = postPayload(data, isIdempotent(method));
 
-    QEventLoop loop;
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+        return reply.then([](const HttpResponse &response) {
+            QJsonValue result;
+            if (response.ok()) {
+                QJsonDocument responseDoc = QJsonDocument::fromJson(response.body);
+                if (responseDoc.isObject()) {
+                    QJsonObject responseObj = responseDoc.object();
+                    result = responseObj["result"];
+                }
+            }
+            return result;
+        });
+    });
+}
 
-    QJsonValue result;
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument responseDoc = QJsonDocument::fromJson(response);
-        if (responseDoc.isObject()) {
-            QJsonObject responseObj = responseDoc.object();
-            result = responseObj["result"];
+QFuture<RPCResponse> RPCClient::requestResponse(const QString &method, const QJsonValue &params)
+{
+    QByteArray data = encodeRequest(method, params);
+    QFuture<HttpResponse> reply = postPayload(data, isIdempotent(method));
+
+    return reply.then([](const HttpResponse &response) {
+        RPCResponse result;
+        QJsonObject responseObj = QJsonDocument::fromJson(response.body).object();
+        if (responseObj.contains("error")) {
+            // Nodes often pair a JSON-RPC error with a 4xx/5xx status
+            result.delivered = true;
+            result.error = responseObj["error"].toObject()["message"].toString();
+            if (result.error.isEmpty()) {
+                result.error = "JSON-RPC error";
+            }
+        } else if (response.ok() && responseObj.contains("result")) {
+            result.delivered = true;
+            result.result = responseObj["result"];
+        } else {
+            result.error = !response.error.isEmpty() ? response.error
+                                                     : "HTTP " + QString::number(response.statusCode);
         }
+        return result;
+    });
+}
+
+RPCBatch RPCClient::batch()
+{
+    return RPCBatch(this);
+}
+
+void RPCClient::sendBatch(const QVector<RPCBatch::PendingCall> &calls)
+{
+    QJsonArray requests;
+    bool idempotent = true;
+    for (const RPCBatch::PendingCall &call : calls) {
+        idempotent = idempotent && isIdempotent(call.method);
+        QJsonObject request;
+        request["jsonrpc"] = "2.0";
+        request["id"] = call.id;
+        request["method"] = call.method;
+        request["params"] = call.params;
+        requests.append(request);
     }
 
-    reply->deleteLater();
-    return result;
+    QByteArray data = QJsonDocument(requests).toJson(QJsonDocument::Compact);
+    QFuture<HttpResponse> reply = postPayload(data, idempotent);
+
+    // Continuation runs on the transport thread; it only touches the promises
+    reply.then([calls](const HttpResponse &response) {
+        // Responses may arrive in any order; match them back by id
+        QHash<int, QJsonValue> results;
+        if (response.ok()) {
+            QJsonDocument responseDoc = QJsonDocument::fromJson(response.body);
+            if (responseDoc.isArray()) {
+                for (const QJsonValue &val : responseDoc.array()) {
+                    QJsonObject responseObj = val.toObject();
+                    if (!responseObj.contains("error")) {
+                        results.insert(responseObj["id"].toInt(), responseObj["result"]);
+                    }
+                }
+            }
+        }
+
+        for (const RPCBatch::PendingCall &call : calls) {
+            call.promise->addResult(results.value(call.id));
+            call.promise->finish();
+        }
+    });
 }
 
-void RPCClient::callAsync(const QString &method,
-                          const QJsonValue &params,
-                          std::function<void(const QJsonValue&)> callback)
+bool RPCClient::isIdempotent(const QString &method)
+{
+    return method != "eth_sendRawTransaction" && method != "sendTransaction";
+}
+
+QFuture<HttpResponse> RPCClient::postPayload(const QByteArray &data, bool idempotent)
+{
+    if (!chainRoute.isEmpty()) {
+        return NetworkService::instance()->rpcManager()->post(chainRoute, QString(), data, idempotent);
+    }
+    return NetworkService::instance()->transport()->post(QUrl(endpoint), data);
+}
+
+QByteArray RPCClient::encodeRequest(const QString &method, const QJsonValue &params)
 {
     QJsonObject request;
     request["jsonrpc"] = "2.0";
-    request["id"] = requestId++;
+    request["id"] = requestId.fetchAndAddRelaxed(1);
     request["method"] = method;
     request["params"] = params;
 
-    QNetworkRequest netRequest(endpoint);
-    netRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    return QJsonDocument(request).toJson(QJsonDocument::Compact);
+}
+
+RPCBatch::RPCBatch(RPCClient *client)
+    : client(client)
+{
+}
 
-    QJsonDocument doc(request);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+RPCBatch::~RPCBatch()
+{
+    // Never leave a caller waiting on a call that was not sent
+    if (!calls.isEmpty()) {
+        send();
+    }
+}
 
-    QNetworkReply *reply = networkManager->post(netRequest, data);
+QFuture<QJsonValue> RPCBatch::add(const QString &method, const QJsonValue &params)
+{
+    PendingCall call;
+    call.id = client->requestId.fetchAndAddRelaxed(1);
+    call.method = method;
+    call.params = params;
+    call.promise = std::make_shared<QPromise<QJsonValue>>();
+    call.promise->start();
 
-    connect(reply, &QNetworkReply::finished, this, [this, reply, callback]() {
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray response = reply->readAll();
-            QJsonDocument responseDoc = QJsonDocument::fromJson(response);
-            if (responseDoc.isObject()) {
-                QJsonObject responseObj = responseDoc.object();
-                QJsonValue result = responseObj["result"];
-                callback(result);
-                emit requestCompleted(result);
-            }
-        } else {
-            emit requestFailed(reply->errorString());
-        }
-        reply->deleteLater();
-    });
+    calls.append(call);
+    return call.promise->future();
+}
+
+void RPCBatch::send()
+{
+    int chunkSize = client->maxBatchSize;
+    for (int offset = 0; offset < calls.size(); offset += chunkSize) {
+        client->sendBatch(calls.mid(offset, chunkSize));
+    }
+    calls.clear();
 }
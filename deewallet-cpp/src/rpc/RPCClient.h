@@ -7,8 +7,59 @@
 #define RPCCLIENT_H
 
 #include <QObject>
-#include <QNetworkAccessManager>
+#include <QFuture>
+#include <QAtomicInt>
 #include <QJsonValue>
+#include <QVector>
+#include <functional>
+#include <memory>
+
+template<typename T> class QPromise;
+class RPCClient;
+struct HttpResponse;
+
+// Outcome of one call with a node's JSON-RPC error kept apart from a
+// transport failure, after which the node may or may not have processed it
+struct RPCResponse {
+    QJsonValue result;
+    QString error;
+    bool delivered = false;     // the node answered, with a result or an error
+
+    bool ok() const { return delivered && error.isEmpty(); }
+};
+
+// Collects JSON-RPC calls and sends them as batch arrays.
+// Each add() gets its own future, resolved by matching the response id.
+class RPCBatch {
+public:
+    ~RPCBatch();
+
+    RPCBatch(RPCBatch&&) = default;
+    RPCBatch(const RPCBatch&) = delete;
+    RPCBatch& operator=(const RPCBatch&) = delete;
+
+    QFuture<QJsonValue> add(const QString &method, const QJsonValue &params);
+
+    // Send queued calls, split into arrays of at most maxBatchSize entries.
+    // Called automatically on destruction if anything is still queued.
+    void send();
+
+    int size() const { return calls.size(); }
+
+private:
+    friend class RPCClient;
+    explicit RPCBatch(RPCClient *client);
+
+    struct PendingCall {
+        int id;
+        QString method;
+        QJsonValue params;
+        std::shared_ptr<QPromise<QJsonValue>> promise;
+    };
+
+    RPCClient *client;
+    QVector<PendingCall> calls;
+};
 
 class RPCClient : public QObject {
     Q_OBJECT
@@ -16,6 +67,10 @@ class RPCClient : public QObject {
 public:
     explicit RPCClient(const QString &endpoint, QObject *parent = nullptr);
 
+    // Send through RPCManager's router for this chain (best endpoint, hedged)
+    // instead of the fixed endpoint. Ignored if the chain has no configured endpoints.
+    void setChainRoute(const QString &chainType);
+
     // Synchronous call (blocking)
     QJsonValue call(const QString &method, const QJsonValue &params);
 
@@ -24,14 +79,38 @@ public:
                    const QJsonValue &params,
                    std::function<void(const QJsonValue&)> callback);
 
+    // Future-based call over the shared transport; resolves to the "result"
+    // member, or an undefined value on transport / JSON-RPC error
+    QFuture<QJsonValue> request(const QString &method, const QJsonValue &params);
+
+    // Single call with the full outcome; not shared with identical calls in flight
+    QFuture<RPCResponse> requestResponse(const QString &method, const QJsonValue &params);
+
+    // Batch builder; calls are sent as JSON-RPC arrays
+    RPCBatch batch();
+
+    // Upper bound on calls per HTTP request (many public nodes cap batches)
+    void setMaxBatchSize(int size) { maxBatchSize = size > 0 ? size : 1; }
+    int getMaxBatchSize() const { return maxBatchSize; }
+
 signals:
     void requestCompleted(const QJsonValue &result);
     void requestFailed(const QString &error);
 
 private:
-    QNetworkAccessManager *networkManager;
+    friend class RPCBatch;
+
+    // Calls that submit something (broadcasts) must not be hedged or retried elsewhere
+    static bool isIdempotent(const QString &method);
+
+    QByteArray encodeRequest(const QString &method, const QJsonValue &params);
+    QFuture<HttpResponse> postPayload(const QByteArray &data, bool idempotent);
+    void sendBatch(const QVector<RPCBatch::PendingCall> &calls);
+
     QString endpoint;
-    int requestId;
+    QString chainRoute;
+    QAtomicInt requestId;
+    int maxBatchSize;
 };
 
 #endif // RPCCLIENT_H
@@ -7,15 +7,25 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QPromise>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
 
-RPCManager::RPCManager()
-    : healthCheckRunning(false)
+RPCManager::RPCManager(HttpTransport *transport, QObject *parent)
+    : QObject(parent)
+    , transport(transport)
+    , healthTimer(new QTimer(this))
+    , healthCheckRunning(false)
 {
+    connect(healthTimer, &QTimer::timeout, this, &RPCManager::probeAll);
 }
 
 RPCManager::~RPCManager()
 {
-    stopHealthCheck();
+    healthTimer->stop();
 }
 
 void RPCManager::loadEndpoints(const QString &configPath)
@@ -36,6 +46,7 @@ void RPCManager::loadEndpoints(const QString &configPath)
     QJsonObject root = doc.object();
     QJsonObject mainnet = root["mainnet"].toObject();
 
+    QMutexLocker locker(&mutex);
     for (const QString &chain : mainnet.keys()) {
         QJsonArray endpointArray = mainnet[chain].toArray();
         QVector<RPCEndpoint> chainEndpoints;
@@ -51,16 +62,23 @@ void RPCManager::loadEndpoints(const QString &configPath)
             ep.lastCheck = 0;
             ep.failureCount = 0;
 
+            // Requests per second the provider allows; enforced by the transport
+            if (ep.rateLimit > 0) {
+                transport->setRateLimit(QUrl(ep.url), ep.rateLimit);
+            }
+
             chainEndpoints.append(ep);
         }
 
         endpoints[chain] = chainEndpoints;
         currentEndpointIndex[chain] = 0;
+        rankEndpoints(chain);
     }
 }
 
 QString RPCManager::getEndpoint(const QString &chainType)
 {
+    QMutexLocker locker(&mutex);
     if (!endpoints.contains(chainType) || endpoints[chainType].isEmpty()) {
         return QString();
     }
@@ -71,6 +89,7 @@ QString RPCManager::getEndpoint(const QString &chainType)
 
 bool RPCManager::setEndpoint(const QString &chainType, const QString &url)
 {
+    QMutexLocker locker(&mutex);
     if (!endpoints.contains(chainType)) {
         return false;
     }
@@ -88,6 +107,7 @@ bool RPCManager::setEndpoint(const QString &chainType, const QString &url)
 
 QVector<RPCEndpoint> RPCManager::getAvailableEndpoints(const QString &chainType)
 {
+    QMutexLocker locker(&mutex);
     if (!endpoints.contains(chainType)) {
         return QVector<RPCEndpoint>();
     }
@@ -95,66 +115,362 @@ QVector<RPCEndpoint> RPCManager::getAvailableEndpoints(const QString &chainType)
     return endpoints[chainType];
 }
 
-void RPCManager::startHealthCheck()
+bool RPCManager::hasChain(const QString &chainType)
+{
+    QMutexLocker locker(&mutex);
+    return endpoints.contains(chainType) && !endpoints[chainType].isEmpty();
+}
+
+qint64 RPCManager::headHeight(const QString &chainType)
+{
+    QMutexLocker locker(&mutex);
+    qint64 height = 0;
+    for (const RPCEndpoint &ep : endpoints.value(chainType)) {
+        height = std::max(height, ep.headHeight);
+    }
+    return height;
+}
+
+QFuture<HttpResponse> RPCManager::get(const QString &chainType, const QString &path)
+{
+    // Concurrent reads of the same resource share one routed request
+    QByteArray key = chainType.toUtf8() + ' ' + path.toUtf8();
+    return inFlightGets.run(key, [this, &chainType, &path]() {
+        return routedRequest(Method::Get, chainType, path, QByteArray(), true);
+    });
+}
+
+QFuture<HttpResponse> RPCManager::post(const QString &chainType,
+                                       const QString &path,
+                                       const QByteArray &body,
+                                       bool idempotent)
+{
+    return routedRequest(Method::Post, chainType, path, body, idempotent);
+}
+
+void RPCManager::startHealthCheck(int intervalMs)
 {
-    // TODO: Implement periodic health checking
     healthCheckRunning = true;
+
+    // Timers belong to the manager's thread
+    QMetaObject::invokeMethod(this, [this, intervalMs]() {
+        probeAll();
+        healthTimer->start(intervalMs);
+    }, Qt::QueuedConnection);
 }
 
 void RPCManager::stopHealthCheck()
 {
     healthCheckRunning = false;
+    QMetaObject::invokeMethod(healthTimer, &QTimer::stop, Qt::QueuedConnection);
 }
 
 void RPCManager::reportFailure(const QString &chainType, const QString &error)
 {
-    if (!endpoints.contains(chainType)) {
+    Q_UNUSED(error);
+
+    QMutexLocker locker(&mutex);
+    if (!endpoints.contains(chainType) || endpoints[chainType].isEmpty()) {
         return;
     }
 
     int index = currentEndpointIndex[chainType];
     RPCEndpoint &ep = endpoints[chainType][index];
     ep.failureCount++;
+    recordSample(ep, static_cast<qint64>(ep.latencyMs), false);
+
+    // The error rate feeds the score, so repeated failures move traffic elsewhere
+    rankEndpoints(chainType);
+}
+
+void RPCManager::reportResult(const QString &chainType, const QString &url, qint64 latencyMs, bool ok)
+{
+    QMutexLocker locker(&mutex);
+    if (!endpoints.contains(chainType)) {
+        return;
+    }
 
-    // Switch to next endpoint after 3 failures
-    if (ep.failureCount >= 3) {
-        switchToNextEndpoint(chainType);
+    for (RPCEndpoint &ep : endpoints[chainType]) {
+        if (ep.url == url) {
+            recordSample(ep, latencyMs, ok);
+            break;
+        }
+    }
+    rankEndpoints(chainType);
+}
+
+RPCManager::Protocol RPCManager::protocolFor(const QString &chainType)
+{
+    // The UTXO adapters read any routed endpoint of theirs as an Esplora API
+    if (chainType == "BTC" || chainType == "LTC" || chainType == "DOGE") {
+        return Protocol::Esplora;
+    } else if (chainType == "TRX") {
+        return Protocol::Tron;
+    } else if (chainType == "SOL") {
+        return Protocol::SolanaJsonRpc;
+    }
+    return Protocol::EvmJsonRpc;
+}
+
+void RPCManager::probeAll()
+{
+    if (!healthCheckRunning) {
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+    for (auto it = endpoints.begin(); it != endpoints.end(); ++it) {
+        for (RPCEndpoint &ep : it.value()) {
+            checkEndpointHealth(it.key(), ep);
+        }
     }
 }
 
 void RPCManager::checkEndpointHealth(const QString &chainType, RPCEndpoint &endpoint)
 {
-    // TODO: Implement actual health check (e.g., eth_blockNumber)
+    // Cheapest call that also reports the chain head
+    Protocol protocol = protocolFor(chainType);
+    QFuture<HttpResponse> probe;
+
+    // Probes never compete with user traffic for an endpoint's rate budget
+    const HttpTransport::Priority priority = HttpTransport::Priority::Background;
+
+    if (protocol == Protocol::Esplora) {
+        probe = transport->get(QUrl(endpoint.url + "/blocks/tip/height"), priority);
+    } else if (protocol == Protocol::Tron) {
+        probe = transport->post(QUrl(endpoint.url + "/wallet/getnowblock"), "{}", priority);
+    } else {
+        QJsonObject request;
+        request["jsonrpc"] = "2.0";
+        request["id"] = 1;
+        request["method"] = protocol == Protocol::SolanaJsonRpc ? "getSlot" : "eth_blockNumber";
+        request["params"] = QJsonArray();
+        probe = transport->post(QUrl(endpoint.url), QJsonDocument(request).toJson(QJsonDocument::Compact), priority);
+    }
+
+    QString url = endpoint.url;
+    probe.then(this, [this, chainType, url, protocol](const HttpResponse &response) {
+        qint64 height = 0;
+        if (response.ok()) {
+            if (protocol == Protocol::Esplora) {
+                height = response.body.trimmed().toLongLong();
+            } else {
+                QJsonObject obj = QJsonDocument::fromJson(response.body).object();
+                if (protocol == Protocol::Tron) {
+                    height = obj["block_header"].toObject()["raw_data"].toObject()["number"].toVariant().toLongLong();
+                } else if (protocol == Protocol::SolanaJsonRpc) {
+                    height = obj["result"].toVariant().toLongLong();
+                } else {
+                    bool ok;
+                    height = obj["result"].toString().mid(2).toLongLong(&ok, 16);
+                }
+            }
+        }
+
+        recordProbe(chainType, url, response.elapsedMs, response.ok() && height > 0, height);
+    });
 }
 
-void RPCManager::switchToNextEndpoint(const QString &chainType)
+void RPCManager::recordProbe(const QString &chainType, const QString &url, qint64 latencyMs, bool ok, qint64 height)
 {
+    QMutexLocker locker(&mutex);
     if (!endpoints.contains(chainType)) {
         return;
     }
 
     QVector<RPCEndpoint> &chainEndpoints = endpoints[chainType];
-    int &index = currentEndpointIndex[chainType];
-
-    // Find next healthy endpoint
-    int startIndex = index;
-    do {
-        index = (index + 1) % chainEndpoints.size();
-        if (chainEndpoints[index].isHealthy) {
-            chainEndpoints[index].failureCount = 0;
-            return;
+    qint64 bestHeight = 0;
+    for (RPCEndpoint &ep : chainEndpoints) {
+        if (ep.url == url) {
+            recordSample(ep, latencyMs, ok);
+            ep.lastCheck = QDateTime::currentMSecsSinceEpoch();
+            if (ok) {
+                ep.headHeight = height;
+            }
         }
-    } while (index != startIndex);
+        bestHeight = std::max(bestHeight, ep.headHeight);
+    }
+
+    // Head lag against the most advanced endpoint of the same chain
+    for (RPCEndpoint &ep : chainEndpoints) {
+        ep.headLag = ep.headHeight > 0 ? bestHeight - ep.headHeight : 0;
+        ep.isHealthy = ep.errorRate < 0.5 && ep.headLag <= MAX_HEAD_LAG;
+    }
+
+    rankEndpoints(chainType);
+}
+
+void RPCManager::recordSample(RPCEndpoint &endpoint, qint64 latencyMs, bool ok)
+{
+    // Failures only move the error rate; their latency is usually a timeout
+    endpoint.errorRate = EWMA_ALPHA * (ok ? 0.0 : 1.0) + (1.0 - EWMA_ALPHA) * endpoint.errorRate;
+    endpoint.isHealthy = endpoint.errorRate < 0.5 && endpoint.headLag <= MAX_HEAD_LAG;
+    if (!ok) {
+        return;
+    }
+
+    endpoint.failureCount = 0;
+    endpoint.latencyMs = endpoint.latencyMs == 0.0
+        ? latencyMs
+        : EWMA_ALPHA * latencyMs + (1.0 - EWMA_ALPHA) * endpoint.latencyMs;
+
+    if (endpoint.latencySamples.size() < LATENCY_WINDOW) {
+        endpoint.latencySamples.append(latencyMs);
+    } else {
+        endpoint.latencySamples[endpoint.sampleCursor] = latencyMs;
+        endpoint.sampleCursor = (endpoint.sampleCursor + 1) % LATENCY_WINDOW;
+    }
+}
+
+void RPCManager::rankEndpoints(const QString &chainType)
+{
+    // Caller holds the mutex
+    const QVector<RPCEndpoint> &chainEndpoints = endpoints[chainType];
+    int best = 0;
+    for (int i = 1; i < chainEndpoints.size(); ++i) {
+        if (score(chainEndpoints[i]) < score(chainEndpoints[best])) {
+            best = i;
+        }
+    }
+    currentEndpointIndex[chainType] = best;
+}
+
+double RPCManager::score(const RPCEndpoint &endpoint) const
+{
+    // Lower is better. Before the first sample the configured priority decides.
+    double latency = endpoint.latencyMs > 0.0 ? endpoint.latencyMs : 500.0 + endpoint.priority * 100.0;
+    double value = latency * (1.0 + 4.0 * endpoint.errorRate) + endpoint.headLag * 250.0;
+    return endpoint.isHealthy ? value : value + 1e6;
+}
+
+qint64 RPCManager::p95LatencyMs(const RPCEndpoint &endpoint) const
+{
+    if (endpoint.latencySamples.size() < 5) {
+        return DEFAULT_HEDGE_MS;
+    }
+
+    QVector<qint64> sorted = endpoint.latencySamples;
+    std::sort(sorted.begin(), sorted.end());
+    int rank = (sorted.size() * 95 + 99) / 100;  // ceil(0.95 * n)
+    return sorted[rank - 1];
+}
+
+QFuture<HttpResponse> RPCManager::routedRequest(Method method,
+                                                const QString &chainType,
+                                                const QString &path,
+                                                const QByteArray &body,
+                                                bool idempotent)
+{
+    auto request = std::make_shared<RoutedRequest>();
+    request->method = method;
+    request->chainType = chainType;
+    request->path = path;
+    request->body = body;
+    request->priority = HttpTransport::currentPriority();  // caller's class, not the network thread's
+    request->promise = std::make_shared<QPromise<HttpResponse>>();
+    request->promise->start();
+    QFuture<HttpResponse> future = request->promise->future();
+
+    {
+        // Best and runner-up by current score
+        QMutexLocker locker(&mutex);
+        const QVector<RPCEndpoint> chainEndpoints = endpoints.value(chainType);
+        QVector<int> order;
+        for (int i = 0; i < chainEndpoints.size(); ++i) {
+            order.append(i);
+        }
+        std::sort(order.begin(), order.end(), [this, &chainEndpoints](int a, int b) {
+            return score(chainEndpoints[a]) < score(chainEndpoints[b]);
+        });
+
+        if (!order.isEmpty()) {
+            request->primaryUrl = chainEndpoints[order[0]].url;
+            request->hedgeDelayMs = p95LatencyMs(chainEndpoints[order[0]]);
+        }
+        // Without a runner-up there is neither a hedge nor a failover: a
+        // broadcast that timed out may still have reached the node
+        if (order.size() > 1 && idempotent) {
+            request->secondaryUrl = chainEndpoints[order[1]].url;
+        }
+    }
+
+    if (request->primaryUrl.isEmpty()) {
+        HttpResponse response;
+        response.error = "No endpoint configured for " + chainType;
+        request->promise->addResult(response);
+        request->promise->finish();
+        return future;
+    }
+
+    // All bookkeeping for this request happens on the manager's thread
+    QMetaObject::invokeMethod(this, [this, request]() {
+        launchAttempt(request, request->primaryUrl);
+
+        if (!request->secondaryUrl.isEmpty()) {
+            QTimer::singleShot(request->hedgeDelayMs, this, [this, request]() {
+                if (!request->done && !request->secondaryLaunched) {
+                    request->secondaryLaunched = true;
+                    launchAttempt(request, request->secondaryUrl);
+                }
+            });
+        }
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+void RPCManager::launchAttempt(std::shared_ptr<RoutedRequest> request, const QString &baseUrl)
+{
+    QUrl url(baseUrl + request->path);
+    QFuture<HttpResponse> reply = request->method == Method::Get
+        ? transport->get(url, request->priority)
+        : transport->post(url, request->body, request->priority);
+
+    request->outstanding++;
+    reply.then(this, [this, request, baseUrl](const HttpResponse &response) {
+        onAttemptFinished(request, baseUrl, response);
+    });
+}
+
+void RPCManager::onAttemptFinished(std::shared_ptr<RoutedRequest> request,
+                                   const QString &baseUrl,
+                                   const HttpResponse &response)
+{
+    request->outstanding--;
+    reportResult(request->chainType, baseUrl, response.elapsedMs, response.ok());
+
+    if (request->done) {
+        return;
+    }
+
+    // First success wins; a failed primary fails over immediately
+    if (!response.ok() && !request->secondaryLaunched && !request->secondaryUrl.isEmpty()) {
+        request->secondaryLaunched = true;
+        launchAttempt(request, request->secondaryUrl);
+        return;
+    }
+
+    if (response.ok() || request->outstanding == 0) {
+        request->done = true;
+        request->promise->addResult(response);
+        request->promise->finish();
+    }
 }
 
 QMap<QString, QString> RPCManager::getStats()
 {
+    QMutexLocker locker(&mutex);
     QMap<QString, QString> stats;
 
     for (const QString &chain : endpoints.keys()) {
         int index = currentEndpointIndex[chain];
         if (index < endpoints[chain].size()) {
-            stats[chain] = endpoints[chain][index].name;
+            const RPCEndpoint &ep = endpoints[chain][index];
+            stats[chain] = QString("%1 (%2 ms, %3% errors, lag %4)")
+                .arg(ep.name)
+                .arg(qRound(ep.latencyMs))
+                .arg(qRound(ep.errorRate * 100.0))
+                .arg(ep.headLag);
         }
     }
 
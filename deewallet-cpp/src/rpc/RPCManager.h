@@ -6,46 +6,136 @@
 #ifndef RPCMANAGER_H
 #define RPCMANAGER_H
 
+#include <QObject>
 #include <QString>
 #include <QVector>
 #include <QMap>
+#include <QMutex>
+#include <QFuture>
+#include <memory>
+#include "HttpTransport.h"
+#include "SingleFlight.h"
+
+class QTimer;
 
 struct RPCEndpoint {
     QString name;
     QString url;
     int priority;
-    int rateLimit;
+    int rateLimit;      // requests per second
     bool isHealthy;
     qint64 lastCheck;
     int failureCount;
+
+    // Live statistics from probes and routed traffic
+    double latencyMs = 0.0;         // EWMA
+    double errorRate = 0.0;         // EWMA of 0 (ok) / 1 (failure)
+    qint64 headHeight = 0;          // block height / slot from the last probe
+    qint64 headLag = 0;             // blocks behind the best endpoint of the chain
+    QVector<qint64> latencySamples; // ring buffer for the p95 estimate
+    int sampleCursor = 0;
 };
 
-class RPCManager {
+class RPCManager : public QObject {
+    Q_OBJECT
+
 public:
-    RPCManager();
-    ~RPCManager();
+    explicit RPCManager(HttpTransport *transport, QObject *parent = nullptr);
+    ~RPCManager() override;
 
     // Endpoint management
     void loadEndpoints(const QString &configPath);
     QString getEndpoint(const QString &chainType);
     bool setEndpoint(const QString &chainType, const QString &url);
     QVector<RPCEndpoint> getAvailableEndpoints(const QString &chainType);
+    bool hasChain(const QString &chainType);
+
+    // Highest block height / slot reported by the prober (0 = unknown)
+    qint64 headHeight(const QString &chainType);
 
-    // Health checking
-    void startHealthCheck();
+    // Routed requests: sent to the best-scoring endpoint (path is appended to
+    // its base URL) and hedged to the runner-up once the p95 latency passes.
+    // A request that is not idempotent (a broadcast) goes to the best endpoint
+    // only, with no hedge and no failover, so it is never submitted twice.
+    QFuture<HttpResponse> get(const QString &chainType, const QString &path);
+    QFuture<HttpResponse> post(const QString &chainType,
+                               const QString &path,
+                               const QByteArray &body,
+                               bool idempotent = true);
+
+    // Health checking (thread-safe; the prober runs on the manager's thread)
+    void startHealthCheck(int intervalMs = 30000);
     void stopHealthCheck();
     void reportFailure(const QString &chainType, const QString &error);
+    void reportResult(const QString &chainType, const QString &url, qint64 latencyMs, bool ok);
 
     // Statistics
     QMap<QString, QString> getStats();
 
 private:
+    enum class Protocol {
+        EvmJsonRpc,     // eth_blockNumber
+        SolanaJsonRpc,  // getSlot
+        Tron,           // /wallet/getnowblock
+        Esplora         // /blocks/tip/height
+    };
+
+    enum class Method {
+        Get,
+        Post
+    };
+
+    static Protocol protocolFor(const QString &chainType);
+
+    void probeAll();
     void checkEndpointHealth(const QString &chainType, RPCEndpoint &endpoint);
-    void switchToNextEndpoint(const QString &chainType);
+    void recordProbe(const QString &chainType, const QString &url, qint64 latencyMs, bool ok, qint64 height);
+    void recordSample(RPCEndpoint &endpoint, qint64 latencyMs, bool ok);
+    void rankEndpoints(const QString &chainType);
+
+    double score(const RPCEndpoint &endpoint) const;
+    qint64 p95LatencyMs(const RPCEndpoint &endpoint) const;
+
+    // One logical request fanned out to at most two endpoints
+    struct RoutedRequest {
+        Method method;
+        QString chainType;
+        QString path;
+        QByteArray body;
+        HttpTransport::Priority priority;
+        QString primaryUrl;
+        QString secondaryUrl;
+        qint64 hedgeDelayMs = 0;
+        int outstanding = 0;
+        bool secondaryLaunched = false;
+        bool done = false;
+        std::shared_ptr<QPromise<HttpResponse>> promise;
+    };
+
+    QFuture<HttpResponse> routedRequest(Method method,
+                                        const QString &chainType,
+                                        const QString &path,
+                                        const QByteArray &body,
+                                        bool idempotent);
+    void launchAttempt(std::shared_ptr<RoutedRequest> request, const QString &baseUrl);
+    void onAttemptFinished(std::shared_ptr<RoutedRequest> request,
+                           const QString &baseUrl,
+                           const HttpResponse &response);
+
+    HttpTransport *transport;
+    QTimer *healthTimer;
+    QMutex mutex;
 
     QMap<QString, QVector<RPCEndpoint>> endpoints;
     QMap<QString, int> currentEndpointIndex;
     bool healthCheckRunning;
+
+    SingleFlight<HttpResponse> inFlightGets;
+
+    static constexpr double EWMA_ALPHA = 0.2;
+    static constexpr int LATENCY_WINDOW = 32;
+    static constexpr qint64 DEFAULT_HEDGE_MS = 1500;
+    static constexpr qint64 MAX_HEAD_LAG = 5;
 };
 
 #endif // RPCMANAGER_H
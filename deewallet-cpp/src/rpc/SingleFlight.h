@@ -0,0 +1,67 @@
+/**
+ * DEE WALLET - Single Flight
+ * Collapses identical concurrent requests into one in-flight call
+ */
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <functional>
+
+template<typename T>
+class SingleFlight {
+public:
+    // Returns the pending future for key if one is in flight; otherwise calls
+    // launch() and shares its future with every caller until it resolves.
+    // launch() must only start the work (it runs under the lock).
+    QFuture<T> run(const QByteArray &key, const std::function<QFuture<T>()> &launch)
+    {
+        quint64 generation;
+        QFuture<T> future;
+        {
+            QMutexLocker locker(&mutex);
+            auto it = inFlight.constFind(key);
+            if (it != inFlight.constEnd()) {
+                return it->future;
+            }
+
+            future = launch();
+            generation = ++nextGeneration;
+            inFlight.insert(key, Entry{future, generation});
+        }
+
+        // Forget the entry once resolved; a newer flight under the same key is kept
+        future.then([this, key, generation](const T &) {
+            QMutexLocker locker(&mutex);
+            auto it = inFlight.find(key);
+            if (it != inFlight.end() && it->generation == generation) {
+                inFlight.erase(it);
+            }
+        });
+
+        return future;
+    }
+
+    int inFlightCount()
+    {
+        QMutexLocker locker(&mutex);
+        return inFlight.size();
+    }
+
+private:
+    struct Entry {
+        QFuture<T> future;
+        quint64 generation;
+    };
+
+    QMutex mutex;
+    QHash<QByteArray, Entry> inFlight;
+    quint64 nextGeneration = 0;
+};
+
+#endif // SINGLEFLIGHT_H
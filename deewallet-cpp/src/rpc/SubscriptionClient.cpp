@@ -0,0 +1,219 @@
+/**
+ * DEE WALLET - Subscription Client Implementation
+ */
+
+#include "SubscriptionClient.h"
+#include <QWebSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QMetaObject>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+SubscriptionClient::SubscriptionClient(const QString &chainType, const QStringList &urls,
+                                       QObject *parent)
+    : QObject(parent)
+    , chain(chainType)
+    , urls(urls)
+    , urlIndex(0)
+    , nextHandle(1)
+    , socket(nullptr)
+    , keepAlive(nullptr)
+    , reconnectTimer(nullptr)
+    , reconnectDelayMs(RECONNECT_MIN_MS)
+    , ready(false)
+    , awaitingPong(false)
+    , nextId(1)
+{
+}
+
+SubscriptionClient::~SubscriptionClient()
+{
+    // No reconnect or signals from a client that is going away
+    if (socket) {
+        socket->disconnect(this);
+        socket->abort();
+    }
+}
+
+int SubscriptionClient::subscribe(const QString &method, const QJsonArray &params)
+{
+    int handle = nextHandle.fetchAndAddRelaxed(1);
+    if (urls.isEmpty()) {
+        return handle;
+    }
+
+    Subscription subscription;
+    subscription.method = method;
+    subscription.params = params;
+
+    // The socket is not thread-safe; always hop onto the client's thread
+    QMetaObject::invokeMethod(this, [this, handle, subscription]() {
+        add(handle, subscription);
+    }, Qt::QueuedConnection);
+
+    return handle;
+}
+
+void SubscriptionClient::add(int handle, const Subscription &subscription)
+{
+    subscriptions.insert(handle, subscription);
+    if (ready) {
+        sendSubscribe(handle);
+    } else {
+        // Everything is (re)subscribed once the session is up
+        ensureConnected();
+    }
+}
+
+void SubscriptionClient::sendSubscribe(int handle)
+{
+    const Subscription &subscription = subscriptions[handle];
+    int id = nextId++;
+    pendingRequests.insert(id, handle);
+
+    QJsonObject request;
+    request["jsonrpc"] = "2.0";
+    request["id"] = id;
+    request["method"] = subscription.method;
+    request["params"] = subscription.params;
+    socket->sendTextMessage(QString::fromUtf8(QJsonDocument(request).toJson(QJsonDocument::Compact)));
+}
+
+void SubscriptionClient::ensureConnected()
+{
+    // Created lazily so they live on the client's thread
+    if (!socket) {
+        socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+        connect(socket, &QWebSocket::connected, this, &SubscriptionClient::onConnected);
+        connect(socket, &QWebSocket::textMessageReceived, this, &SubscriptionClient::onMessage);
+        connect(socket, &QWebSocket::pong, this, [this]() {
+            awaitingPong = false;
+        });
+        connect(socket, &QWebSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+            if (state == QAbstractSocket::UnconnectedState) {
+                onDisconnected();
+            }
+        });
+
+        keepAlive = new QTimer(this);
+        connect(keepAlive, &QTimer::timeout, this, [this]() {
+            // Public nodes drop idle sockets, and a half-open one never
+            // reports an error on its own
+            if (awaitingPong) {
+                socket->abort();
+                return;
+            }
+            awaitingPong = true;
+            socket->ping();
+        });
+
+        reconnectTimer = new QTimer(this);
+        reconnectTimer->setSingleShot(true);
+        connect(reconnectTimer, &QTimer::timeout, this, &SubscriptionClient::ensureConnected);
+    }
+
+    if (socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+
+    socket->open(QUrl(urls[urlIndex]));
+}
+
+void SubscriptionClient::onConnected()
+{
+    ready = true;
+    awaitingPong = false;
+    keepAlive->start(KEEPALIVE_MS);
+    reconnectDelayMs = RECONNECT_MIN_MS;
+    emit connectionChanged(true);
+
+    // A new session has no subscriptions; renew every one of them
+    for (auto it = subscriptions.constBegin(); it != subscriptions.constEnd(); ++it) {
+        sendSubscribe(it.key());
+    }
+}
+
+void SubscriptionClient::onDisconnected()
+{
+    bool wasReady = ready;
+    ready = false;
+    if (keepAlive) {
+        keepAlive->stop();
+    }
+
+    qDebug() << "[SubscriptionClient]" << chain << "disconnected from"
+             << urls[urlIndex] << (socket ? socket->errorString() : QString());
+
+    // Server ids die with the session
+    pendingRequests.clear();
+    handlesByServerId.clear();
+    for (Subscription &subscription : subscriptions) {
+        subscription.serverId.clear();
+    }
+
+    if (wasReady) {
+        emit connectionChanged(false);
+    }
+
+    // Next attempt goes to the next server
+    urlIndex = (urlIndex + 1) % urls.size();
+    scheduleReconnect();
+}
+
+void SubscriptionClient::scheduleReconnect()
+{
+    if (subscriptions.isEmpty() || reconnectTimer->isActive()) {
+        return;
+    }
+
+    reconnectTimer->start(reconnectDelayMs);
+    reconnectDelayMs = qMin(reconnectDelayMs * 2, RECONNECT_MAX_MS);
+}
+
+void SubscriptionClient::onMessage(const QString &message)
+{
+    QJsonObject obj = QJsonDocument::fromJson(message.toUtf8()).object();
+
+    if (!obj.contains("id") || obj["id"].isNull()) {
+        // eth_subscription, accountNotification, logsNotification, ... all
+        // carry {subscription, result}
+        QJsonObject params = obj["params"].toObject();
+        auto it = handlesByServerId.constFind(idKey(params["subscription"]));
+        if (it != handlesByServerId.constEnd()) {
+            emit notification(it.value(), params["result"]);
+        }
+        return;
+    }
+
+    auto pending = pendingRequests.constFind(obj["id"].toInt());
+    if (pending == pendingRequests.constEnd()) {
+        return;
+    }
+    int handle = pending.value();
+    pendingRequests.erase(pending);
+
+    if (!subscriptions.contains(handle)) {
+        return;
+    }
+
+    QJsonValue error = obj["error"];
+    if (!error.isUndefined() && !error.isNull()) {
+        QString reason = error.isObject() ? error.toObject()["message"].toString("Subscription rejected")
+                                          : error.toString();
+        subscriptions.remove(handle);
+        emit subscriptionFailed(handle, reason);
+        return;
+    }
+
+    QString serverId = idKey(obj["result"]);
+    subscriptions[handle].serverId = serverId;
+    handlesByServerId.insert(serverId, handle);
+    emit subscribed(handle);
+}
+
+QString SubscriptionClient::idKey(const QJsonValue &id)
+{
+    return id.isString() ? id.toString() : QString::number(id.toInteger());
+}
@@ -0,0 +1,83 @@
+/**
+ * DEE WALLET - Subscription Client
+ * JSON-RPC pub/sub over one persistent WebSocket per chain (eth_subscribe,
+ * Solana accountSubscribe / logsSubscribe)
+ */
+
+#ifndef SUBSCRIPTIONCLIENT_H
+#define SUBSCRIPTIONCLIENT_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QAtomicInt>
+
+class QWebSocket;
+class QTimer;
+
+class SubscriptionClient : public QObject {
+    Q_OBJECT
+
+public:
+    SubscriptionClient(const QString &chainType, const QStringList &urls, QObject *parent = nullptr);
+    ~SubscriptionClient() override;
+
+    // Thread-safe. Returns a local handle that stays the same across
+    // reconnects; the subscription is renewed on every new session, and while
+    // any exist a dropped connection is re-established with backoff.
+    int subscribe(const QString &method, const QJsonArray &params);
+
+    QString chainType() const { return chain; }
+    bool hasServers() const { return !urls.isEmpty(); }
+
+signals:
+    // All emitted on the client's thread
+    void subscribed(int handle);
+    void subscriptionFailed(int handle, const QString &error);
+    void notification(int handle, const QJsonValue &result);
+    void connectionChanged(bool connected);
+
+private:
+    struct Subscription {
+        QString method;
+        QJsonArray params;
+        QString serverId;       // empty until confirmed in the current session
+    };
+
+    void add(int handle, const Subscription &subscription);
+    void sendSubscribe(int handle);
+    void ensureConnected();
+    void onConnected();
+    void onDisconnected();
+    void onMessage(const QString &message);
+    void scheduleReconnect();
+
+    // Geth returns hex string ids, Solana plain numbers
+    static QString idKey(const QJsonValue &id);
+
+    static constexpr int KEEPALIVE_MS = 30 * 1000;
+    static constexpr int RECONNECT_MIN_MS = 1000;
+    static constexpr int RECONNECT_MAX_MS = 60 * 1000;
+
+    QString chain;
+    QStringList urls;
+    int urlIndex;
+    QAtomicInt nextHandle;
+
+    // Touched only on the client's thread
+    QWebSocket *socket;
+    QTimer *keepAlive;
+    QTimer *reconnectTimer;
+    int reconnectDelayMs;
+    bool ready;
+    bool awaitingPong;
+    int nextId;
+    QHash<int, Subscription> subscriptions;     // handle -> subscription
+    QHash<QString, int> handlesByServerId;
+    QHash<int, int> pendingRequests;            // request id -> handle
+};
+
+#endif // SUBSCRIPTIONCLIENT_H
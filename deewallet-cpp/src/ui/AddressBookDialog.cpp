@@ -3,6 +3,7 @@
  */
 
 #include "AddressBookDialog.h"
+#include "../utils/AddressValidator.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
@@ -250,6 +251,12 @@ void AddressBookDialog::onAddAddress()
     QString address = QInputDialog::getText(this, "Add Address", "Enter address:");
     if (address.isEmpty()) return;
 
+    if (!AddressValidator::validate(chain, address)) {
+        QMessageBox::warning(this, "Error",
+            QString("Invalid %1 address (checksum mismatch or wrong format).").arg(chain));
+        return;
+    }
+
     // Get note (optional)
     QString note = QInputDialog::getText(this, "Add Address", "Enter note (optional):");
 
@@ -7,10 +7,11 @@
 #include "QRCodeDialog.h"
 #include "StyleHelper.h"
 #include "DesignTokens.h"
-#include "../chains/BitcoinAdapter.h"
-#include "../chains/EthereumAdapter.h"
-#include "../chains/TronAdapter.h"
-#include "../chains/SolanaAdapter.h"
+#include "../core/WalletStore.h"
+#include "../core/WalletService.h"
+#include "../core/HistorySync.h"
+#include "../core/AddressDiscovery.h"
+#include "../utils/Amount.h"
 #include <QScrollArea>
 #include <QMessageBox>
 #include <QApplication>
@@ -20,6 +21,10 @@
 #include <QTimer>
 #include <QMouseEvent>
 #include <QDebug>
+#include <QDateTime>
+#include <QSet>
+#include <QFuture>
+#include <algorithm>
 
 ChainDetailScreen::ChainDetailScreen(const QString &chainName,
                                      const QString &chainSymbol,
@@ -29,6 +34,11 @@ ChainDetailScreen::ChainDetailScreen(const QString &chainName,
     , chainName(chainName)
     , chainSymbol(chainSymbol)
     , mnemonic(mnemonic)
+    , walletRestored(false)
+    , discovery(nullptr)
+    , scanning(false)
+    , scannedCount(0)
+    , nextReceiveIndex(0)
     , addressListContainer(new QWidget(this))
     , addressListLayout(new QVBoxLayout(addressListContainer))
     , addAddressButton(new QPushButton("+ 주소 추가", this))
@@ -40,6 +50,16 @@ ChainDetailScreen::ChainDetailScreen(const QString &chainName,
     , transactionTable(new QTableWidget(this))
 {
     setupUI();
+
+    connect(WalletService::instance(), &WalletService::balanceUpdated,
+            this, &ChainDetailScreen::onBalanceUpdated);
+    connect(WalletService::instance(), &WalletService::activityDetected, this,
+            [this](const QString &chain, const QString &) {
+        // Pushed change on one of our addresses: pick up the new transaction
+        if (chain == chainSymbol) {
+            loadTransactionHistory();
+        }
+    });
     
     // Start address scanning in background
     QTimer::singleShot(100, this, [this]() {
@@ -172,32 +192,40 @@ void ChainDetailScreen::setupUI()
 
 void ChainDetailScreen::loadAddresses()
 {
-    if (!wallet.restoreFromMnemonic(mnemonic)) {
+    // Load first address (index 0)
+    QString address = addressAt(0);
+    if (address.isEmpty()) {
         QMessageBox::critical(this, "오류", "지갑 복원 실패");
         return;
     }
 
-    // Load first address (index 0)
-    QString address = wallet.deriveAddress(chainSymbol, 0);
-    if (!address.isEmpty()) {
-        addAddressCard(0, address, "0.0");
-        // Load balance asynchronously
-        QTimer::singleShot(100, this, [this]() {
-            updateBalance(0);
-        });
-    }
+    addAddressCard(0, address, "0.0");
+
+    // Legacy-only chains (DOGE) can be viewed and received on, not spent from
+    QString unsupported = WalletService::sendUnsupportedReason(chainSymbol, address);
+    sendButton->setEnabled(unsupported.isEmpty());
+    sendButton->setToolTip(unsupported);
+
+    // Load balance asynchronously
+    QTimer::singleShot(100, this, [this]() {
+        updateBalance(0);
+    });
 }
 
-void ChainDetailScreen::addAddressCard(int index, const QString &address, const QString &balance)
+void ChainDetailScreen::addAddressCard(int index, const QString &address, const QString &balance,
+                                       bool isChange)
 {
+    // Push updates where the chain supports them
+    WalletService::instance()->watch(chainSymbol, {address});
+
     auto *card = new QWidget(addressListContainer);
     card->setMinimumHeight(DesignTokens::Sizes::CARD_MIN_HEIGHT_LG);
     card->setCursor(Qt::PointingHandCursor);
     card->setStyleSheet(StyleHelper::interactiveCard());
 
-    // Make card clickable
+    // Make card clickable; the property is the position in addresses
     card->installEventFilter(this);
-    card->setProperty("addressIndex", index);
+    card->setProperty("addressIndex", addresses.size());
 
     auto *cardLayout = new QHBoxLayout(card);
     cardLayout->setContentsMargins(DesignTokens::Spacing::SPACING_XL,
@@ -210,7 +238,7 @@ void ChainDetailScreen::addAddressCard(int index, const QString &address, const
     auto *leftLayout = new QVBoxLayout();
     leftLayout->setSpacing(DesignTokens::Spacing::SPACING_XS);
 
-    auto *indexLabel = new QLabel(QString("주소 #%1").arg(index), card);
+    auto *indexLabel = new QLabel(QString(isChange ? "잔돈 주소 #%1" : "주소 #%1").arg(index), card);
     indexLabel->setStyleSheet(QString(R"(
         QLabel {
             background: transparent;
@@ -265,6 +293,7 @@ void ChainDetailScreen::addAddressCard(int index, const QString &address, const
     // Store address data
     AddressData data;
     data.index = index;
+    data.isChange = isChange;
     data.address = address;
     data.balance = balance;
     data.cardWidget = card;
@@ -276,21 +305,23 @@ void ChainDetailScreen::addAddressCard(int index, const QString &address, const
 
 void ChainDetailScreen::onAddAddress()
 {
-    int nextIndex = addresses.size();
+    int nextIndex = nextReceiveIndex;
     
     // Derive new address
-    QString newAddress = wallet.deriveAddress(chainSymbol, nextIndex);
+    QString newAddress = addressAt(nextIndex);
     
     if (newAddress.isEmpty()) {
         QMessageBox::warning(this, "오류", "주소 생성 실패");
         return;
     }
 
+    int position = addresses.size();
     addAddressCard(nextIndex, newAddress, "0.0");
+    nextReceiveIndex = nextIndex + 1;
     
     // Load balance for new address
-    QTimer::singleShot(100, this, [this, nextIndex]() {
-        updateBalance(nextIndex);
+    QTimer::singleShot(100, this, [this, position]() {
+        updateBalance(position);
     });
     
     QMessageBox::information(this, "완료", 
@@ -317,15 +348,22 @@ void ChainDetailScreen::onSendClicked()
         QMessageBox::warning(this, "경고", "주소가 없습니다");
         return;
     }
+
+    QString unsupported = WalletService::sendUnsupportedReason(chainSymbol, addresses[0].address);
+    if (!unsupported.isEmpty()) {
+        QMessageBox::information(this, "전송 불가", unsupported);
+        return;
+    }
     
     // Open send dialog with first address
-    SendTransactionDialog dialog(chainSymbol, addresses[0].address, mnemonic, this);
+    SendTransactionDialog dialog(chainSymbol, addresses[0].address, addresses[0].index,
+                                 addresses[0].isChange, mnemonic, this);
     dialog.exec();
     
-    // Refresh balance after sending
+    // Refresh balance after sending; the cached pre-send values are no longer valid
     QTimer::singleShot(1000, this, [this]() {
         for (int i = 0; i < addresses.size(); ++i) {
-            updateBalance(i);
+            WalletService::instance()->refreshBalance(chainSymbol, addresses[i].address);
         }
     });
 }
@@ -345,7 +383,7 @@ void ChainDetailScreen::onReceiveClicked()
 void ChainDetailScreen::onRefreshBalance()
 {
     for (int i = 0; i < addresses.size(); ++i) {
-        updateBalance(i);
+        WalletService::instance()->refreshBalance(chainSymbol, addresses[i].address);
     }
 }
 
@@ -355,36 +393,52 @@ void ChainDetailScreen::updateBalance(int index)
         return;
     }
     
-    QString address = addresses[index].address;
-    QString balance = "0.0";
-    
-    // Get balance based on chain type
-    if (chainSymbol == "BTC" || chainSymbol == "LTC" || chainSymbol == "DOGE") {
-        BitcoinAdapter adapter("", false);
-        balance = adapter.getBalance(address);
-    } else if (chainSymbol == "ETH") {
-        EthereumAdapter adapter("");
-        balance = adapter.getBalance(address);
-    } else if (chainSymbol == "TRX") {
-        TronAdapter adapter("");
-        balance = adapter.getBalance(address);
-    } else if (chainSymbol == "SOL") {
-        SolanaAdapter adapter("");
-        balance = adapter.getBalance(address);
+    // Cached value now; a stale or missing one is refetched in the background
+    // and arrives through onBalanceUpdated
+    QString balance = WalletService::instance()->balance(chainSymbol, addresses[index].address);
+
+    if (!balance.isEmpty()) {
+        applyBalance(index, balance);
     }
-    
+}
+
+void ChainDetailScreen::onBalanceUpdated(const QString &chain, const QString &address,
+                                         const QString &balance)
+{
+    if (chain != chainSymbol) {
+        return;
+    }
+
+    for (int i = 0; i < addresses.size(); ++i) {
+        if (addresses[i].address == address) {
+            applyBalance(i, balance);
+        }
+    }
+}
+
+void ChainDetailScreen::applyBalance(int index, const QString &balance)
+{
     // Update address card balance
     addresses[index].balance = balance;
     if (addresses[index].balanceLabel) {
         addresses[index].balanceLabel->setText(balance + " " + chainSymbol);
     }
     
-    // Update total balance
-    double total = 0.0;
+    updateTotalBalance();
+}
+
+void ChainDetailScreen::updateTotalBalance()
+{
+    Amount total;
     for (const auto &addr : addresses) {
-        total += addr.balance.toDouble();
+        total += Amount::parse(addr.balance);
     }
-    totalBalanceLabel->setText(QString::number(total, 'f', 8) + " " + chainSymbol);
+
+    QString text = total.toString(8) + " " + chainSymbol;
+    if (scanning) {
+        text += QString("  (스캔 중... %1개 확인)").arg(scannedCount);
+    }
+    totalBalanceLabel->setText(text);
 }
 
 void ChainDetailScreen::loadTransactionHistory()
@@ -396,132 +450,161 @@ void ChainDetailScreen::loadTransactionHistory()
         return;
     }
     
-    // TODO: Load actual transaction history from blockchain
-    // For now, show placeholder message
-    transactionTable->setRowCount(1);
-    
-    QLabel *noTxLabel = new QLabel("거래 내역을 불러오는 중...", this);
-    noTxLabel->setStyleSheet(R"(
-        QLabel {
-            background: transparent;
-            color: #64748B;
-            font-size: 13px;
+    // Stored history first, then only what is newer than each address's cursor
+    showTransactions("거래 내역을 불러오는 중...");
+
+    QStringList addressList;
+    for (const AddressData &data : addresses) {
+        addressList.append(data.address);
+    }
+
+    WalletService::instance()->syncHistory(chainSymbol, addressList).then(this, [this]() {
+        showTransactions("거래 내역이 없습니다");
+    });
+}
+
+void ChainDetailScreen::showTransactions(const QString &emptyMessage)
+{
+    QSet<QString> ownAddresses;
+    QMap<QString, Transaction> byKey;
+    for (const AddressData &data : addresses) {
+        ownAddresses.insert(data.address);
+        for (const Transaction &tx : HistorySync::cached(chainSymbol, data.address)) {
+            byKey.insert(WalletStore::transactionKey(tx), tx);
         }
-    )");
-    noTxLabel->setAlignment(Qt::AlignCenter);
-    
-    transactionTable->setCellWidget(0, 0, noTxLabel);
-    transactionTable->setSpan(0, 0, 1, 4);
+    }
+
+    QVector<Transaction> history = byKey.values();
+    std::sort(history.begin(), history.end(), [](const Transaction &a, const Transaction &b) {
+        return a.timestamp > b.timestamp;
+    });
+
+    transactionTable->clearSpans();
+    transactionTable->setRowCount(0);
+
+    if (history.isEmpty()) {
+        transactionTable->setRowCount(1);
+
+        QLabel *noTxLabel = new QLabel(emptyMessage, this);
+        noTxLabel->setStyleSheet(R"(
+            QLabel {
+                background: transparent;
+                color: #64748B;
+                font-size: 13px;
+            }
+        )");
+        noTxLabel->setAlignment(Qt::AlignCenter);
+
+        transactionTable->setCellWidget(0, 0, noTxLabel);
+        transactionTable->setSpan(0, 0, 1, 4);
+        return;
+    }
+
+    transactionTable->setRowCount(history.size());
+    for (int row = 0; row < history.size(); ++row) {
+        const Transaction &tx = history[row];
+
+        QString date = tx.timestamp > 0
+            ? QDateTime::fromSecsSinceEpoch(tx.timestamp).toString("yyyy-MM-dd HH:mm")
+            : QString("-");
+        bool outgoing = ownAddresses.contains(tx.from);
+        QString type = outgoing ? "보냄" : "받음";
+        QString status = tx.status == "pending" ? "대기 중"
+                       : tx.status == "failed" ? "실패" : "완료";
+
+        auto *typeItem = new QTableWidgetItem(type);
+        typeItem->setToolTip(tx.hash);
+
+        transactionTable->setItem(row, 0, new QTableWidgetItem(date));
+        transactionTable->setItem(row, 1, typeItem);
+        transactionTable->setItem(row, 2, new QTableWidgetItem((outgoing ? "-" : "+") + tx.value));
+        transactionTable->setItem(row, 3, new QTableWidgetItem(status));
+    }
+}
+
+QString ChainDetailScreen::addressAt(int index)
+{
+    // Addresses derived on an earlier run come from the store; the seed is
+    // only restored when a new index has to be derived
+    WalletStore *store = WalletStore::instance();
+    QString address = store ? store->address(chainSymbol, index) : QString();
+    if (!address.isEmpty()) {
+        return address;
+    }
+
+    if (!walletRestored) {
+        if (!wallet.restoreFromMnemonic(mnemonic)) {
+            qDebug() << "[ChainDetailScreen] ERROR: Failed to restore wallet from mnemonic";
+            return QString();
+        }
+        walletRestored = true;
+    }
+
+    address = wallet.deriveAddresses(chainSymbol, 0, index, 1).value(0);
+    if (store && !address.isEmpty()) {
+        store->putAddress(chainSymbol, index, address);
+    }
+    return address;
 }
 
 void ChainDetailScreen::scanAddressesWithBalance()
 {
-    if (!wallet.restoreFromMnemonic(mnemonic)) {
-        qDebug() << "[ChainDetailScreen] ERROR: Failed to restore wallet from mnemonic";
+    QString firstAddress = addressAt(0);
+    if (firstAddress.isEmpty()) {
         QMessageBox::critical(this, "오류", "지갑 복원 실패");
         totalBalanceLabel->setText("0.0 " + chainSymbol);
         return;
     }
     
-    qDebug() << "[ChainDetailScreen] Starting address scan for" << chainSymbol;
-    
-    totalBalanceLabel->setText("스캔 중...");
-    QApplication::processEvents();
-    
-    // Simplified scan - only check first 5 addresses to prevent crashes
-    const int MAX_SCAN = 5;
-    double totalBalance = 0.0;
-    int foundCount = 0;
-    
-    for (int i = 0; i < MAX_SCAN; i++) {
-        QString address = wallet.deriveAddress(chainSymbol, i);
-        
-        if (address.isEmpty()) {
-            qDebug() << "[ChainDetailScreen] WARNING: Failed to derive address at index" << i;
-            continue;
-        }
-        
-        qDebug() << "[ChainDetailScreen] Checking index" << i << ":" << address;
-        
-        // Get balance with error handling
-        QString balance = "0.0";
-        try {
-            balance = getBalance(address);
-        } catch (const std::exception &e) {
-            qDebug() << "[ChainDetailScreen] ERROR: Exception getting balance:" << e.what();
-        } catch (...) {
-            qDebug() << "[ChainDetailScreen] ERROR: Unknown exception getting balance";
-        }
-        
-        double balanceValue = balance.toDouble();
-        qDebug() << "[ChainDetailScreen] Balance for index" << i << ":" << balance;
-        
-        // Always add first address, and others if they have balance
-        if (i == 0 || balanceValue > 0.0) {
-            addAddressCard(i, address, balance);
-            totalBalance += balanceValue;
-            foundCount++;
-            
-            if (balanceValue > 0.0) {
-                qDebug() << "[ChainDetailScreen] Found address with balance at index" << i;
+    qDebug() << "[ChainDetailScreen] Starting address discovery for" << chainSymbol;
+
+    // Addresses known from an earlier run show up right away; discovery
+    // confirms them and adds anything new
+    scanning = true;
+    onAddressDiscovered(0, 0, firstAddress);
+    if (WalletStore *store = WalletStore::instance()) {
+        for (int change = 0; change <= 1; ++change) {
+            QMap<int, QString> known = store->addresses(chainSymbol, change);
+            for (auto it = known.constBegin(); it != known.constEnd(); ++it) {
+                onAddressDiscovered(change, it.key(), it.value());
             }
         }
-        
-        // Update UI periodically
-        QApplication::processEvents();
     }
-    
-    // Update total balance
-    totalBalanceLabel->setText(QString::number(totalBalance, 'f', 8) + " " + chainSymbol);
-    
-    qDebug() << "[ChainDetailScreen] Scan complete. Found" << foundCount << "addresses. Total balance:" << totalBalance;
+
+    discovery = new AddressDiscovery(chainSymbol, mnemonic, this);
+    connect(discovery, &AddressDiscovery::addressDiscovered,
+            this, &ChainDetailScreen::onAddressDiscovered);
+    connect(discovery, &AddressDiscovery::progress, this, [this](int scanned, int) {
+        scannedCount = scanned;
+        updateTotalBalance();
+    });
+    connect(discovery, &AddressDiscovery::finished, this,
+            [this](int nextReceive, int nextChange, bool complete) {
+        // An incomplete scan only raises the known indices; the next visit rescans
+        qDebug() << "[ChainDetailScreen] Discovery" << (complete ? "complete." : "stopped early.")
+                 << "Next receive index" << nextReceive << "next change index" << nextChange;
+        nextReceiveIndex = qMax(nextReceiveIndex, nextReceive);
+        scanning = false;
+        updateTotalBalance();
+        loadTransactionHistory();
+    });
+    discovery->start();
 }
 
-QString ChainDetailScreen::getBalance(const QString &address)
+void ChainDetailScreen::onAddressDiscovered(int change, int index, const QString &address)
 {
-    QString balance = "0.0";
-    
-    if (address.isEmpty()) {
-        qDebug() << "[ChainDetailScreen] ERROR: Empty address provided";
-        return balance;
-    }
-    
-    try {
-        if (chainSymbol == "BTC" || chainSymbol == "LTC" || chainSymbol == "DOGE") {
-            qDebug() << "[ChainDetailScreen] Getting BTC/LTC/DOGE balance for" << address;
-            BitcoinAdapter adapter("", false);
-            balance = adapter.getBalance(address);
-        } else if (chainSymbol == "ETH") {
-            qDebug() << "[ChainDetailScreen] Getting ETH balance for" << address;
-            EthereumAdapter adapter("");
-            balance = adapter.getBalance(address);
-        } else if (chainSymbol == "TRX") {
-            qDebug() << "[ChainDetailScreen] Getting TRX balance for" << address;
-            TronAdapter adapter("");
-            balance = adapter.getBalance(address);
-        } else if (chainSymbol == "SOL") {
-            qDebug() << "[ChainDetailScreen] Getting SOL balance for" << address;
-            SolanaAdapter adapter("");
-            balance = adapter.getBalance(address);
-        } else {
-            qDebug() << "[ChainDetailScreen] WARNING: Unknown chain symbol" << chainSymbol;
+    for (const AddressData &data : addresses) {
+        if (data.address == address) {
+            return;
         }
-        
-        // Validate balance
-        if (balance.isEmpty()) {
-            qDebug() << "[ChainDetailScreen] WARNING: Empty balance returned, defaulting to 0.0";
-            balance = "0.0";
-        }
-        
-    } catch (const std::exception &e) {
-        qDebug() << "[ChainDetailScreen] ERROR: Exception getting balance for" << address << ":" << e.what();
-        balance = "0.0";
-    } catch (...) {
-        qDebug() << "[ChainDetailScreen] ERROR: Unknown exception getting balance for" << address;
-        balance = "0.0";
     }
-    
-    return balance;
+
+    int position = addresses.size();
+    addAddressCard(index, address, "0.0", change != 0);
+    if (change == 0) {
+        nextReceiveIndex = qMax(nextReceiveIndex, index + 1);
+    }
+    updateBalance(position);
 }
 
 void ChainDetailScreen::onAddressCardClicked(int index)
@@ -554,7 +637,13 @@ void ChainDetailScreen::onAddressCardClicked(int index)
     msgBox.exec();
     
     if (msgBox.clickedButton() == sendBtn) {
-        SendTransactionDialog dialog(chainSymbol, addresses[index].address, mnemonic, this);
+        QString unsupported = WalletService::sendUnsupportedReason(chainSymbol, addresses[index].address);
+        if (!unsupported.isEmpty()) {
+            QMessageBox::information(this, "전송 불가", unsupported);
+            return;
+        }
+        SendTransactionDialog dialog(chainSymbol, addresses[index].address, addresses[index].index,
+                                     addresses[index].isChange, mnemonic, this);
         dialog.exec();
     } else if (msgBox.clickedButton() == receiveBtn) {
         QRCodeDialog dialog(addresses[index].address, chainSymbol, this);
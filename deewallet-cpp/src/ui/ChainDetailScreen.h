@@ -14,6 +14,8 @@
 #include <QVector>
 #include "../core/WalletCore.h"
 
+class AddressDiscovery;
+
 class ChainDetailScreen : public QWidget
 {
     Q_OBJECT
@@ -36,20 +38,33 @@ private slots:
     void onReceiveClicked();
     void onRefreshBalance();
     void onAddressCardClicked(int index);
+    void onBalanceUpdated(const QString &chain, const QString &address, const QString &balance);
+    void onAddressDiscovered(int change, int index, const QString &address);
 
 private:
     void setupUI();
     void loadAddresses();
     void scanAddressesWithBalance();
-    void addAddressCard(int index, const QString &address, const QString &balance);
+    void addAddressCard(int index, const QString &address, const QString &balance,
+                        bool isChange = false);
     void updateBalance(int index);
+    void applyBalance(int index, const QString &balance);
+    void updateTotalBalance();
     void loadTransactionHistory();
-    QString getBalance(const QString &address);
+    void showTransactions(const QString &emptyMessage);
+    QString addressAt(int index);
 
     QString chainName;
     QString chainSymbol;
     QString mnemonic;
     WalletCore wallet;
+    bool walletRestored;
+
+    // Gap-limit discovery state
+    AddressDiscovery *discovery;
+    bool scanning;
+    int scannedCount;
+    int nextReceiveIndex;
 
     // UI Components
     QWidget *addressListContainer;
@@ -65,6 +80,7 @@ private:
     // Address data
     struct AddressData {
         int index;
+        bool isChange;
         QString address;
         QString balance;
         QWidget *cardWidget;
@@ -8,6 +8,8 @@
 #include "ChainDetailScreen.h"
 #include "LoadingScreen.h"
 #include "../core/KeyfileManager.h"
+#include "../core/WalletStore.h"
+#include "../core/BalanceCache.h"
 #include <QVBoxLayout>
 #include <QTimer>
 #include <QMessageBox>
@@ -114,6 +116,11 @@ void MainWindow::showWelcomeScreen()
 
 void MainWindow::showWalletScreen(const QString &mnemonic)
 {
+    // Last-known state paints first; the screens then sync what changed
+    if (WalletStore::instance()->open(mnemonic)) {
+        BalanceCache::instance()->preload(WalletStore::instance()->balances());
+    }
+
     if (!walletDetailScreen) {
         walletDetailScreen = new WalletDetailScreen(mnemonic, this);
         connect(walletDetailScreen, &WalletDetailScreen::backToWelcome,
@@ -4,10 +4,8 @@
 
 #include "SendTransactionDialog.h"
 #include "../core/WalletCore.h"
-#include "../chains/BitcoinAdapter.h"
-#include "../chains/EthereumAdapter.h"
-#include "../chains/TronAdapter.h"
-#include "../chains/SolanaAdapter.h"
+#include "../core/WalletService.h"
+#include "../utils/AddressValidator.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -16,17 +14,19 @@
 
 SendTransactionDialog::SendTransactionDialog(const QString &chainType,
                                              const QString &fromAddress,
+                                             int addressIndex,
+                                             bool isChange,
                                              const QString &mnemonic,
                                              QWidget *parent)
     : QDialog(parent)
     , chainType(chainType)
     , fromAddress(fromAddress)
+    , addressIndex(addressIndex)
+    , isChange(isChange)
     , mnemonic(mnemonic)
-    , estimatedFee(0.0)
     , recipientInput(new QLineEdit(this))
     , amountInput(new QLineEdit(this))
     , maxButton(new QPushButton("MAX", this))
-    , feeSelector(new QComboBox(this))
     , feeLabel(new QLabel("Calculating...", this))
     , totalLabel(new QLabel("0.0", this))
     , balanceLabel(new QLabel("0.0", this))
@@ -34,10 +34,21 @@ SendTransactionDialog::SendTransactionDialog(const QString &chainType,
     , sendButton(new QPushButton("Send Transaction", this))
     , cancelButton(new QPushButton("Cancel", this))
     , addressBookButton(new QPushButton("📖 Address Book", this))
+    , feeKnown(false)
+    , feeRequest(0)
+    , feeTimer(new QTimer(this))
 {
     setWindowTitle("Send " + chainType);
     setupUI();
     onEstimateFee();
+
+    // Cached balance now, a fresh one when the background refetch lands
+    connect(WalletService::instance(), &WalletService::balanceUpdated,
+            this, &SendTransactionDialog::onBalanceUpdated);
+    QString balance = WalletService::instance()->balance(chainType, fromAddress);
+    if (!balance.isEmpty()) {
+        onBalanceUpdated(chainType, fromAddress, balance);
+    }
 }
 
 void SendTransactionDialog::setupUI()
@@ -102,26 +113,11 @@ void SendTransactionDialog::setupUI()
     amountLayout->addWidget(maxButton);
     mainLayout->addLayout(amountLayout);
 
-    // Fee selector
+    // Fee, as quoted by the network for this send
     auto *feeLabel2 = new QLabel("Transaction Fee:", this);
     feeLabel2->setStyleSheet("font-size: 14px; color: #cccccc;");
     mainLayout->addWidget(feeLabel2);
 
-    feeSelector->addItem("Slow (Low Fee)");
-    feeSelector->addItem("Normal (Recommended)");
-    feeSelector->addItem("Fast (High Fee)");
-    feeSelector->setCurrentIndex(1);
-    feeSelector->setStyleSheet(R"(
-        QComboBox {
-            background-color: #2a2a2a;
-            border: 2px solid #3a3a3a;
-            border-radius: 8px;
-            padding: 12px;
-            font-size: 14px;
-        }
-    )");
-    mainLayout->addWidget(feeSelector);
-
     feeLabel->setStyleSheet("font-size: 14px; color: #ffaa00;");
     mainLayout->addWidget(feeLabel);
 
@@ -167,8 +163,10 @@ void SendTransactionDialog::setupUI()
     connect(recipientInput, &QLineEdit::textChanged, this, &SendTransactionDialog::onRecipientChanged);
     connect(amountInput, &QLineEdit::textChanged, this, &SendTransactionDialog::onAmountChanged);
     connect(maxButton, &QPushButton::clicked, this, &SendTransactionDialog::onMaxClicked);
-    connect(feeSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &SendTransactionDialog::onEstimateFee);
+    // Re-quote once typing pauses rather than on every keystroke
+    feeTimer->setSingleShot(true);
+    feeTimer->setInterval(400);
+    connect(feeTimer, &QTimer::timeout, this, &SendTransactionDialog::onEstimateFee);
     connect(sendButton, &QPushButton::clicked, this, &SendTransactionDialog::onSendTransaction);
     connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
     connect(addressBookButton, &QPushButton::clicked, this, []() {
@@ -184,77 +182,109 @@ void SendTransactionDialog::setupUI()
 
 void SendTransactionDialog::onRecipientChanged()
 {
-    // Basic validation
+    // Checksum validation
     QString recipient = recipientInput->text();
     if (recipient.isEmpty()) return;
 
-    bool valid = false;
-    if (chainType == "BTC" && (recipient.startsWith("bc1") || recipient.startsWith("1") || recipient.startsWith("3"))) {
-        valid = true;
-    } else if (chainType == "ETH" && recipient.startsWith("0x") && recipient.length() == 42) {
-        valid = true;
-    } else if (chainType == "TRX" && recipient.startsWith("T") && recipient.length() == 34) {
-        valid = true;
-    } else if (chainType == "SOL" && recipient.length() >= 32 && recipient.length() <= 44) {
-        valid = true;
-    }
+    bool valid = AddressValidator::validate(chainType, recipient);
 
     recipientInput->setStyleSheet(valid ?
         "QLineEdit { background-color: #2a2a2a; border: 2px solid #00ff00; border-radius: 8px; padding: 12px; }" :
         "QLineEdit { background-color: #2a2a2a; border: 2px solid #ff0000; border-radius: 8px; padding: 12px; }");
+
+    // The recipient's script type changes the transaction size
+    if (valid) {
+        feeTimer->start();
+    }
 }
 
 void SendTransactionDialog::onAmountChanged()
 {
     updateFeeEstimate();
+    feeTimer->start();
+}
+
+void SendTransactionDialog::onBalanceUpdated(const QString &chain, const QString &address,
+                                             const QString &balance)
+{
+    if (chain != chainType || address != fromAddress) {
+        return;
+    }
+
+    currentBalance = balance;
+    balanceLabel->setText("Balance: " + balance + " " + chainType);
+}
+
+QString SendTransactionDialog::feeRecipient() const
+{
+    // Until a valid recipient is entered, quote a payment back to ourselves
+    QString recipient = recipientInput->text();
+    return AddressValidator::validate(chainType, recipient) ? recipient : fromAddress;
 }
 
 void SendTransactionDialog::onMaxClicked()
 {
-    // TODO: Get actual balance and subtract fee
-    amountInput->setText(currentBalance);
-    updateFeeEstimate();
+    // An empty amount asks the adapter for the fee of sending everything
+    maxButton->setEnabled(false);
+    WalletService::instance()->estimateFee(chainType, fromAddress, feeRecipient(), QString())
+        .then(this, [this](const QString &fee) {
+            maxButton->setEnabled(true);
+
+            bool feeOk = false;
+            bool balanceOk = false;
+            Amount feeAmount = Amount::parse(fee, -1, &feeOk);
+            Amount balance = Amount::parse(currentBalance, -1, &balanceOk);
+            if (fee.isEmpty() || !feeOk || !balanceOk) {
+                QMessageBox::warning(this, "Error", "Could not get a fee quote from the network.");
+                return;
+            }
+            if (balance <= feeAmount) {
+                QMessageBox::warning(this, "Error", "The balance does not cover the network fee.");
+                return;
+            }
+            amountInput->setText((balance - feeAmount).toString());
+        });
 }
 
 void SendTransactionDialog::onEstimateFee()
 {
-    // Estimate fee based on chain and fee level
-    int feeLevel = feeSelector->currentIndex();
-
-    if (chainType == "BTC") {
-        // Bitcoin: sat/vB
-        double feeRates[] = {1.0, 5.0, 10.0};  // sat/vB
-        double txSize = 250;  // Approximate SegWit tx size
-        estimatedFee = (feeRates[feeLevel] * txSize) / 100000000.0;  // Convert to BTC
-        feeLabel->setText(QString("Fee: %1 BTC (~%2 sat/vB)")
-            .arg(estimatedFee, 0, 'f', 8)
-            .arg(feeRates[feeLevel]));
-    } else if (chainType == "ETH") {
-        // Ethereum: Gwei
-        double gasPrice[] = {10.0, 20.0, 40.0};  // Gwei
-        double gasLimit = 21000;  // Standard transfer
-        estimatedFee = (gasPrice[feeLevel] * gasLimit) / 1e9;  // Convert to ETH
-        feeLabel->setText(QString("Fee: %1 ETH (~%2 Gwei)")
-            .arg(estimatedFee, 0, 'f', 6)
-            .arg(gasPrice[feeLevel]));
-    } else if (chainType == "TRX") {
-        // Tron: Bandwidth/Energy
-        estimatedFee = 0.0;  // Usually free with bandwidth
-        feeLabel->setText("Fee: ~0 TRX (using bandwidth)");
-    } else if (chainType == "SOL") {
-        // Solana: Lamports
-        estimatedFee = 0.000005;  // 5000 lamports
-        feeLabel->setText(QString("Fee: %1 SOL (5000 lamports)").arg(estimatedFee, 0, 'f', 6));
+    // The same adapter call, UTXOs and fee rate the send itself will use
+    quint64 request = ++feeRequest;
+    bool ok = false;
+    QString amount = amountInput->text();
+    if (Amount::parse(amount, -1, &ok).isZero() || !ok) {
+        estimatedFee = Amount();
+        feeKnown = false;
+        feeLabel->setText("Fee: enter an amount");
+        updateFeeEstimate();
+        return;
     }
 
-    updateFeeEstimate();
+    feeKnown = false;
+    feeLabel->setText("Calculating...");
+    WalletService::instance()->estimateFee(chainType, fromAddress, feeRecipient(), amount)
+        .then(this, [this, request](const QString &fee) {
+            if (request != feeRequest) {
+                return;
+            }
+            bool ok = false;
+            estimatedFee = Amount::parse(fee, -1, &ok);
+            feeKnown = !fee.isEmpty() && ok;
+            if (!feeKnown) {
+                estimatedFee = Amount();
+            }
+            feeLabel->setText(feeKnown ? QString("Fee: %1 %2").arg(estimatedFee.toString()).arg(chainType)
+                                       : QString("Fee: unavailable (insufficient funds or no quote)"));
+            updateFeeEstimate();
+        });
 }
 
 void SendTransactionDialog::updateFeeEstimate()
 {
-    double amount = amountInput->text().toDouble();
-    double total = amount + estimatedFee;
-    totalLabel->setText(QString("%1 %2").arg(total, 0, 'f', 8).arg(chainType));
+    bool ok = false;
+    Amount amount = Amount::parse(amountInput->text(), -1, &ok);
+    Amount total = (ok ? amount : Amount()) + estimatedFee;
+    totalLabel->setText(QString("%1 %2").arg(total.toString(8)).arg(chainType));
 }
 
 bool SendTransactionDialog::validateInputs()
@@ -267,90 +297,61 @@ bool SendTransactionDialog::validateInputs()
         return false;
     }
 
-    if (amount.isEmpty() || amount.toDouble() <= 0) {
+    bool amountOk = false;
+    if (Amount::parse(amount, -1, &amountOk).isZero() || !amountOk) {
         QMessageBox::warning(this, "Error", "Please enter a valid amount.");
         return false;
     }
 
-    // Validate address format
+    // Validate address format and checksum
     onRecipientChanged();
+    if (!AddressValidator::validate(chainType, recipient)) {
+        QMessageBox::warning(this, "Error", "Invalid recipient address for " + chainType + ".");
+        return false;
+    }
 
     return true;
 }
 
-QString SendTransactionDialog::signAndBroadcast()
+void SendTransactionDialog::signAndBroadcast()
 {
-    if (!validateInputs()) {
-        return QString();
-    }
-
-    try {
-        // Restore wallet from mnemonic
-        WalletCore wallet;
-        if (!wallet.restoreFromMnemonic(mnemonic)) {
-            QMessageBox::critical(this, "Error", "Failed to restore wallet.");
-            return QString();
+    WalletService::SendRequest request;
+    request.chain = chainType;
+    request.mnemonic = mnemonic;
+    // The key of the address this dialog was opened for, not always index 0
+    request.derivationPath = WalletCore::derivationPath(chainType, isChange ? 1 : 0, addressIndex);
+    request.from = fromAddress;
+    request.to = recipientInput->text();
+    request.amount = amountInput->text();
+    // No gasPrice: the adapter applies the same network fee it quoted
+
+    // Signing and broadcasting run on a worker thread; the dialog stays responsive
+    WalletService::instance()->send(request).then(this, [this](const WalletService::SendResult &result) {
+        sendButton->setEnabled(true);
+        sendButton->setText("Send Transaction");
+        cancelButton->setEnabled(true);
+
+        if (result.txHash.isEmpty()) {
+            QMessageBox::critical(this, "Error", result.error);
+            return;
         }
 
-        QString recipient = recipientInput->text();
-        QString amount = amountInput->text();
-        QString txHash;
-
-        if (chainType == "BTC") {
-            BitcoinAdapter adapter("", false);
-
-            // Get private key
-            QString path = "m/44'/0'/0'/0/0";
-            QByteArray privateKey = wallet.derivePrivateKey(path);
-
-            // Create, sign, and broadcast transaction
-            QString rawTx = adapter.createTransaction(fromAddress, recipient, amount, "");
-            QString signedTx = adapter.signTransaction(rawTx, privateKey);
-            txHash = adapter.broadcastTransaction(signedTx);
-
-        } else if (chainType == "ETH") {
-            EthereumAdapter adapter("");
-
-            QString path = "m/44'/60'/0'/0/0";
-            QByteArray privateKey = wallet.derivePrivateKey(path);
-
-            QString gasPrice = QString::number(estimatedFee * 1e9 / 21000, 'f', 0);
-            QString rawTx = adapter.createTransaction(fromAddress, recipient, amount, gasPrice);
-            QString signedTx = adapter.signTransaction(rawTx, privateKey);
-            txHash = adapter.broadcastTransaction(signedTx);
-
-        } else if (chainType == "TRX") {
-            TronAdapter adapter("");
-
-            QString path = "m/44'/195'/0'/0/0";
-            QByteArray privateKey = wallet.derivePrivateKey(path);
-
-            QString rawTx = adapter.createTransaction(fromAddress, recipient, amount, "");
-            QString signedTx = adapter.signTransaction(rawTx, privateKey);
-            txHash = adapter.broadcastTransaction(signedTx);
-
-        } else if (chainType == "SOL") {
-            SolanaAdapter adapter("");
-
-            QString path = "m/44'/501'/0'/0/0";
-            QByteArray privateKey = wallet.derivePrivateKey(path);
-
-            QString rawTx = adapter.createTransaction(fromAddress, recipient, amount, "");
-            QString signedTx = adapter.signTransaction(rawTx, privateKey);
-            txHash = adapter.broadcastTransaction(signedTx);
-        }
-
-        return txHash;
-
-    } catch (const std::exception &e) {
-        QMessageBox::critical(this, "Error",
-            QString("Transaction failed:\n%1").arg(e.what()));
-        return QString();
-    }
+        QMessageBox::information(this, "Success",
+            QString("Transaction sent successfully!\n\nTransaction Hash:\n%1\n\n"
+                    "It may take a few minutes to confirm on the blockchain.")
+            .arg(result.txHash));
+        accept();
+    });
 }
 
 void SendTransactionDialog::onSendTransaction()
 {
+    // The confirmation shows the quoted fee, so there has to be one
+    if (!feeKnown) {
+        QMessageBox::warning(this, "Error", "Wait for the network fee quote before sending.");
+        return;
+    }
+
     // Confirmation dialog
     QString recipient = recipientInput->text();
     QString amount = amountInput->text();
@@ -360,28 +361,18 @@ void SendTransactionDialog::onSendTransaction()
             .arg(amount)
             .arg(chainType)
             .arg(recipient)
-            .arg(estimatedFee, 0, 'f', 8)
-            .arg(amount.toDouble() + estimatedFee, 0, 'f', 8),
+            .arg(estimatedFee.toString())
+            .arg((Amount::parse(amount) + estimatedFee).toString()),
         QMessageBox::Yes | QMessageBox::No);
 
-    if (confirm != QMessageBox::Yes) {
+    if (confirm != QMessageBox::Yes || !validateInputs()) {
         return;
     }
 
-    // Disable button during processing
+    // Disable buttons during processing; re-enabled when the send completes
     sendButton->setEnabled(false);
     sendButton->setText("Sending...");
+    cancelButton->setEnabled(false);
 
-    QString txHash = signAndBroadcast();
-
-    sendButton->setEnabled(true);
-    sendButton->setText("Send Transaction");
-
-    if (!txHash.isEmpty()) {
-        QMessageBox::information(this, "Success",
-            QString("Transaction sent successfully!\n\nTransaction Hash:\n%1\n\n"
-                    "It may take a few minutes to confirm on the blockchain.")
-            .arg(txHash));
-        accept();
-    }
+    signAndBroadcast();
 }
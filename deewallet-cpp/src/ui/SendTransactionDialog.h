@@ -8,18 +8,22 @@
 
 #include <QDialog>
 #include <QLineEdit>
-#include <QComboBox>
 #include <QPushButton>
 #include <QLabel>
 #include <QTextEdit>
+#include <QTimer>
+#include "../utils/Amount.h"
 
 class SendTransactionDialog : public QDialog
 {
     Q_OBJECT
 
 public:
+    // addressIndex and isChange locate fromAddress's key (see WalletCore::derivationPath)
     explicit SendTransactionDialog(const QString &chainType,
                                    const QString &fromAddress,
+                                   int addressIndex,
+                                   bool isChange,
                                    const QString &mnemonic,
                                    QWidget *parent = nullptr);
 
@@ -29,22 +33,25 @@ private slots:
     void onMaxClicked();
     void onEstimateFee();
     void onSendTransaction();
+    void onBalanceUpdated(const QString &chain, const QString &address, const QString &balance);
 
 private:
     void setupUI();
     void updateFeeEstimate();
+    QString feeRecipient() const;
     bool validateInputs();
-    QString signAndBroadcast();
+    void signAndBroadcast();
 
     QString chainType;
     QString fromAddress;
+    int addressIndex;
+    bool isChange;
     QString mnemonic;
     QString currentBalance;
 
     QLineEdit *recipientInput;
     QLineEdit *amountInput;
     QPushButton *maxButton;
-    QComboBox *feeSelector;
     QLabel *feeLabel;
     QLabel *totalLabel;
     QLabel *balanceLabel;
@@ -53,7 +60,12 @@ private:
     QPushButton *cancelButton;
     QPushButton *addressBookButton;
 
-    double estimatedFee;
+    // The adapter's fee for the current recipient and amount; replies to
+    // requests older than feeRequest are ignored
+    Amount estimatedFee;
+    bool feeKnown;
+    quint64 feeRequest;
+    QTimer *feeTimer;
 };
 
 #endif // SENDTRANSACTIONDIALOG_H
@@ -488,6 +488,24 @@ public:
             .arg(DesignTokens::Colors::BRAND_PRIMARY);
     }
 
+    /**
+     * Balance that missed the last refresh (last known value)
+     */
+    static QString staleBalanceLabel() {
+        return QString(R"(
+            QLabel {
+                background: transparent;
+                font-size: %1px;
+                font-weight: %2;
+                color: %3;
+                border: none;
+            }
+        )")
+            .arg(DesignTokens::Typography::FONT_SIZE_XL)
+            .arg(DesignTokens::Typography::FONT_WEIGHT_BOLD)
+            .arg(DesignTokens::Colors::TEXT_MUTED);
+    }
+
     // ========================================================================
     // SCROLL AREAS
     // ========================================================================
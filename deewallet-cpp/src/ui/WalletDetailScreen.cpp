@@ -8,10 +8,9 @@
 #include "AddressBookDialog.h"
 #include "StyleHelper.h"
 #include "DesignTokens.h"
-#include "../chains/BitcoinAdapter.h"
-#include "../chains/EthereumAdapter.h"
-#include "../chains/TronAdapter.h"
-#include "../chains/SolanaAdapter.h"
+#include "../core/WalletStore.h"
+#include "../core/WalletService.h"
+#include "../utils/Amount.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -27,9 +26,20 @@ WalletDetailScreen::WalletDetailScreen(const QString &mnemonic, QWidget *parent)
     , chainListLayout(new QVBoxLayout(chainListContainer))
     , refreshButton(new QPushButton("새로고침", this))
     , backButton(new QPushButton("← 뒤로", this))
+    , refresher(new PortfolioRefresher(this))
+    , manualRefresh(false)
 {
     setupUI();
     loadWallet();
+
+    connect(WalletService::instance(), &WalletService::balanceUpdated,
+            this, &WalletDetailScreen::onBalanceUpdated);
+    connect(refresher, &PortfolioRefresher::balanceReady,
+            this, &WalletDetailScreen::onBalanceUpdated);
+    connect(refresher, &PortfolioRefresher::chainStale,
+            this, &WalletDetailScreen::onChainStale);
+    connect(refresher, &PortfolioRefresher::finished,
+            this, &WalletDetailScreen::onRefreshFinished);
     refreshBalances();
 }
 
@@ -176,98 +186,141 @@ void WalletDetailScreen::setupUI()
 
 void WalletDetailScreen::loadWallet()
 {
+    // Reuse addresses derived on an earlier run; restoring the seed is the slow part
+    WalletStore *store = WalletStore::instance();
+    bool allStored = store && store->isOpen();
+    for (int i = 0; allStored && i < chains.size(); ++i) {
+        chains[i].address = store->address(chains[i].symbol, 0);
+        allStored = !chains[i].address.isEmpty();
+    }
+    if (allStored) {
+        return;
+    }
+
     if (!wallet.restoreFromMnemonic(mnemonic)) {
         QMessageBox::critical(this, "오류", "복구 문구에서 지갑을 복원하지 못했습니다.");
         return;
     }
 
-    // Generate addresses for all chains (index 0 only, user can add more)
-    chains[0].address = wallet.deriveAddress("BTC", 0);  // Bitcoin
-    chains[1].address = wallet.deriveAddress("ETH", 0);  // Ethereum
-    chains[2].address = wallet.deriveAddress("TRX", 0);  // Tron
-    chains[3].address = wallet.deriveAddress("SOL", 0);  // Solana
-    chains[4].address = wallet.deriveAddress("LTC", 0);  // Litecoin
-    chains[5].address = wallet.deriveAddress("DOGE", 0); // Dogecoin
+    // Generate addresses for all chains (index 0 only, user can add more);
+    // EVM chains share the Ethereum address
+    for (ChainData &chain : chains) {
+        chain.address = wallet.deriveAddress(chain.symbol, 0);
+    }
+
+    if (store) {
+        for (const ChainData &chain : chains) {
+            if (!chain.address.isEmpty()) {
+                store->putAddress(chain.symbol, 0, chain.address);
+            }
+        }
+    }
 }
 
-void WalletDetailScreen::refreshBalances()
+void WalletDetailScreen::refreshBalances(bool force)
 {
-    // Fetch real balances from blockchain APIs
-    for (int i = 0; i < chains.size(); ++i) {
-        QString balance = "0.0";
-
-        try {
-            if (i == 0) {
-                // Bitcoin
-                BitcoinAdapter adapter("", false);
-                balance = adapter.getBalance(chains[i].address);
-            } else if (i == 1) {
-                // Ethereum
-                EthereumAdapter adapter("");
-                balance = adapter.getBalance(chains[i].address);
-            } else if (i == 2) {
-                // Tron
-                TronAdapter adapter("");
-                balance = adapter.getBalance(chains[i].address);
-            } else if (i == 3) {
-                // Solana
-                SolanaAdapter adapter("");
-                balance = adapter.getBalance(chains[i].address);
-            } else if (i == 4) {
-                // Litecoin - use Bitcoin adapter (same format)
-                BitcoinAdapter adapter("", false);
-                balance = adapter.getBalance(chains[i].address);
-            } else if (i == 5) {
-                // Dogecoin - use Bitcoin adapter (same format)
-                BitcoinAdapter adapter("", false);
-                balance = adapter.getBalance(chains[i].address);
+    // Every chain and every known address at once; cached values render
+    // immediately and each card updates as its results land
+    WalletStore *store = WalletStore::instance();
+    QVector<PortfolioRefresher::Target> targets;
+    for (ChainData &chain : chains) {
+        QStringList addressList = {chain.address};
+        if (store && store->isOpen()) {
+            addressList += store->addresses(chain.symbol, 0).values();
+            if (WalletCore::usesChangeAddresses(chain.symbol)) {
+                addressList += store->addresses(chain.symbol, 1).values();
             }
+        }
+        addressList.removeDuplicates();
 
-            chains[i].balance = balance;
-            if (chains[i].balanceLabel) {
-                chains[i].balanceLabel->setText(balance + " " + chains[i].symbol);
-            }
-        } catch (...) {
-            // If balance query fails, keep showing 0.0
-            chains[i].balance = "0.0";
-            if (chains[i].balanceLabel) {
-                chains[i].balanceLabel->setText("0.0 " + chains[i].symbol);
+        for (const QString &address : addressList) {
+            if (!address.isEmpty()) {
+                chain.addressBalances.insert(address, chain.addressBalances.value(address, "0.0"));
+                targets.append({chain.symbol, address});
             }
         }
+
+        // Push-capable chains then refresh only when something changes
+        WalletService::instance()->watch(chain.symbol, addressList);
     }
+
+    refresher->start(targets, force);
 }
 
-void WalletDetailScreen::updateChainCard(int index, const QString &chain, const QString &address, const QString &balance)
+void WalletDetailScreen::onBalanceUpdated(const QString &chain, const QString &address,
+                                          const QString &balance)
 {
-    if (index >= 0 && index < chains.size()) {
-        chains[index].address = address;
-        chains[index].balance = balance;
-
-        if (chains[index].balanceLabel) {
-            chains[index].balanceLabel->setText(balance + " " + chains[index].symbol);
+    for (int i = 0; i < chains.size(); ++i) {
+        if (chains[i].symbol == chain && chains[i].addressBalances.contains(address)) {
+            chains[i].addressBalances[address] = balance;
+            chains[i].stale = false;
+            updateChainCard(i);
         }
     }
 }
 
-void WalletDetailScreen::onRefreshBalances()
+void WalletDetailScreen::onChainStale(const QString &chain)
 {
-    // Show loading indicator
-    refreshButton->setEnabled(false);
-    refreshButton->setText("새로고침 중...");
-
-    refreshBalances();
+    for (int i = 0; i < chains.size(); ++i) {
+        if (chains[i].symbol == chain) {
+            chains[i].stale = true;
+            updateChainCard(i);
+        }
+    }
+}
 
+void WalletDetailScreen::onRefreshFinished(bool complete)
+{
     refreshButton->setEnabled(true);
     refreshButton->setText("새로고침");
 
-    QString message = "잔액을 갱신했습니다!\n\n";
+    if (!manualRefresh) {
+        return;
+    }
+    manualRefresh = false;
+
+    QString message = complete ? "잔액을 갱신했습니다!\n\n"
+                               : "일부 체인이 응답하지 않아 이전 잔액을 표시합니다.\n\n";
     for (int i = 0; i < chains.size(); ++i) {
-        message += chains[i].name + ": " + chains[i].balance + " " + chains[i].symbol + "\n";
+        message += chains[i].name + ": " + chains[i].balance + " " + chains[i].symbol;
+        message += chains[i].stale ? " (지연)\n" : "\n";
     }
-    
+
     QMessageBox::information(this, "완료", message);
 }
 
+void WalletDetailScreen::updateChainCard(int index)
+{
+    if (index < 0 || index >= chains.size()) {
+        return;
+    }
+
+    ChainData &chain = chains[index];
+    // Exact sum; the 8-digit cut only happens for display
+    Amount total;
+    for (const QString &balance : chain.addressBalances) {
+        total += Amount::parse(balance);
+    }
+    chain.balance = total.toString(8);
+
+    if (chain.balanceLabel) {
+        chain.balanceLabel->setText(chain.balance + " " + chain.symbol);
+        chain.balanceLabel->setStyleSheet(chain.stale ? StyleHelper::staleBalanceLabel()
+                                                      : StyleHelper::balanceLabel());
+        chain.balanceLabel->setToolTip(chain.stale ? "응답 지연 - 마지막으로 확인된 잔액" : QString());
+    }
+}
+
+void WalletDetailScreen::onRefreshBalances()
+{
+    // Show loading indicator; onRefreshFinished restores it
+    refreshButton->setEnabled(false);
+    refreshButton->setText("새로고침 중...");
+
+    manualRefresh = true;
+    refreshBalances(true);
+}
+
 
 void WalletDetailScreen::onCopyAddress(const QString &address)
 {
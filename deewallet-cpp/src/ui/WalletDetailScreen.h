@@ -14,6 +14,7 @@
 #include <QObject>
 #include <QEvent>
 #include "../core/WalletCore.h"
+#include "../core/PortfolioRefresher.h"
 
 class WalletDetailScreen : public QWidget
 {
@@ -33,12 +34,15 @@ private slots:
     void onCopyAddress(const QString &address);
     void onBackClicked();
     void onChainCardClicked(int chainIndex);
+    void onBalanceUpdated(const QString &chain, const QString &address, const QString &balance);
+    void onChainStale(const QString &chain);
+    void onRefreshFinished(bool complete);
 
 private:
     void setupUI();
     void loadWallet();
-    void refreshBalances();
-    void updateChainCard(int index, const QString &chain, const QString &address, const QString &balance);
+    void refreshBalances(bool force = false);
+    void updateChainCard(int index);
 
     QString mnemonic;
     QString keyfilePath;
@@ -50,6 +54,8 @@ private:
     QVBoxLayout *chainListLayout;
     QPushButton *refreshButton;
     QPushButton *backButton;
+    PortfolioRefresher *refresher;
+    bool manualRefresh;
 
     // Chain data
     struct ChainData {
@@ -59,6 +65,8 @@ private:
         QString balance;
         QWidget *cardWidget;
         QLabel *balanceLabel;
+        QHash<QString, QString> addressBalances;   // every known address
+        bool stale = false;                        // missed the last refresh deadline
     };
 
     QVector<ChainData> chains;
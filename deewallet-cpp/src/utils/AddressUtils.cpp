@@ -3,14 +3,28 @@
  */
 
 #include "AddressUtils.h"
+#include "Keccak256.h"
 #include <openssl/sha.h>
 #include <openssl/ripemd.h>
 #include <QVector>
 #include <algorithm>
+#include <cstring>
 
 const char* AddressUtils::BASE58_ALPHABET = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
 const char* AddressUtils::BECH32_CHARSET = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
 
+// Reverse lookup for BASE58_ALPHABET (-1 = invalid)
+const int8_t AddressUtils::BASE58_ALPHABET_REV[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1,
+    -1,  9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+    22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+    -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1
+};
+
 // Base58 Encoding
 QString AddressUtils::encodeBase58(const QByteArray &data)
 {
@@ -61,45 +75,70 @@ QByteArray AddressUtils::decodeBase58(const QString &encoded)
         return QByteArray();
     }
 
+    char input[BASE58_MAX_LENGTH];
+    int inputLen = toAscii(encoded, input, BASE58_MAX_LENGTH);
+    if (inputLen < 0) {
+        return QByteArray();
+    }
+
+    uint8_t output[BASE58_MAX_LENGTH];
+    int outputLen = decodeBase58(input, inputLen, output, BASE58_MAX_LENGTH);
+    if (outputLen < 0) {
+        return QByteArray(); // Invalid character
+    }
+
+    return QByteArray(reinterpret_cast<const char*>(output), outputLen);
+}
+
+int AddressUtils::decodeBase58(const char *input, int inputLen, uint8_t *output, int outputMax)
+{
+    if (inputLen < 0 || inputLen > BASE58_MAX_LENGTH) {
+        return -1;
+    }
+
     // Count leading '1's
     int leadingZeros = 0;
-    for (int i = 0; i < encoded.length() && encoded[i] == '1'; ++i) {
+    while (leadingZeros < inputLen && input[leadingZeros] == '1') {
         leadingZeros++;
     }
 
-    // Decode
-    QVector<uint8_t> result((encoded.length() * 733 / 1000) + 1);
-    int resultLen = 1;
+    // Big-endian base256 accumulator (log(58) / log(256) ~= 0.733)
+    uint8_t b256[BASE58_MAX_LENGTH];
+    const int size = (inputLen - leadingZeros) * 733 / 1000 + 1;
+    std::memset(b256, 0, size);
+    int length = 0;
 
-    for (int i = 0; i < encoded.length(); ++i) {
-        int carry = QString(BASE58_ALPHABET).indexOf(encoded[i]);
+    for (int i = leadingZeros; i < inputLen; ++i) {
+        unsigned char c = static_cast<unsigned char>(input[i]);
+        int carry = c < 128 ? BASE58_ALPHABET_REV[c] : -1;
         if (carry < 0) {
-            return QByteArray(); // Invalid character
-        }
-
-        for (int j = 0; j < resultLen; ++j) {
-            carry += static_cast<int>(result[j]) * 58;
-            result[j] = static_cast<uint8_t>(carry & 0xff);
-            carry >>= 8;
+            return -1; // Invalid character
         }
 
-        while (carry > 0) {
-            result[resultLen++] = static_cast<uint8_t>(carry & 0xff);
+        int k = 0;
+        for (int j = size - 1; (carry != 0 || k < length) && j >= 0; --j, ++k) {
+            carry += 58 * b256[j];
+            b256[j] = static_cast<uint8_t>(carry & 0xff);
             carry >>= 8;
         }
+        length = k;
     }
 
-    // Build output
-    QByteArray output;
-    for (int i = 0; i < leadingZeros; ++i) {
-        output.append('\x00');
+    // Skip leading zeros of the accumulator
+    int start = size - length;
+    while (start < size && b256[start] == 0) {
+        start++;
     }
 
-    for (int i = resultLen - 1; i >= 0; --i) {
-        output.append(static_cast<char>(result[i]));
+    int outputLen = leadingZeros + (size - start);
+    if (outputLen > outputMax) {
+        return -1;
     }
 
-    return output;
+    std::memset(output, 0, leadingZeros);
+    std::memcpy(output + leadingZeros, b256 + start, size - start);
+
+    return outputLen;
 }
 
 // Base58Check Encoding
@@ -138,96 +177,337 @@ QByteArray AddressUtils::decodeBase58Check(const QString &encoded)
     return payload.mid(1);
 }
 
-// Bech32 Encoding
-uint32_t AddressUtils::bech32Polymod(const QVector<uint8_t> &values)
+// Bech32 Encoding (BIP173 / BIP350)
+
+// Generator XOR for each combination of the 5 bits shifted out per step
+const uint32_t AddressUtils::BECH32_GENERATOR_TABLE[32] = {
+    0x00000000, 0x3b6a57b2, 0x26508e6d, 0x1d3ad9df,
+    0x1ea119fa, 0x25cb4e48, 0x38f19797, 0x039bc025,
+    0x3d4233dd, 0x0628646f, 0x1b12bdb0, 0x2078ea02,
+    0x23e32a27, 0x18897d95, 0x05b3a44a, 0x3ed9f3f8,
+    0x2a1462b3, 0x117e3501, 0x0c44ecde, 0x372ebb6c,
+    0x34b57b49, 0x0fdf2cfb, 0x12e5f524, 0x298fa296,
+    0x1756516e, 0x2c3c06dc, 0x3106df03, 0x0a6c88b1,
+    0x09f74894, 0x329d1f26, 0x2fa7c6f9, 0x14cd914b
+};
+
+// Reverse lookup for BECH32_CHARSET (case-insensitive, -1 = invalid)
+const int8_t AddressUtils::BECH32_CHARSET_REV[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    15, -1, 10, 17, 21, 20, 26, 30,  7,  5, -1, -1, -1, -1, -1, -1,
+    -1, 29, -1, 24, 13, 25,  9,  8, 23, -1, 18, 22, 31, 27, 19, -1,
+     1,  0,  3, 16, 11, 28, 12, 14,  6,  4,  2, -1, -1, -1, -1, -1,
+    -1, 29, -1, 24, 13, 25,  9,  8, 23, -1, 18, 22, 31, 27, 19, -1,
+     1,  0,  3, 16, 11, 28, 12, 14,  6,  4,  2, -1, -1, -1, -1, -1
+};
+
+uint32_t AddressUtils::bech32PolymodStep(uint32_t chk, uint8_t value)
 {
+    uint32_t top = chk >> 25;
+    return ((chk & 0x1ffffff) << 5) ^ value ^ BECH32_GENERATOR_TABLE[top];
+}
+
+uint32_t AddressUtils::bech32HrpPolymod(const char *hrp, int hrpLen)
+{
+    // Equivalent to feeding hrpExpand(hrp) through the polymod
     uint32_t chk = 1;
-    for (uint8_t value : values) {
-        uint32_t top = chk >> 25;
-        chk = (chk & 0x1ffffff) << 5 ^ value;
-        if (top & 1)  chk ^= 0x3b6a57b2;
-        if (top & 2)  chk ^= 0x26508e6d;
-        if (top & 4)  chk ^= 0x1ea119fa;
-        if (top & 8)  chk ^= 0x3d4233dd;
-        if (top & 16) chk ^= 0x2a1462b3;
+    for (int i = 0; i < hrpLen; ++i) {
+        chk = bech32PolymodStep(chk, static_cast<uint8_t>(hrp[i]) >> 5);
+    }
+    chk = bech32PolymodStep(chk, 0);
+    for (int i = 0; i < hrpLen; ++i) {
+        chk = bech32PolymodStep(chk, static_cast<uint8_t>(hrp[i]) & 31);
     }
     return chk;
 }
 
-QVector<uint8_t> AddressUtils::bech32HrpExpand(const QString &hrp)
+uint32_t AddressUtils::bech32Constant(Bech32Encoding encoding)
 {
-    QVector<uint8_t> result;
-    for (QChar c : hrp) {
-        result.append(c.toLatin1() >> 5);
-    }
-    result.append(0);
-    for (QChar c : hrp) {
-        result.append(c.toLatin1() & 31);
-    }
-    return result;
+    return encoding == Bech32Encoding::Bech32m ? 0x2bc830a3 : 1;
 }
 
-QVector<uint8_t> AddressUtils::convertBits(const QByteArray &data, int fromBits, int toBits, bool pad)
+bool AddressUtils::convertBits(const uint8_t *in, int inLen, int fromBits, int toBits,
+                               bool pad, uint8_t *out, int &outLen)
 {
-    QVector<uint8_t> result;
-    int acc = 0;
+    uint32_t acc = 0;
     int bits = 0;
-    int maxv = (1 << toBits) - 1;
+    const uint32_t maxv = (1u << toBits) - 1;
+    const uint32_t maxAcc = (1u << (fromBits + toBits - 1)) - 1;
+    outLen = 0;
 
-    for (unsigned char byte : data) {
-        acc = (acc << fromBits) | byte;
+    for (int i = 0; i < inLen; ++i) {
+        if (in[i] >> fromBits) {
+            return false;
+        }
+        acc = ((acc << fromBits) | in[i]) & maxAcc;
         bits += fromBits;
         while (bits >= toBits) {
             bits -= toBits;
-            result.append((acc >> bits) & maxv);
+            out[outLen++] = static_cast<uint8_t>((acc >> bits) & maxv);
         }
     }
 
     if (pad) {
         if (bits > 0) {
-            result.append((acc << (toBits - bits)) & maxv);
+            out[outLen++] = static_cast<uint8_t>((acc << (toBits - bits)) & maxv);
         }
     } else if (bits >= fromBits || ((acc << (toBits - bits)) & maxv)) {
-        return QVector<uint8_t>(); // Invalid padding
+        return false; // Invalid padding
     }
 
-    return result;
+    return true;
 }
 
-QString AddressUtils::encodeBech32(const QString &hrp, const QByteArray &data)
+int AddressUtils::toAscii(const QString &str, char *out, int maxLen)
 {
-    // Convert witness version (0) and program
-    QVector<uint8_t> values;
-    values.append(0); // Witness version 0 (P2WPKH)
-
-    QVector<uint8_t> converted = convertBits(data, 8, 5, true);
-    values.append(converted);
+    if (str.length() > maxLen) {
+        return -1;
+    }
+    for (int i = 0; i < str.length(); ++i) {
+        ushort c = str[i].unicode();
+        if (c > 0x7f) {
+            return -1;
+        }
+        out[i] = static_cast<char>(c);
+    }
+    return str.length();
+}
 
-    // Calculate checksum
-    QVector<uint8_t> polymodInput = bech32HrpExpand(hrp);
-    polymodInput.append(values);
-    polymodInput.append(QVector<uint8_t>(6, 0));
+int AddressUtils::bech32Encode(const char *hrp, int hrpLen,
+                               const uint8_t *values, int valuesLen,
+                               Bech32Encoding encoding, char *out)
+{
+    if (encoding == Bech32Encoding::Invalid || hrpLen < 1 ||
+        hrpLen + 1 + valuesLen + 6 > BECH32_MAX_LENGTH) {
+        return 0;
+    }
 
-    uint32_t polymod = bech32Polymod(polymodInput) ^ 1;
+    uint32_t chk = bech32HrpPolymod(hrp, hrpLen);
+    for (int i = 0; i < valuesLen; ++i) {
+        chk = bech32PolymodStep(chk, values[i]);
+    }
+    for (int i = 0; i < 6; ++i) {
+        chk = bech32PolymodStep(chk, 0);
+    }
+    chk ^= bech32Constant(encoding);
 
-    // Add checksum
+    int pos = 0;
+    for (int i = 0; i < hrpLen; ++i) {
+        out[pos++] = hrp[i];
+    }
+    out[pos++] = '1';
+    for (int i = 0; i < valuesLen; ++i) {
+        out[pos++] = BECH32_CHARSET[values[i]];
+    }
     for (int i = 0; i < 6; ++i) {
-        values.append((polymod >> (5 * (5 - i))) & 31);
+        out[pos++] = BECH32_CHARSET[(chk >> (5 * (5 - i))) & 31];
+    }
+    out[pos] = '\0';
+
+    return pos;
+}
+
+AddressUtils::Bech32Encoding AddressUtils::bech32Decode(const char *input, int inputLen,
+                                                        char *hrpOut, int &hrpLen,
+                                                        uint8_t *values, int &valuesLen)
+{
+    if (inputLen < 8 || inputLen > BECH32_MAX_LENGTH) {
+        return Bech32Encoding::Invalid;
     }
 
-    // Build result
-    QString result = hrp + "1";
-    for (uint8_t value : values) {
-        result += BECH32_CHARSET[value];
+    // Printable US-ASCII only, no mixed case; locate the last separator
+    bool hasLower = false;
+    bool hasUpper = false;
+    int separator = -1;
+    for (int i = 0; i < inputLen; ++i) {
+        unsigned char c = static_cast<unsigned char>(input[i]);
+        if (c < 33 || c > 126) {
+            return Bech32Encoding::Invalid;
+        }
+        if (c >= 'a' && c <= 'z') hasLower = true;
+        if (c >= 'A' && c <= 'Z') hasUpper = true;
+        if (c == '1') separator = i;
+    }
+    if (hasLower && hasUpper) {
+        return Bech32Encoding::Invalid;
+    }
+    if (separator < 1 || separator + 7 > inputLen) {
+        return Bech32Encoding::Invalid;
     }
 
-    return result;
+    hrpLen = separator;
+    for (int i = 0; i < hrpLen; ++i) {
+        char c = input[i];
+        hrpOut[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    uint32_t chk = bech32HrpPolymod(hrpOut, hrpLen);
+    valuesLen = 0;
+    for (int i = separator + 1; i < inputLen; ++i) {
+        int8_t value = BECH32_CHARSET_REV[static_cast<unsigned char>(input[i])];
+        if (value < 0) {
+            return Bech32Encoding::Invalid;
+        }
+        chk = bech32PolymodStep(chk, static_cast<uint8_t>(value));
+        values[valuesLen++] = static_cast<uint8_t>(value);
+    }
+    valuesLen -= 6; // Strip checksum
+
+    if (chk == bech32Constant(Bech32Encoding::Bech32)) {
+        return Bech32Encoding::Bech32;
+    }
+    if (chk == bech32Constant(Bech32Encoding::Bech32m)) {
+        return Bech32Encoding::Bech32m;
+    }
+    return Bech32Encoding::Invalid;
+}
+
+bool AddressUtils::segwitDecode(const char *input, int inputLen,
+                                const char *expectedHrp, int expectedHrpLen,
+                                int &witnessVersion, uint8_t *program, int &programLen)
+{
+    char hrp[BECH32_MAX_LENGTH];
+    uint8_t values[BECH32_MAX_LENGTH];
+    int hrpLen = 0;
+    int valuesLen = 0;
+
+    Bech32Encoding encoding = bech32Decode(input, inputLen, hrp, hrpLen, values, valuesLen);
+    if (encoding == Bech32Encoding::Invalid || valuesLen < 1) {
+        return false;
+    }
+    if (hrpLen != expectedHrpLen || std::memcmp(hrp, expectedHrp, hrpLen) != 0) {
+        return false;
+    }
+
+    witnessVersion = values[0];
+    if (witnessVersion > 16) {
+        return false;
+    }
+    // BIP350: v0 must use Bech32, v1+ must use Bech32m
+    if ((witnessVersion == 0) != (encoding == Bech32Encoding::Bech32)) {
+        return false;
+    }
+
+    if (!convertBits(values + 1, valuesLen - 1, 5, 8, false, program, programLen)) {
+        return false;
+    }
+    if (programLen < 2 || programLen > WITNESS_PROGRAM_MAX) {
+        return false;
+    }
+    if (witnessVersion == 0 && programLen != 20 && programLen != 32) {
+        return false;
+    }
+
+    return true;
+}
+
+QString AddressUtils::encodeSegwitAddress(const QString &hrp, int witnessVersion, const QByteArray &program)
+{
+    if (witnessVersion < 0 || witnessVersion > 16 ||
+        program.size() < 2 || program.size() > WITNESS_PROGRAM_MAX) {
+        return QString();
+    }
+
+    char hrpBuf[BECH32_MAX_LENGTH];
+    int hrpLen = toAscii(hrp.toLower(), hrpBuf, BECH32_MAX_LENGTH);
+    if (hrpLen < 1) {
+        return QString();
+    }
+
+    uint8_t values[BECH32_MAX_LENGTH];
+    int valuesLen = 0;
+    values[0] = static_cast<uint8_t>(witnessVersion);
+    if (!convertBits(reinterpret_cast<const uint8_t*>(program.constData()), program.size(),
+                     8, 5, true, values + 1, valuesLen)) {
+        return QString();
+    }
+
+    char out[BECH32_MAX_LENGTH + 1];
+    Bech32Encoding encoding = witnessVersion == 0 ? Bech32Encoding::Bech32 : Bech32Encoding::Bech32m;
+    int outLen = bech32Encode(hrpBuf, hrpLen, values, valuesLen + 1, encoding, out);
+    if (outLen == 0) {
+        return QString();
+    }
+
+    return QString::fromLatin1(out, outLen);
+}
+
+QByteArray AddressUtils::decodeSegwitAddress(const QString &address, const QString &expectedHrp, int &witnessVersion)
+{
+    char input[BECH32_MAX_LENGTH];
+    char hrp[BECH32_MAX_LENGTH];
+    int inputLen = toAscii(address, input, BECH32_MAX_LENGTH);
+    int hrpLen = toAscii(expectedHrp.toLower(), hrp, BECH32_MAX_LENGTH);
+    if (inputLen < 0 || hrpLen < 1) {
+        return QByteArray();
+    }
+
+    uint8_t program[BECH32_MAX_LENGTH];
+    int programLen = 0;
+    if (!segwitDecode(input, inputLen, hrp, hrpLen, witnessVersion, program, programLen)) {
+        return QByteArray();
+    }
+
+    return QByteArray(reinterpret_cast<const char*>(program), programLen);
+}
+
+QVector<bool> AddressUtils::validateSegwitAddresses(const QStringList &addresses, const QString &expectedHrp)
+{
+    QVector<bool> results(addresses.size(), false);
+
+    char hrp[BECH32_MAX_LENGTH];
+    int hrpLen = toAscii(expectedHrp.toLower(), hrp, BECH32_MAX_LENGTH);
+    if (hrpLen < 1) {
+        return results;
+    }
+
+    // Reuse the same stack buffers for every entry
+    char input[BECH32_MAX_LENGTH];
+    uint8_t program[BECH32_MAX_LENGTH];
+    for (int i = 0; i < addresses.size(); ++i) {
+        int inputLen = toAscii(addresses[i], input, BECH32_MAX_LENGTH);
+        int version = 0;
+        int programLen = 0;
+        results[i] = inputLen > 0 &&
+                     segwitDecode(input, inputLen, hrp, hrpLen, version, program, programLen);
+    }
+
+    return results;
+}
+
+QString AddressUtils::encodeBech32(const QString &hrp, const QByteArray &data)
+{
+    // Witness version 0 (P2WPKH / P2WSH)
+    return encodeSegwitAddress(hrp, 0, data);
 }
 
 QByteArray AddressUtils::decodeBech32(const QString &address, QString &hrp)
 {
-    // TODO: Implement Bech32 decoding
-    return QByteArray();
+    // Accept any human-readable part; the caller checks it against the network
+    int separator = address.lastIndexOf('1');
+    if (separator < 1) {
+        return QByteArray();
+    }
+
+    hrp = address.left(separator).toLower();
+    int witnessVersion = 0;
+    return decodeSegwitAddress(address, hrp, witnessVersion);
+}
+
+// EIP-55 checksum
+void AddressUtils::applyEip55Checksum(const char *lowerHex, char *out)
+{
+    // Letter i is uppercased iff nibble i of keccak256(lowercase hex) >= 8
+    uint8_t hash[32];
+    Keccak256::hash(reinterpret_cast<const uint8_t*>(lowerHex), 40, hash);
+
+    for (int i = 0; i < 40; ++i) {
+        char c = lowerHex[i];
+        int nibble = (i % 2 == 0) ? (hash[i / 2] >> 4) : (hash[i / 2] & 0x0f);
+        out[i] = (c >= 'a' && c <= 'f' && nibble >= 8) ? static_cast<char>(c - ('a' - 'A')) : c;
+    }
 }
 
 // Hash functions
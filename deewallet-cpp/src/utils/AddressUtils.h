@@ -7,22 +7,61 @@
 #define ADDRESSUTILS_H
 
 #include <QString>
+#include <QStringList>
 #include <QByteArray>
+#include <QVector>
+#include <cstdint>
 
 class AddressUtils {
 public:
+    // Bech32 checksum variant (BIP173 / BIP350)
+    enum class Bech32Encoding {
+        Invalid,
+        Bech32,     // witness v0
+        Bech32m     // witness v1+ (Taproot)
+    };
+
+    static constexpr int BECH32_MAX_LENGTH = 90;
+    static constexpr int BASE58_MAX_LENGTH = 128;
+    static constexpr int WITNESS_PROGRAM_MAX = 40;
+
     // Base58 encoding (Bitcoin, Tron)
     static QString encodeBase58(const QByteArray &data);
     static QByteArray decodeBase58(const QString &encoded);
 
+    // Base58 decode into a caller-provided buffer; returns decoded length or -1
+    static int decodeBase58(const char *input, int inputLen, uint8_t *output, int outputMax);
+
     // Base58Check encoding (Bitcoin legacy addresses)
     static QString encodeBase58Check(const QByteArray &data, uint8_t version = 0);
     static QByteArray decodeBase58Check(const QString &encoded);
 
-    // Bech32 encoding (Bitcoin SegWit addresses)
+    // Bech32 encoding (Bitcoin SegWit addresses, witness v0)
     static QString encodeBech32(const QString &hrp, const QByteArray &data);
     static QByteArray decodeBech32(const QString &address, QString &hrp);
 
+    // SegWit address encoding for any witness version (v0 Bech32, v1+ Bech32m)
+    static QString encodeSegwitAddress(const QString &hrp, int witnessVersion, const QByteArray &program);
+    static QByteArray decodeSegwitAddress(const QString &address, const QString &expectedHrp, int &witnessVersion);
+
+    // Batch checksum validation (recipient lists, address book imports)
+    static QVector<bool> validateSegwitAddresses(const QStringList &addresses, const QString &expectedHrp);
+
+    // Low-level Bech32 codec over caller-provided buffers (no heap allocation).
+    // `out` must hold BECH32_MAX_LENGTH + 1 bytes, `values` BECH32_MAX_LENGTH bytes.
+    static int bech32Encode(const char *hrp, int hrpLen,
+                            const uint8_t *values, int valuesLen,
+                            Bech32Encoding encoding, char *out);
+    static Bech32Encoding bech32Decode(const char *input, int inputLen,
+                                       char *hrpOut, int &hrpLen,
+                                       uint8_t *values, int &valuesLen);
+    static bool segwitDecode(const char *input, int inputLen,
+                             const char *expectedHrp, int expectedHrpLen,
+                             int &witnessVersion, uint8_t *program, int &programLen);
+
+    // Copy an ASCII string into `out`; returns its length or -1 if too long / non-ASCII
+    static int toAscii(const QString &str, char *out, int maxLen);
+
     // RIPEMD160 hash
     static QByteArray ripemd160(const QByteArray &data);
 
@@ -32,14 +71,23 @@ public:
     // Keccak256 hash (Ethereum)
     static QByteArray keccak256(const QByteArray &data);
 
+    // EIP-55: writes the mixed-case form of 40 lowercase hex chars into `out` (40 chars)
+    static void applyEip55Checksum(const char *lowerHex, char *out);
+
 private:
     static const char* BASE58_ALPHABET;
     static const char* BECH32_CHARSET;
 
+    static const uint32_t BECH32_GENERATOR_TABLE[32];
+    static const int8_t BECH32_CHARSET_REV[128];
+    static const int8_t BASE58_ALPHABET_REV[128];
+
     // Bech32 helpers
-    static uint32_t bech32Polymod(const QVector<uint8_t> &values);
-    static QVector<uint8_t> bech32HrpExpand(const QString &hrp);
-    static QVector<uint8_t> convertBits(const QByteArray &data, int fromBits, int toBits, bool pad);
+    static uint32_t bech32PolymodStep(uint32_t chk, uint8_t value);
+    static uint32_t bech32HrpPolymod(const char *hrp, int hrpLen);
+    static uint32_t bech32Constant(Bech32Encoding encoding);
+    static bool convertBits(const uint8_t *in, int inLen, int fromBits, int toBits,
+                            bool pad, uint8_t *out, int &outLen);
 };
 
 #endif // ADDRESSUTILS_H
@@ -0,0 +1,263 @@
+/**
+ * DEE WALLET - Address Validator Implementation
+ */
+
+#include "AddressValidator.h"
+#include "AddressUtils.h"
+#include <openssl/sha.h>
+#include <cstring>
+
+bool AddressValidator::validate(const QString &chainType, const QString &address, bool testnet)
+{
+    return detectFormat(chainType, address, testnet) != Format::Invalid;
+}
+
+AddressValidator::Format AddressValidator::detectFormat(const QString &chainType,
+                                                        const QString &address,
+                                                        bool testnet)
+{
+    ChainRules rules = rulesFor(chainType, testnet);
+    if (rules.kind == ChainKind::Unknown) {
+        return Format::Invalid;
+    }
+
+    char input[MAX_ADDRESS_LENGTH];
+    int length = normalize(address, input);
+    if (length <= 0) {
+        return Format::Invalid;
+    }
+
+    return checkWithRules(rules, input, length);
+}
+
+QVector<bool> AddressValidator::validateBatch(const QString &chainType,
+                                              const QStringList &addresses,
+                                              bool testnet)
+{
+    QVector<bool> results(addresses.size(), false);
+
+    ChainRules rules = rulesFor(chainType, testnet);
+    if (rules.kind == ChainKind::Unknown) {
+        return results;
+    }
+
+    char input[MAX_ADDRESS_LENGTH];
+    for (int i = 0; i < addresses.size(); ++i) {
+        int length = normalize(addresses[i], input);
+        results[i] = length > 0 && checkWithRules(rules, input, length) != Format::Invalid;
+    }
+
+    return results;
+}
+
+bool AddressValidator::isEvmChain(const QString &chainType)
+{
+    return chainType == "ETH" || chainType == "BNB" || chainType == "POL" ||
+           chainType == "ARB" || chainType == "OP" || chainType == "AVAX" ||
+           chainType == "BASE" || chainType == "FTM" || chainType == "CRO" ||
+           chainType == "xDAI" || chainType == "Ethereum";
+}
+
+int AddressValidator::normalize(const QString &address, char *out)
+{
+    int begin = 0;
+    int end = address.size();
+    while (begin < end && address[begin].isSpace()) {
+        ++begin;
+    }
+    while (end > begin && address[end - 1].isSpace()) {
+        --end;
+    }
+
+    int length = end - begin;
+    if (length == 0 || length > MAX_ADDRESS_LENGTH) {
+        return -1;
+    }
+    for (int i = 0; i < length; ++i) {
+        ushort c = address[begin + i].unicode();
+        if (c > 0x7f) {
+            return -1;
+        }
+        out[i] = static_cast<char>(c);
+    }
+    return length;
+}
+
+AddressValidator::ChainRules AddressValidator::rulesFor(const QString &chainType, bool testnet)
+{
+    ChainRules rules;
+
+    if (chainType == "BTC" || chainType == "Bitcoin" || chainType == "bitcoin") {
+        rules.kind = ChainKind::Utxo;
+        rules.hrp = testnet ? "tb" : "bc";
+        rules.p2pkhVersion = testnet ? 0x6f : 0x00;
+        rules.p2shVersion = testnet ? 0xc4 : 0x05;
+    } else if (chainType == "LTC" || chainType == "Litecoin" || chainType == "litecoin") {
+        rules.kind = ChainKind::Utxo;
+        rules.hrp = testnet ? "tltc" : "ltc";
+        rules.p2pkhVersion = testnet ? 0x6f : 0x30;
+        rules.p2shVersion = testnet ? 0x3a : 0x32;
+        rules.altP2shVersion = testnet ? 0xc4 : 0x05;
+    } else if (chainType == "DOGE" || chainType == "Dogecoin" || chainType == "dogecoin") {
+        rules.kind = ChainKind::Utxo;
+        rules.p2pkhVersion = testnet ? 0x71 : 0x1e;
+        rules.p2shVersion = testnet ? 0xc4 : 0x16;
+    } else if (chainType == "TRX" || chainType == "Tron" || chainType == "tron") {
+        rules.kind = ChainKind::Tron;
+    } else if (chainType == "SOL" || chainType == "Solana" || chainType == "solana") {
+        rules.kind = ChainKind::Solana;
+    } else if (isEvmChain(chainType)) {
+        rules.kind = ChainKind::Evm;
+    }
+
+    return rules;
+}
+
+AddressValidator::Format AddressValidator::checkWithRules(const ChainRules &rules,
+                                                          const char *address,
+                                                          int length)
+{
+    switch (rules.kind) {
+    case ChainKind::Utxo:
+        return checkUtxo(rules, address, length);
+    case ChainKind::Evm:
+        return checkEvm(address, length);
+    case ChainKind::Tron:
+        return checkTron(address, length);
+    case ChainKind::Solana:
+        return checkSolana(address, length);
+    case ChainKind::Unknown:
+        break;
+    }
+    return Format::Invalid;
+}
+
+AddressValidator::Format AddressValidator::checkEvm(const char *address, int length)
+{
+    if (length != 42 || address[0] != '0' || (address[1] != 'x' && address[1] != 'X')) {
+        return Format::Invalid;
+    }
+
+    const char *hex = address + 2;
+    char lower[40];
+    bool hasLower = false;
+    bool hasUpper = false;
+
+    for (int i = 0; i < 40; ++i) {
+        char c = hex[i];
+        if (c >= '0' && c <= '9') {
+            lower[i] = c;
+        } else if (c >= 'a' && c <= 'f') {
+            lower[i] = c;
+            hasLower = true;
+        } else if (c >= 'A' && c <= 'F') {
+            lower[i] = static_cast<char>(c + ('a' - 'A'));
+            hasUpper = true;
+        } else {
+            return Format::Invalid;
+        }
+    }
+
+    // Single-case addresses carry no checksum
+    if (!hasLower || !hasUpper) {
+        return Format::EvmPlain;
+    }
+
+    // EIP-55 mixed case must match exactly
+    char expected[40];
+    AddressUtils::applyEip55Checksum(lower, expected);
+
+    return std::memcmp(expected, hex, sizeof(expected)) == 0 ? Format::EvmChecksummed
+                                                             : Format::Invalid;
+}
+
+AddressValidator::Format AddressValidator::checkTron(const char *address, int length)
+{
+    if (length != 34 || address[0] != 'T') {
+        return Format::Invalid;
+    }
+
+    // 0x41 || 20-byte hash || 4-byte checksum
+    uint8_t decoded[32];
+    int decodedLen = AddressUtils::decodeBase58(address, length, decoded, sizeof(decoded));
+    if (decodedLen != 25 || decoded[0] != 0x41) {
+        return Format::Invalid;
+    }
+
+    return verifyBase58Check(decoded, decodedLen) ? Format::TronBase58Check : Format::Invalid;
+}
+
+AddressValidator::Format AddressValidator::checkSolana(const char *address, int length)
+{
+    if (length < 32 || length > 44) {
+        return Format::Invalid;
+    }
+
+    uint8_t decoded[48];
+    int decodedLen = AddressUtils::decodeBase58(address, length, decoded, sizeof(decoded));
+    return decodedLen == 32 ? Format::SolanaBase58 : Format::Invalid;
+}
+
+AddressValidator::Format AddressValidator::checkUtxo(const ChainRules &rules,
+                                                     const char *address,
+                                                     int length)
+{
+    // SegWit (Bech32 / Bech32m)
+    if (rules.hrp) {
+        int hrpLen = static_cast<int>(std::strlen(rules.hrp));
+        bool hrpMatch = length > hrpLen && (address[hrpLen] == '1');
+        for (int i = 0; hrpMatch && i < hrpLen; ++i) {
+            char c = address[i];
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c + ('a' - 'A'));
+            }
+            hrpMatch = c == rules.hrp[i];
+        }
+
+        if (hrpMatch) {
+            int witnessVersion = 0;
+            uint8_t program[AddressUtils::BECH32_MAX_LENGTH];
+            int programLen = 0;
+            if (!AddressUtils::segwitDecode(address, length, rules.hrp, hrpLen,
+                                            witnessVersion, program, programLen)) {
+                return Format::Invalid;
+            }
+            return witnessVersion == 0 ? Format::SegwitV0 : Format::SegwitV1Plus;
+        }
+    }
+
+    // Legacy Base58Check: version || hash160 || checksum
+    if (length < 26 || length > 35) {
+        return Format::Invalid;
+    }
+
+    uint8_t decoded[32];
+    int decodedLen = AddressUtils::decodeBase58(address, length, decoded, sizeof(decoded));
+    if (decodedLen != 25 || !verifyBase58Check(decoded, decodedLen)) {
+        return Format::Invalid;
+    }
+
+    int version = decoded[0];
+    if (version == rules.p2pkhVersion) {
+        return Format::P2PKH;
+    }
+    if (version == rules.p2shVersion || version == rules.altP2shVersion) {
+        return Format::P2SH;
+    }
+
+    return Format::Invalid;
+}
+
+bool AddressValidator::verifyBase58Check(const uint8_t *payload, int length)
+{
+    if (length < 5) {
+        return false;
+    }
+
+    unsigned char hash1[SHA256_DIGEST_LENGTH];
+    unsigned char hash2[SHA256_DIGEST_LENGTH];
+    SHA256(payload, length - 4, hash1);
+    SHA256(hash1, SHA256_DIGEST_LENGTH, hash2);
+
+    return std::memcmp(hash2, payload + length - 4, 4) == 0;
+}
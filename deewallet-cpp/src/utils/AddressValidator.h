@@ -0,0 +1,73 @@
+/**
+ * DEE WALLET - Address Validator
+ * Checksum-verifying address validation for all supported chains
+ */
+
+#ifndef ADDRESSVALIDATOR_H
+#define ADDRESSVALIDATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <cstdint>
+
+class AddressValidator {
+public:
+    enum class Format {
+        Invalid,
+        EvmChecksummed,     // EIP-55 mixed case
+        EvmPlain,           // all-lowercase / all-uppercase hex (no checksum)
+        TronBase58Check,    // 0x41 || hash160, Base58Check
+        SolanaBase58,       // 32-byte Ed25519 key, Base58
+        SegwitV0,           // P2WPKH / P2WSH (Bech32)
+        SegwitV1Plus,       // Taproot and later (Bech32m)
+        P2PKH,              // Legacy pay-to-pubkey-hash
+        P2SH                // Legacy pay-to-script-hash
+    };
+
+    // Validate a single address for a chain symbol or name (BTC, LTC, DOGE, TRX, SOL, ETH and EVM chains)
+    static bool validate(const QString &chainType, const QString &address, bool testnet = false);
+    static Format detectFormat(const QString &chainType, const QString &address, bool testnet = false);
+
+    // Batch validation; chain rules are resolved once and every entry reuses stack buffers
+    static QVector<bool> validateBatch(const QString &chainType,
+                                       const QStringList &addresses,
+                                       bool testnet = false);
+
+    // Format-specific checks over raw ASCII input (no heap allocation)
+    static Format checkEvm(const char *address, int length);
+    static Format checkTron(const char *address, int length);
+    static Format checkSolana(const char *address, int length);
+
+    static bool isEvmChain(const QString &chainType);
+
+private:
+    enum class ChainKind {
+        Unknown,
+        Utxo,
+        Evm,
+        Tron,
+        Solana
+    };
+
+    struct ChainRules {
+        ChainKind kind = ChainKind::Unknown;
+        const char *hrp = nullptr;  // nullptr = no SegWit support
+        int p2pkhVersion = -1;
+        int p2shVersion = -1;
+        int altP2shVersion = -1;    // Litecoin still accepts the old '3' prefix
+    };
+
+    // Input as ASCII with surrounding whitespace dropped (a pasted address
+    // often carries a newline); length, or -1 if empty, too long or non-ASCII
+    static int normalize(const QString &address, char *out);
+
+    static ChainRules rulesFor(const QString &chainType, bool testnet);
+    static Format checkWithRules(const ChainRules &rules, const char *address, int length);
+    static Format checkUtxo(const ChainRules &rules, const char *address, int length);
+    static bool verifyBase58Check(const uint8_t *payload, int length);
+
+    static constexpr int MAX_ADDRESS_LENGTH = 128;
+};
+
+#endif // ADDRESSVALIDATOR_H
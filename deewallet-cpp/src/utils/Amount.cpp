@@ -0,0 +1,163 @@
+/**
+ * DEE WALLET - Amount Implementation
+ */
+
+#include "Amount.h"
+#include <algorithm>
+
+namespace {
+
+// 10^9 is the largest power of ten mulSmall / divSmall take
+const uint32_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+UInt256 scaleUp(const UInt256 &value, int digits, bool *overflow)
+{
+    UInt256 result = value;
+    bool overflowed = false;
+    while (digits > 0 && !overflowed) {
+        int step = std::min(digits, 9);
+        result = result.mulSmall(POW10[step], &overflowed);
+        digits -= step;
+    }
+
+    *overflow = overflowed;
+    return result;
+}
+
+UInt256 scaleDown(const UInt256 &value, int digits, bool *exact)
+{
+    UInt256 result = value;
+    bool remainderSeen = false;
+    while (digits > 0) {
+        int step = std::min(digits, 9);
+        uint32_t remainder = 0;
+        result = result.divSmall(POW10[step], &remainder);
+        remainderSeen |= remainder != 0;
+        digits -= step;
+    }
+
+    *exact = !remainderSeen;
+    return result;
+}
+
+} // namespace
+
+Amount::Amount()
+    : scale(0)
+{
+}
+
+Amount::Amount(const UInt256 &units, int decimals)
+    : value(units)
+    , scale(std::max(decimals, 0))
+{
+}
+
+Amount Amount::parse(const QString &text, int decimals, bool *ok)
+{
+    QString trimmed = text.trimmed();
+    if (decimals < 0) {
+        int dot = trimmed.indexOf('.');
+        decimals = dot >= 0 ? trimmed.length() - dot - 1 : 0;
+    }
+
+    bool valid = false;
+    UInt256 units = UInt256::parseUnits(trimmed, decimals, &valid);
+
+    if (ok) {
+        *ok = valid;
+    }
+    return Amount(units, decimals);
+}
+
+QString Amount::toString() const
+{
+    QString text = value.formatUnits(scale);
+    if (scale == 0) {
+        return text + ".0";
+    }
+
+    int end = text.length();
+    while (end > 0 && text[end - 1] == '0' && text[end - 2] != '.') {
+        --end;
+    }
+    text.truncate(end);
+    return text;
+}
+
+QString Amount::toString(int fractionDigits) const
+{
+    return rescaled(fractionDigits).value.formatUnits(fractionDigits);
+}
+
+Amount Amount::rescaled(int decimals, bool *ok) const
+{
+    decimals = std::max(decimals, 0);
+
+    bool valid = true;
+    UInt256 units;
+    if (decimals >= scale) {
+        bool overflow = false;
+        units = scaleUp(value, decimals - scale, &overflow);
+        valid = !overflow;
+    } else {
+        units = scaleDown(value, scale - decimals, &valid);
+    }
+
+    if (ok) {
+        *ok = valid;
+    }
+    return Amount(units, decimals);
+}
+
+Amount Amount::add(const Amount &other, bool *overflow) const
+{
+    int target = std::max(scale, other.scale);
+    bool alignedLeft = true;
+    bool alignedRight = true;
+    Amount left = rescaled(target, &alignedLeft);
+    Amount right = other.rescaled(target, &alignedRight);
+
+    bool carry = false;
+    Amount result(left.value.add(right.value, &carry), target);
+    if (overflow) {
+        *overflow = carry || !alignedLeft || !alignedRight;
+    }
+    return result;
+}
+
+Amount Amount::sub(const Amount &other, bool *underflow) const
+{
+    int target = std::max(scale, other.scale);
+    bool alignedLeft = true;
+    bool alignedRight = true;
+    Amount left = rescaled(target, &alignedLeft);
+    Amount right = other.rescaled(target, &alignedRight);
+
+    bool borrow = false;
+    Amount result(left.value.sub(right.value, &borrow), target);
+    if (underflow) {
+        *underflow = borrow || !alignedLeft || !alignedRight;
+    }
+    return result;
+}
+
+Amount Amount::mulSmall(uint32_t factor, bool *overflow) const
+{
+    return Amount(value.mulSmall(factor, overflow), scale);
+}
+
+int Amount::compare(const Amount &other) const
+{
+    int target = std::max(scale, other.scale);
+    bool alignedLeft = true;
+    bool alignedRight = true;
+    Amount left = rescaled(target, &alignedLeft);
+    Amount right = other.rescaled(target, &alignedRight);
+
+    // Whichever side no longer fits 256 bits at the finer scale is larger
+    if (!alignedLeft || !alignedRight) {
+        return alignedLeft == alignedRight ? 0 : (alignedLeft ? -1 : 1);
+    }
+    return left.value.compare(right.value);
+}
@@ -0,0 +1,59 @@
+/**
+ * DEE WALLET - Amount
+ * Exact decimal-scaled amount: integer base units (wei, satoshi, lamports,
+ * sun, token units) plus the number of decimals they carry
+ */
+
+#ifndef AMOUNT_H
+#define AMOUNT_H
+
+#include <QString>
+#include "UInt256.h"
+
+class Amount {
+public:
+    Amount();
+    Amount(const UInt256 &units, int decimals);
+
+    // Decimal text such as "1.5" or "0.000005". With decimals < 0 the scale
+    // is taken from the text itself; otherwise more fractional digits than
+    // decimals is an error, not a silent truncation.
+    static Amount parse(const QString &text, int decimals = -1, bool *ok = nullptr);
+
+    const UInt256 &units() const { return value; }
+    int decimals() const { return scale; }
+    bool isZero() const { return value.isZero(); }
+
+    // Exact, trailing zeros trimmed down to one fractional digit ("0.0", "1.25")
+    QString toString() const;
+
+    // Exactly fractionDigits digits, truncated; a balance is never rounded up
+    QString toString(int fractionDigits) const;
+
+    // Same value in a finer scale (exact), or a coarser one (truncated;
+    // ok is false if anything was cut off or the result overflows)
+    Amount rescaled(int decimals, bool *ok = nullptr) const;
+
+    // Operands in different scales are aligned to the finer one first
+    Amount add(const Amount &other, bool *overflow = nullptr) const;
+    Amount sub(const Amount &other, bool *underflow = nullptr) const;
+    Amount mulSmall(uint32_t factor, bool *overflow = nullptr) const;
+
+    Amount operator+(const Amount &other) const { return add(other); }
+    Amount operator-(const Amount &other) const { return sub(other); }
+    Amount &operator+=(const Amount &other) { return *this = add(other); }
+
+    int compare(const Amount &other) const;
+    bool operator==(const Amount &other) const { return compare(other) == 0; }
+    bool operator!=(const Amount &other) const { return compare(other) != 0; }
+    bool operator<(const Amount &other) const { return compare(other) < 0; }
+    bool operator>(const Amount &other) const { return compare(other) > 0; }
+    bool operator<=(const Amount &other) const { return compare(other) <= 0; }
+    bool operator>=(const Amount &other) const { return compare(other) >= 0; }
+
+private:
+    UInt256 value;
+    int scale;
+};
+
+#endif // AMOUNT_H
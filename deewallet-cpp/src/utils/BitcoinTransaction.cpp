@@ -0,0 +1,417 @@
+/**
+ * DEE WALLET - Bitcoin Transaction Implementation
+ */
+
+#include "BitcoinTransaction.h"
+#include "AddressUtils.h"
+#include "Secp256k1.h"
+#include <openssl/sha.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+void appendUInt32(QByteArray &out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.append(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+void appendUInt64(QByteArray &out, quint64 value)
+{
+    for (int i = 0; i < 8; ++i) {
+        out.append(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+void sha256(const QByteArray &data, uint8_t out[32])
+{
+    SHA256(reinterpret_cast<const unsigned char*>(data.constData()), static_cast<size_t>(data.size()), out);
+}
+
+void sha256d(const QByteArray &data, uint8_t out[32])
+{
+    uint8_t first[32];
+    sha256(data, first);
+    SHA256(first, sizeof(first), out);
+}
+
+QByteArray bytes32(const uint8_t *data)
+{
+    return QByteArray(reinterpret_cast<const char*>(data), 32);
+}
+
+} // namespace
+
+BitcoinTransaction::BitcoinTransaction()
+    : txVersion(2)
+    , txLockTime(0)
+{
+}
+
+void BitcoinTransaction::addInput(const QString &txid, quint32 vout, qint64 value,
+                                  const QByteArray &scriptPubKey)
+{
+    BitcoinTxInput input;
+    input.prevTxid = QByteArray::fromHex(txid.toLatin1());
+    std::reverse(input.prevTxid.begin(), input.prevTxid.end());
+    input.vout = vout;
+    input.value = value;
+    input.scriptPubKey = scriptPubKey;
+    addInput(input);
+}
+
+void BitcoinTransaction::addInput(const BitcoinTxInput &input)
+{
+    txInputs.append(input);
+    invalidate();
+}
+
+void BitcoinTransaction::addOutput(qint64 value, const QByteArray &scriptPubKey)
+{
+    txOutputs.append({value, scriptPubKey});
+    invalidate();
+}
+
+void BitcoinTransaction::setWitness(int index, const QVector<QByteArray> &witness)
+{
+    // Witnesses are not committed to by any sighash
+    if (index >= 0 && index < txInputs.size()) {
+        txInputs[index].witness = witness;
+    }
+}
+
+void BitcoinTransaction::setVersion(quint32 version)
+{
+    txVersion = version;
+}
+
+void BitcoinTransaction::setLockTime(quint32 lockTime)
+{
+    txLockTime = lockTime;
+}
+
+void BitcoinTransaction::appendCompactSize(QByteArray &out, quint64 value)
+{
+    if (value < 0xfd) {
+        out.append(static_cast<char>(value));
+    } else if (value <= 0xffff) {
+        out.append(static_cast<char>(0xfd));
+        out.append(static_cast<char>(value & 0xff));
+        out.append(static_cast<char>((value >> 8) & 0xff));
+    } else if (value <= 0xffffffff) {
+        out.append(static_cast<char>(0xfe));
+        appendUInt32(out, static_cast<quint32>(value));
+    } else {
+        out.append(static_cast<char>(0xff));
+        appendUInt64(out, value);
+    }
+}
+
+void BitcoinTransaction::appendOutput(QByteArray &out, const BitcoinTxOutput &output)
+{
+    appendUInt64(out, static_cast<quint64>(output.value));
+    appendCompactSize(out, static_cast<quint64>(output.scriptPubKey.size()));
+    out.append(output.scriptPubKey);
+}
+
+QByteArray BitcoinTransaction::serialize(bool includeWitness) const
+{
+    bool witness = includeWitness && std::any_of(txInputs.begin(), txInputs.end(),
+        [](const BitcoinTxInput &input) { return !input.witness.isEmpty(); });
+
+    QByteArray out;
+    out.reserve(16 + txInputs.size() * (41 + (witness ? 108 : 0)) + txOutputs.size() * 43);
+    appendUInt32(out, txVersion);
+    if (witness) {
+        // Marker and flag
+        out.append(static_cast<char>(0x00));
+        out.append(static_cast<char>(0x01));
+    }
+
+    appendCompactSize(out, static_cast<quint64>(txInputs.size()));
+    for (const BitcoinTxInput &input : txInputs) {
+        out.append(input.prevTxid);
+        appendUInt32(out, input.vout);
+        appendCompactSize(out, 0);      // empty scriptSig: native SegWit only
+        appendUInt32(out, input.sequence);
+    }
+
+    appendCompactSize(out, static_cast<quint64>(txOutputs.size()));
+    for (const BitcoinTxOutput &output : txOutputs) {
+        appendOutput(out, output);
+    }
+
+    if (witness) {
+        for (const BitcoinTxInput &input : txInputs) {
+            appendCompactSize(out, static_cast<quint64>(input.witness.size()));
+            for (const QByteArray &item : input.witness) {
+                appendCompactSize(out, static_cast<quint64>(item.size()));
+                out.append(item);
+            }
+        }
+    }
+
+    appendUInt32(out, txLockTime);
+    return out;
+}
+
+QString BitcoinTransaction::txid() const
+{
+    uint8_t hash[32];
+    sha256d(serialize(false), hash);
+    std::reverse(hash, hash + 32);
+    return QString::fromLatin1(bytes32(hash).toHex());
+}
+
+int BitcoinTransaction::weight() const
+{
+    // Base size counts four times, witness bytes once
+    int base = serialize(false).size();
+    int total = serialize(true).size();
+    return base * 3 + total;
+}
+
+qint64 BitcoinTransaction::inputValue() const
+{
+    qint64 sum = 0;
+    for (const BitcoinTxInput &input : txInputs) {
+        sum += input.value;
+    }
+    return sum;
+}
+
+qint64 BitcoinTransaction::outputValue() const
+{
+    qint64 sum = 0;
+    for (const BitcoinTxOutput &output : txOutputs) {
+        sum += output.value;
+    }
+    return sum;
+}
+
+const BitcoinTransaction::SighashCache &BitcoinTransaction::sighashCache() const
+{
+    if (cache.valid) {
+        return cache;
+    }
+
+    QByteArray prevouts;
+    QByteArray amounts;
+    QByteArray scripts;
+    QByteArray sequences;
+    QByteArray outputs;
+    prevouts.reserve(txInputs.size() * 36);
+    amounts.reserve(txInputs.size() * 8);
+    scripts.reserve(txInputs.size() * 35);
+    sequences.reserve(txInputs.size() * 4);
+    outputs.reserve(txOutputs.size() * 43);
+
+    for (const BitcoinTxInput &input : txInputs) {
+        prevouts.append(input.prevTxid);
+        appendUInt32(prevouts, input.vout);
+        appendUInt64(amounts, static_cast<quint64>(input.value));
+        appendCompactSize(scripts, static_cast<quint64>(input.scriptPubKey.size()));
+        scripts.append(input.scriptPubKey);
+        appendUInt32(sequences, input.sequence);
+    }
+    for (const BitcoinTxOutput &output : txOutputs) {
+        appendOutput(outputs, output);
+    }
+
+    sha256(prevouts, cache.prevouts);
+    sha256(amounts, cache.amounts);
+    sha256(scripts, cache.scriptPubKeys);
+    sha256(sequences, cache.sequences);
+    sha256(outputs, cache.outputs);
+
+    SHA256(cache.prevouts, 32, cache.hashPrevouts);
+    SHA256(cache.sequences, 32, cache.hashSequence);
+    SHA256(cache.outputs, 32, cache.hashOutputs);
+    cache.valid = true;
+    return cache;
+}
+
+bool BitcoinTransaction::segwitV0Sighash(int index, const QByteArray &scriptCode,
+                                         quint32 hashType, uint8_t out[32]) const
+{
+    if (index < 0 || index >= txInputs.size()) {
+        return false;
+    }
+
+    const SighashCache &hashes = sighashCache();
+    const BitcoinTxInput &input = txInputs[index];
+    quint32 baseType = hashType & 0x1f;
+    bool anyoneCanPay = hashType & SIGHASH_ANYONECANPAY;
+    static const uint8_t ZERO[32] = {};
+
+    QByteArray preimage;
+    preimage.reserve(160 + scriptCode.size());
+    appendUInt32(preimage, txVersion);
+    preimage.append(bytes32(anyoneCanPay ? ZERO : hashes.hashPrevouts));
+    preimage.append(bytes32(anyoneCanPay || baseType == SIGHASH_SINGLE || baseType == SIGHASH_NONE
+                            ? ZERO : hashes.hashSequence));
+    preimage.append(input.prevTxid);
+    appendUInt32(preimage, input.vout);
+    appendCompactSize(preimage, static_cast<quint64>(scriptCode.size()));
+    preimage.append(scriptCode);
+    appendUInt64(preimage, static_cast<quint64>(input.value));
+    appendUInt32(preimage, input.sequence);
+
+    if (baseType != SIGHASH_SINGLE && baseType != SIGHASH_NONE) {
+        preimage.append(bytes32(hashes.hashOutputs));
+    } else if (baseType == SIGHASH_SINGLE && index < txOutputs.size()) {
+        QByteArray output;
+        appendOutput(output, txOutputs[index]);
+        uint8_t hashOutput[32];
+        sha256d(output, hashOutput);
+        preimage.append(bytes32(hashOutput));
+    } else {
+        preimage.append(bytes32(ZERO));
+    }
+
+    appendUInt32(preimage, txLockTime);
+    appendUInt32(preimage, hashType);
+    sha256d(preimage, out);
+    return true;
+}
+
+bool BitcoinTransaction::taprootSighash(int index, quint32 hashType, uint8_t out[32]) const
+{
+    quint32 baseType = hashType & 0x03;
+    bool anyoneCanPay = hashType & SIGHASH_ANYONECANPAY;
+    bool validType = hashType == SIGHASH_DEFAULT
+        || ((hashType & ~(SIGHASH_ANYONECANPAY | 0x03)) == 0 && baseType != 0);
+    if (!validType || index < 0 || index >= txInputs.size()) {
+        return false;
+    }
+    if (baseType == SIGHASH_SINGLE && index >= txOutputs.size()) {
+        return false;
+    }
+
+    const SighashCache &hashes = sighashCache();
+    const BitcoinTxInput &input = txInputs[index];
+
+    // SigMsg with epoch 0, spend type 0 (key path, no annex)
+    QByteArray message;
+    message.reserve(210 + input.scriptPubKey.size());
+    message.append(static_cast<char>(0x00));
+    message.append(static_cast<char>(hashType));
+    appendUInt32(message, txVersion);
+    appendUInt32(message, txLockTime);
+    if (!anyoneCanPay) {
+        message.append(bytes32(hashes.prevouts));
+        message.append(bytes32(hashes.amounts));
+        message.append(bytes32(hashes.scriptPubKeys));
+        message.append(bytes32(hashes.sequences));
+    }
+    if (baseType != SIGHASH_NONE && baseType != SIGHASH_SINGLE) {
+        message.append(bytes32(hashes.outputs));
+    }
+    message.append(static_cast<char>(0x00));
+
+    if (anyoneCanPay) {
+        message.append(input.prevTxid);
+        appendUInt32(message, input.vout);
+        appendUInt64(message, static_cast<quint64>(input.value));
+        appendCompactSize(message, static_cast<quint64>(input.scriptPubKey.size()));
+        message.append(input.scriptPubKey);
+        appendUInt32(message, input.sequence);
+    } else {
+        appendUInt32(message, static_cast<quint32>(index));
+    }
+
+    if (baseType == SIGHASH_SINGLE) {
+        QByteArray output;
+        appendOutput(output, txOutputs[index]);
+        uint8_t hashOutput[32];
+        sha256(output, hashOutput);
+        message.append(bytes32(hashOutput));
+    }
+
+    Secp256k1::taggedHash("TapSighash", message, out);
+    return true;
+}
+
+bool BitcoinTransaction::signInput(int index, const QByteArray &privateKey, quint32 hashType)
+{
+    if (index < 0 || index >= txInputs.size()) {
+        return false;
+    }
+
+    const QByteArray &script = txInputs[index].scriptPubKey;
+    uint8_t hash[32];
+
+    switch (scriptType(script)) {
+    case ScriptType::P2WPKH: {
+        QByteArray publicKey = Secp256k1::publicKey(privateKey, true);
+        uint8_t keyHash[32];
+        sha256(publicKey, keyHash);
+        QByteArray program = AddressUtils::ripemd160(bytes32(keyHash));
+        if (publicKey.isEmpty() || program != script.mid(2, 20)) {
+            return false;
+        }
+
+        // scriptCode is the P2PKH script of the key hash
+        QByteArray scriptCode = QByteArray::fromHex("76a914") + program + QByteArray::fromHex("88ac");
+        if (!segwitV0Sighash(index, scriptCode, hashType, hash)) {
+            return false;
+        }
+
+        QByteArray signature = Secp256k1::signHashDer(hash, privateKey);
+        if (signature.isEmpty()) {
+            return false;
+        }
+        signature.append(static_cast<char>(hashType));
+        txInputs[index].witness = {signature, publicKey};
+        return true;
+    }
+    case ScriptType::P2TR: {
+        // SIGHASH_DEFAULT commits to the same data as ALL, one byte shorter
+        quint32 taprootType = hashType == SIGHASH_ALL ? SIGHASH_DEFAULT : hashType;
+        QByteArray tweaked = Secp256k1::tweakTaprootKey(privateKey);
+        QByteArray outputKey = Secp256k1::publicKey(tweaked, true);
+        if (outputKey.isEmpty() || outputKey.mid(1) != script.mid(2, 32)
+            || !taprootSighash(index, taprootType, hash)) {
+            return false;
+        }
+
+        QByteArray signature = Secp256k1::signSchnorr(hash, tweaked);
+        tweaked.fill(0);
+        if (signature.isEmpty()) {
+            return false;
+        }
+        if (taprootType != SIGHASH_DEFAULT) {
+            signature.append(static_cast<char>(taprootType));
+        }
+        txInputs[index].witness = {signature};
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+BitcoinTransaction::ScriptType BitcoinTransaction::scriptType(const QByteArray &script)
+{
+    const uint8_t *s = reinterpret_cast<const uint8_t*>(script.constData());
+    int size = script.size();
+
+    if (size == 25 && s[0] == 0x76 && s[1] == 0xa9 && s[2] == 0x14 && s[23] == 0x88 && s[24] == 0xac) {
+        return ScriptType::P2PKH;
+    }
+    if (size == 23 && s[0] == 0xa9 && s[1] == 0x14 && s[22] == 0x87) {
+        return ScriptType::P2SH;
+    }
+    if (size == 22 && s[0] == 0x00 && s[1] == 0x14) {
+        return ScriptType::P2WPKH;
+    }
+    if (size == 34 && s[0] == 0x00 && s[1] == 0x20) {
+        return ScriptType::P2WSH;
+    }
+    if (size == 34 && s[0] == 0x51 && s[1] == 0x20) {
+        return ScriptType::P2TR;
+    }
+    return ScriptType::Unknown;
+}
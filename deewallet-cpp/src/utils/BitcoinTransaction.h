@@ -0,0 +1,106 @@
+/**
+ * DEE WALLET - Bitcoin Transaction
+ * SegWit transaction with BIP 143 (witness v0) and BIP 341 (taproot key
+ * path) signature hashing. The per-transaction hashes of prevouts,
+ * amounts, scripts, sequences and outputs are computed once and shared by
+ * every input's sighash, so signing N inputs hashes O(N) bytes.
+ */
+
+#ifndef BITCOINTRANSACTION_H
+#define BITCOINTRANSACTION_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+struct BitcoinTxInput {
+    QByteArray prevTxid;            // 32 bytes, internal (little-endian) order
+    quint32 vout = 0;
+    quint32 sequence = 0xfffffffd;  // final, signals replace-by-fee
+    qint64 value = 0;               // amount of the spent output
+    QByteArray scriptPubKey;        // script of the spent output
+    QVector<QByteArray> witness;
+};
+
+struct BitcoinTxOutput {
+    qint64 value = 0;
+    QByteArray scriptPubKey;
+};
+
+class BitcoinTransaction {
+public:
+    enum class ScriptType { Unknown, P2PKH, P2SH, P2WPKH, P2WSH, P2TR };
+
+    // Sighash types; taproot also has SIGHASH_DEFAULT (0x00)
+    static constexpr quint32 SIGHASH_DEFAULT = 0x00;
+    static constexpr quint32 SIGHASH_ALL = 0x01;
+    static constexpr quint32 SIGHASH_NONE = 0x02;
+    static constexpr quint32 SIGHASH_SINGLE = 0x03;
+    static constexpr quint32 SIGHASH_ANYONECANPAY = 0x80;
+
+    BitcoinTransaction();
+
+    // txid in RPC (display) hex order
+    void addInput(const QString &txid, quint32 vout, qint64 value, const QByteArray &scriptPubKey);
+    void addInput(const BitcoinTxInput &input);
+    void addOutput(qint64 value, const QByteArray &scriptPubKey);
+
+    const QVector<BitcoinTxInput> &inputs() const { return txInputs; }
+    const QVector<BitcoinTxOutput> &outputs() const { return txOutputs; }
+    void setWitness(int index, const QVector<QByteArray> &witness);
+
+    quint32 version() const { return txVersion; }
+    void setVersion(quint32 version);
+    quint32 lockTime() const { return txLockTime; }
+    void setLockTime(quint32 lockTime);
+
+    // Witness serialization (BIP 144) when any input has a witness
+    QByteArray serialize(bool includeWitness = true) const;
+    QString txid() const;
+    int weight() const;
+    int virtualSize() const { return (weight() + 3) / 4; }
+
+    qint64 inputValue() const;
+    qint64 outputValue() const;
+
+    // BIP 143 digest; scriptCode without its length prefix
+    bool segwitV0Sighash(int index, const QByteArray &scriptCode, quint32 hashType, uint8_t out[32]) const;
+
+    // BIP 341 key-path digest (no annex)
+    bool taprootSighash(int index, quint32 hashType, uint8_t out[32]) const;
+
+    // Signs a P2WPKH or P2TR (BIP 86 key path) input with the key that owns
+    // it and fills its witness; false if the key does not match the script
+    bool signInput(int index, const QByteArray &privateKey, quint32 hashType = SIGHASH_ALL);
+
+    static ScriptType scriptType(const QByteArray &scriptPubKey);
+    static void appendCompactSize(QByteArray &out, quint64 value);
+
+private:
+    // Single SHA256 of each field list (BIP 341); BIP 143 uses the double
+    // hash, which is one more SHA256 over these
+    struct SighashCache {
+        bool valid = false;
+        uint8_t prevouts[32];
+        uint8_t amounts[32];
+        uint8_t scriptPubKeys[32];
+        uint8_t sequences[32];
+        uint8_t outputs[32];
+        uint8_t hashPrevouts[32];
+        uint8_t hashSequence[32];
+        uint8_t hashOutputs[32];
+    };
+
+    const SighashCache &sighashCache() const;
+    void invalidate() { cache.valid = false; }
+    static void appendOutput(QByteArray &out, const BitcoinTxOutput &output);
+
+    quint32 txVersion;
+    quint32 txLockTime;
+    QVector<BitcoinTxInput> txInputs;
+    QVector<BitcoinTxOutput> txOutputs;
+    mutable SighashCache cache;
+};
+
+#endif // BITCOINTRANSACTION_H
@@ -0,0 +1,429 @@
+/**
+ * DEE WALLET - Coin Selector Implementation
+ */
+
+#include "CoinSelector.h"
+#include "BitcoinTransaction.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+qint64 feeFor(int vsize, qint64 feeRate)
+{
+    // Rates are per 1000 vbytes; round up so the rate is always met
+    return (static_cast<qint64>(vsize) * feeRate + 999) / 1000;
+}
+
+// Per-call amounts shared by the three algorithms
+struct SelectionTarget {
+    qint64 target;              // amount plus the fixed part of the fee
+    qint64 targetWithChange;    // target plus a change output above dust
+    qint64 costOfChange;        // creating the change output now and spending it later
+    int maxVSize;               // input budget under the standardness limit
+};
+
+template <typename Pool>
+QVector<int> selectBranchAndBound(const Pool &pool, const SelectionTarget &goal, bool feeRateHigh,
+                                  const QElapsedTimer &timer, int budgetMs)
+{
+    // Depth-first over include/exclude decisions in descending effective
+    // value. A branch is cut once it overshoots target + costOfChange, can no
+    // longer reach target, or (when inputs are dearer now than later) wastes
+    // more than the best solution found.
+    qint64 available = 0;
+    for (const auto &candidate : pool) {
+        available += candidate.effectiveValue;
+    }
+    if (available < goal.target) {
+        return QVector<int>();
+    }
+
+    QVector<int> current;
+    QVector<int> best;
+    qint64 value = 0;
+    qint64 waste = 0;
+    qint64 bestWaste = std::numeric_limits<qint64>::max();
+    int vsize = 0;
+    int index = 0;
+
+    for (int tries = 0; tries < CoinSelector::BNB_MAX_TRIES; ++tries, ++index) {
+        if ((tries & 1023) == 1023 && timer.hasExpired(budgetMs)) {
+            break;
+        }
+
+        bool backtrack = false;
+        if (value + available < goal.target
+            || value > goal.target + goal.costOfChange
+            || vsize > goal.maxVSize
+            || (waste > bestWaste && feeRateHigh)) {
+            backtrack = true;
+        } else if (value >= goal.target) {
+            // Changeless: the excess goes to fees and counts as waste
+            qint64 total = waste + value - goal.target;
+            if (total <= bestWaste) {
+                best = current;
+                bestWaste = total;
+            }
+            backtrack = true;
+        }
+
+        if (backtrack) {
+            if (current.isEmpty()) {
+                break;
+            }
+            // Undo the omissions after the last inclusion, then omit it
+            --index;
+            while (index > current.last()) {
+                available += pool[index].effectiveValue;
+                --index;
+            }
+            const auto &candidate = pool[index];
+            value -= candidate.effectiveValue;
+            waste -= candidate.fee - candidate.longTermFee;
+            vsize -= candidate.vsize;
+            current.removeLast();
+        } else {
+            const auto &candidate = pool[index];
+            available -= candidate.effectiveValue;
+
+            // Including a twin of the candidate just omitted repeats that subtree
+            if (current.isEmpty() || index - 1 == current.last()
+                || candidate.effectiveValue != pool[index - 1].effectiveValue
+                || candidate.fee != pool[index - 1].fee) {
+                current.append(index);
+                value += candidate.effectiveValue;
+                waste += candidate.fee - candidate.longTermFee;
+                vsize += candidate.vsize;
+            }
+        }
+    }
+
+    return best;
+}
+
+template <typename Pool>
+int totalVSize(const Pool &pool, const QVector<int> &selection)
+{
+    int vsize = 0;
+    for (int index : selection) {
+        vsize += pool[index].vsize;
+    }
+    return vsize;
+}
+
+template <typename Pool>
+QVector<int> selectKnapsack(const Pool &pool, const SelectionTarget &goal,
+                            const QElapsedTimer &timer, int budgetMs)
+{
+    // Candidates that cover the target with change on their own come first
+    // in the descending pool; the last of them is the smallest such coin
+    int split = static_cast<int>(std::partition_point(pool.begin(), pool.end(),
+        [&](const auto &candidate) { return candidate.effectiveValue >= goal.targetWithChange; })
+        - pool.begin());
+    int lowestLarger = split - 1;
+
+    QVector<int> smaller;
+    qint64 smallerTotal = 0;
+    for (int i = split; i < pool.size(); ++i) {
+        if (pool[i].effectiveValue == goal.target) {
+            return QVector<int>{i};
+        }
+        smaller.append(i);
+        smallerTotal += pool[i].effectiveValue;
+    }
+
+    auto fits = [&](const QVector<int> &selection) {
+        return totalVSize(pool, selection) <= goal.maxVSize ? selection : QVector<int>();
+    };
+
+    if (smallerTotal == goal.target) {
+        return fits(smaller);
+    }
+    if (smallerTotal < goal.targetWithChange) {
+        if (lowestLarger >= 0) {
+            return QVector<int>{lowestLarger};
+        }
+        return smallerTotal >= goal.target ? fits(smaller) : QVector<int>();
+    }
+
+    // Randomized approximation of the smallest subset reaching the target
+    QRandomGenerator *random = QRandomGenerator::global();
+    QVector<char> included(smaller.size());
+    QVector<char> best(smaller.size(), 1);
+    qint64 bestTotal = smallerTotal;
+
+    for (int iteration = 0; iteration < CoinSelector::KNAPSACK_ITERATIONS
+         && bestTotal != goal.targetWithChange; ++iteration) {
+        if (timer.hasExpired(budgetMs)) {
+            break;
+        }
+
+        std::fill(included.begin(), included.end(), 0);
+        qint64 total = 0;
+        bool reached = false;
+        for (int pass = 0; pass < 2 && !reached; ++pass) {
+            quint64 bits = 0;
+            for (int i = 0; i < smaller.size(); ++i) {
+                if ((i & 63) == 0) {
+                    bits = random->generate64();
+                }
+                bool take = pass == 0 ? (bits >> (i & 63)) & 1 : !included[i];
+                if (!take) {
+                    continue;
+                }
+                total += pool[smaller[i]].effectiveValue;
+                included[i] = 1;
+                if (total >= goal.targetWithChange) {
+                    reached = true;
+                    if (total < bestTotal) {
+                        bestTotal = total;
+                        best = included;
+                    }
+                    total -= pool[smaller[i]].effectiveValue;
+                    included[i] = 0;
+                }
+            }
+        }
+    }
+
+    if (lowestLarger >= 0 && pool[lowestLarger].effectiveValue <= bestTotal) {
+        return QVector<int>{lowestLarger};
+    }
+
+    QVector<int> selection;
+    for (int i = 0; i < smaller.size(); ++i) {
+        if (best[i]) {
+            selection.append(smaller[i]);
+        }
+    }
+    return fits(selection);
+}
+
+template <typename Pool>
+QVector<int> selectRandomDraw(const Pool &pool, const SelectionTarget &goal)
+{
+    // Partial Fisher-Yates shuffle: only the drawn prefix is touched
+    QRandomGenerator *random = QRandomGenerator::global();
+    QVector<int> order(pool.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    QVector<int> selection;
+    qint64 total = 0;
+    int vsize = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        std::swap(order[i], order[i + static_cast<int>(random->bounded(order.size() - i))]);
+        const auto &candidate = pool[order[i]];
+        selection.append(order[i]);
+        total += candidate.effectiveValue;
+        vsize += candidate.vsize;
+        if (vsize > goal.maxVSize) {
+            return QVector<int>();
+        }
+        if (total >= goal.targetWithChange) {
+            return selection;
+        }
+    }
+    return QVector<int>();
+}
+
+} // namespace
+
+CoinSelector::CoinSelector()
+    : total(0)
+{
+}
+
+void CoinSelector::setUtxos(const QVector<UTXO> &utxos)
+{
+    entries.clear();
+    outpoints.clear();
+    total = 0;
+    entries.reserve(utxos.size());
+
+    for (const UTXO &utxo : utxos) {
+        int vsize = inputVSize(TransactionBuilder::hexToBytes(utxo.scriptPubKey));
+        QString key = outpoint(utxo.txid, utxo.vout);
+        if (vsize == 0 || utxo.value <= 0 || outpoints.contains(key)) {
+            continue;
+        }
+        outpoints.insert(key);
+        entries.append({utxo, vsize});
+        total += utxo.value;
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.utxo.value > b.utxo.value;
+    });
+}
+
+bool CoinSelector::addUtxo(const UTXO &utxo)
+{
+    int vsize = inputVSize(TransactionBuilder::hexToBytes(utxo.scriptPubKey));
+    QString key = outpoint(utxo.txid, utxo.vout);
+    if (vsize == 0 || utxo.value <= 0 || outpoints.contains(key)) {
+        return false;
+    }
+
+    auto position = std::upper_bound(entries.begin(), entries.end(), utxo.value,
+        [](qint64 value, const Entry &entry) { return value > entry.utxo.value; });
+    entries.insert(position, Entry{utxo, vsize});
+    outpoints.insert(key);
+    total += utxo.value;
+    return true;
+}
+
+bool CoinSelector::removeUtxo(const QString &txid, quint32 vout)
+{
+    if (!outpoints.remove(outpoint(txid, vout))) {
+        return false;
+    }
+
+    auto position = std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) {
+        return entry.utxo.vout == vout && entry.utxo.txid == txid;
+    });
+    if (position != entries.end()) {
+        total -= position->utxo.value;
+        entries.erase(position);
+    }
+    return true;
+}
+
+qint64 CoinSelector::maxSendable(const CoinSelectionParams &params, qint64 *fee) const
+{
+    // Same input budget as select(), so select() can fund the result
+    int maxVSize = MAX_STANDARD_TX_VSIZE - params.fixedVSize - params.changeOutputVSize;
+    qint64 value = 0;
+    qint64 inputFees = 0;
+    int vsize = 0;
+    for (const Entry &entry : entries) {
+        qint64 inputFee = feeFor(entry.vsize, params.feeRate);
+        if (entry.utxo.value <= inputFee || vsize + entry.vsize > maxVSize) {
+            continue;
+        }
+        value += entry.utxo.value;
+        inputFees += inputFee;
+        vsize += entry.vsize;
+    }
+
+    qint64 totalFee = inputFees + feeFor(params.fixedVSize, params.feeRate);
+    qint64 amount = value - totalFee;
+    if (amount < TransactionBuilder::BITCOIN_DUST_LIMIT) {
+        amount = 0;
+        totalFee = 0;
+    }
+    if (fee) {
+        *fee = totalFee;
+    }
+    return amount;
+}
+
+CoinSelection CoinSelector::select(qint64 amount, const CoinSelectionParams &params) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    CoinSelection selection;
+    if (amount <= 0 || entries.isEmpty()) {
+        return selection;
+    }
+
+    qint64 changeFee = feeFor(params.changeOutputVSize, params.feeRate);
+    SelectionTarget goal;
+    goal.target = amount + feeFor(params.fixedVSize, params.feeRate);
+    goal.targetWithChange = goal.target + changeFee + TransactionBuilder::BITCOIN_DUST_LIMIT;
+    goal.costOfChange = changeFee + feeFor(params.changeSpendVSize, params.longTermFeeRate);
+    goal.maxVSize = MAX_STANDARD_TX_VSIZE - params.fixedVSize - params.changeOutputVSize;
+
+    // Outputs worth less than their own input fee are never selected
+    QVector<Candidate> pool;
+    pool.reserve(entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries[i];
+        qint64 fee = feeFor(entry.vsize, params.feeRate);
+        if (entry.utxo.value > fee) {
+            pool.append({i, entry.utxo.value - fee, fee,
+                         feeFor(entry.vsize, params.longTermFeeRate), entry.vsize});
+        }
+    }
+
+    // The index order carries over unless input sizes differ enough to reorder
+    auto descending = [](const Candidate &a, const Candidate &b) {
+        return a.effectiveValue > b.effectiveValue;
+    };
+    if (!std::is_sorted(pool.begin(), pool.end(), descending)) {
+        std::stable_sort(pool.begin(), pool.end(), descending);
+    }
+
+    auto finish = [&](const QVector<int> &chosen, CoinSelection::Algorithm algorithm,
+                      bool allowChange) {
+        CoinSelection result;
+        result.algorithm = algorithm;
+        qint64 value = 0;
+        qint64 effectiveValue = 0;
+        qint64 inputWaste = 0;
+        for (int index : chosen) {
+            const Candidate &candidate = pool[index];
+            result.inputs.append(entries[candidate.entry].utxo);
+            value += entries[candidate.entry].utxo.value;
+            effectiveValue += candidate.effectiveValue;
+            inputWaste += candidate.fee - candidate.longTermFee;
+        }
+
+        qint64 excess = effectiveValue - goal.target;
+        if (allowChange && excess - changeFee >= TransactionBuilder::BITCOIN_DUST_LIMIT) {
+            result.change = excess - changeFee;
+            result.waste = inputWaste + goal.costOfChange;
+        } else {
+            result.waste = inputWaste + excess;
+        }
+        result.fee = value - amount - result.change;
+        return result;
+    };
+
+    bool feeRateHigh = params.feeRate > params.longTermFeeRate;
+    QVector<int> chosen = selectBranchAndBound(pool, goal, feeRateHigh, timer, params.timeBudgetMs);
+    if (!chosen.isEmpty()) {
+        return finish(chosen, CoinSelection::Algorithm::BranchAndBound, false);
+    }
+
+    // Fallbacks with change; the one wasting less wins
+    chosen = selectKnapsack(pool, goal, timer, params.timeBudgetMs);
+    if (!chosen.isEmpty()) {
+        selection = finish(chosen, CoinSelection::Algorithm::Knapsack, true);
+    }
+
+    chosen = selectRandomDraw(pool, goal);
+    if (!chosen.isEmpty()) {
+        CoinSelection drawn = finish(chosen, CoinSelection::Algorithm::SingleRandomDraw, true);
+        if (!selection.ok() || drawn.waste < selection.waste) {
+            selection = drawn;
+        }
+    }
+
+    return selection;
+}
+
+int CoinSelector::inputVSize(const QByteArray &scriptPubKey)
+{
+    // Outpoint, sequence and scriptSig length plus a typical signature.
+    // Only what BitcoinTransaction::signInput can sign: a selection that
+    // includes a P2PKH or P2SH input could never be broadcast.
+    switch (BitcoinTransaction::scriptType(scriptPubKey)) {
+    case BitcoinTransaction::ScriptType::P2WPKH:
+        return 68;
+    case BitcoinTransaction::ScriptType::P2TR:
+        return 58;
+    default:
+        return 0;
+    }
+}
+
+QString CoinSelector::outpoint(const QString &txid, quint32 vout)
+{
+    return txid + ":" + QString::number(vout);
+}
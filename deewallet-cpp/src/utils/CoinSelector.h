@@ -0,0 +1,87 @@
+/**
+ * DEE WALLET - Coin Selector
+ * Chooses the UTXOs that fund a payment from a value-sorted index of the
+ * wallet's unspent outputs. Branch-and-Bound looks for a changeless input
+ * set first; knapsack and single random draw are the fallbacks. Candidates
+ * are compared by waste: what their inputs cost now versus at the long-term
+ * fee rate, plus the change output or the excess given up to fees.
+ */
+
+#ifndef COINSELECTOR_H
+#define COINSELECTOR_H
+
+#include "TransactionBuilder.h"
+#include <QSet>
+
+struct CoinSelectionParams {
+    qint64 feeRate = 1000;              // sat per 1000 vbytes
+    qint64 longTermFeeRate = 10000;     // rate the inputs would be spent at later
+    int fixedVSize = 11 + 31;           // header, counts and one P2WPKH recipient
+    int changeOutputVSize = 31;         // P2WPKH change output
+    int changeSpendVSize = 68;          // spending that change later
+    int timeBudgetMs = 10;              // search budget for the whole selection
+};
+
+struct CoinSelection {
+    enum class Algorithm { None, BranchAndBound, Knapsack, SingleRandomDraw };
+
+    Algorithm algorithm = Algorithm::None;
+    QVector<UTXO> inputs;
+    qint64 fee = 0;         // total fee, including any excess dropped to fees
+    qint64 change = 0;      // 0 = changeless
+    qint64 waste = 0;
+
+    bool ok() const { return algorithm != Algorithm::None; }
+};
+
+class CoinSelector {
+public:
+    CoinSelector();
+
+    // Replaces the index; outputs with scripts the wallet cannot sign are skipped
+    void setUtxos(const QVector<UTXO> &utxos);
+    bool addUtxo(const UTXO &utxo);
+    bool removeUtxo(const QString &txid, quint32 vout);
+
+    int size() const { return entries.size(); }
+    qint64 totalValue() const { return total; }
+
+    // Inputs paying amount plus fees at params.feeRate
+    CoinSelection select(qint64 amount, const CoinSelectionParams &params = CoinSelectionParams()) const;
+
+    // Largest changeless payment: every output worth more than its input
+    // fee, largest first within the standardness limit. fee receives what
+    // that payment pays; 0 when nothing above dust can be sent.
+    qint64 maxSendable(const CoinSelectionParams &params, qint64 *fee = nullptr) const;
+
+    // Virtual size of an input spending scriptPubKey; 0 if the wallet cannot
+    // sign it (only P2WPKH and P2TR are signed)
+    static int inputVSize(const QByteArray &scriptPubKey);
+
+    static constexpr int MAX_STANDARD_TX_VSIZE = 100000;
+    static constexpr int BNB_MAX_TRIES = 100000;
+    static constexpr int KNAPSACK_ITERATIONS = 1000;
+
+private:
+    struct Entry {
+        UTXO utxo;
+        int vsize;
+    };
+
+    // Spendable entry at the current fee rate
+    struct Candidate {
+        int entry;
+        qint64 effectiveValue;  // value minus the fee to spend it
+        qint64 fee;
+        qint64 longTermFee;
+        int vsize;
+    };
+
+    static QString outpoint(const QString &txid, quint32 vout);
+
+    QVector<Entry> entries;     // descending value
+    QSet<QString> outpoints;
+    qint64 total;
+};
+
+#endif // COINSELECTOR_H
@@ -5,6 +5,7 @@
 
 #include "Keccak256.h"
 #include <cstring>
+#include <algorithm>
 
 const uint64_t Keccak256::ROUND_CONSTANTS[ROUNDS] = {
     0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
@@ -25,56 +26,94 @@ const int Keccak256::RHO_OFFSETS[STATE_SIZE] = {
     18, 2,  61, 56, 14
 };
 
-QByteArray Keccak256::hash(const QByteArray &input)
+Keccak256::Keccak256()
 {
-    // Keccak-256 parameters
-    constexpr int RATE = 136;  // 1088 bits / 8
-    constexpr int OUTPUT_LENGTH = 32;  // 256 bits / 8
+    reset();
+}
 
-    uint64_t state[STATE_SIZE] = {0};
+void Keccak256::reset()
+{
+    std::memset(state, 0, sizeof(state));
+    buffered = 0;
+}
 
-    // Absorb phase
-    int blockSize = RATE;
-    const uint8_t *data = reinterpret_cast<const uint8_t*>(input.constData());
-    size_t dataLen = input.size();
+void Keccak256::update(const QByteArray &data)
+{
+    update(reinterpret_cast<const uint8_t*>(data.constData()), static_cast<size_t>(data.size()));
+}
 
-    while (dataLen >= blockSize) {
-        for (int i = 0; i < blockSize / 8; ++i) {
-            uint64_t value = 0;
-            for (int j = 0; j < 8; ++j) {
-                value |= static_cast<uint64_t>(data[i * 8 + j]) << (8 * j);
-            }
-            state[i] ^= value;
+void Keccak256::update(const uint8_t *data, size_t length)
+{
+    // Top up a partial block first
+    if (buffered > 0) {
+        size_t take = std::min(length, RATE - buffered);
+        std::memcpy(buffer + buffered, data, take);
+        buffered += take;
+        data += take;
+        length -= take;
+
+        if (buffered < RATE) {
+            return;
         }
-        keccakF(state);
-        data += blockSize;
-        dataLen -= blockSize;
+        absorbBlock(buffer);
+        buffered = 0;
     }
 
+    // Whole blocks straight from the input
+    while (length >= RATE) {
+        absorbBlock(data);
+        data += RATE;
+        length -= RATE;
+    }
+
+    std::memcpy(buffer, data, length);
+    buffered = length;
+}
+
+void Keccak256::finalize(uint8_t output[32])
+{
+    constexpr int OUTPUT_LENGTH = 32;  // 256 bits / 8
+
     // Padding
-    uint8_t padded[RATE] = {0};
-    std::memcpy(padded, data, dataLen);
-    padded[dataLen] = 0x01;  // Keccak padding (not SHA3)
-    padded[blockSize - 1] |= 0x80;
+    std::memset(buffer + buffered, 0, RATE - buffered);
+    buffer[buffered] = 0x01;  // Keccak padding (not SHA3)
+    buffer[RATE - 1] |= 0x80;
+    absorbBlock(buffer);
 
-    for (int i = 0; i < blockSize / 8; ++i) {
-        uint64_t value = 0;
+    // Squeeze phase
+    for (int i = 0; i < OUTPUT_LENGTH / 8; ++i) {
         for (int j = 0; j < 8; ++j) {
-            value |= static_cast<uint64_t>(padded[i * 8 + j]) << (8 * j);
+            output[i * 8 + j] = static_cast<uint8_t>((state[i] >> (8 * j)) & 0xFF);
         }
-        state[i] ^= value;
     }
-    keccakF(state);
 
-    // Squeeze phase
-    QByteArray output;
-    for (int i = 0; i < OUTPUT_LENGTH / 8; ++i) {
+    reset();
+}
+
+void Keccak256::absorbBlock(const uint8_t *block)
+{
+    for (size_t i = 0; i < RATE / 8; ++i) {
+        uint64_t value = 0;
         for (int j = 0; j < 8; ++j) {
-            output.append(static_cast<char>((state[i] >> (8 * j)) & 0xFF));
+            value |= static_cast<uint64_t>(block[i * 8 + j]) << (8 * j);
         }
+        state[i] ^= value;
     }
+    keccakF(state);
+}
+
+QByteArray Keccak256::hash(const QByteArray &input)
+{
+    uint8_t digest[32];
+    hash(reinterpret_cast<const uint8_t*>(input.constData()), input.size(), digest);
+    return QByteArray(reinterpret_cast<const char*>(digest), sizeof(digest));
+}
 
-    return output;
+void Keccak256::hash(const uint8_t *data, size_t length, uint8_t output[32])
+{
+    Keccak256 keccak;
+    keccak.update(data, length);
+    keccak.finalize(output);
 }
 
 void Keccak256::keccakF(uint64_t state[STATE_SIZE])
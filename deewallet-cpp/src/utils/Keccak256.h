@@ -8,14 +8,28 @@
 
 #include <QByteArray>
 #include <cstdint>
+#include <cstddef>
 
 class Keccak256 {
 public:
+    // Incremental hashing: feed any number of update() calls, then finalize()
+    Keccak256();
+    void update(const uint8_t *data, size_t length);
+    void update(const QByteArray &data);
+    void finalize(uint8_t output[32]);
+    void reset();
+
     static QByteArray hash(const QByteArray &input);
 
+    // Hash into a caller-provided 32-byte buffer (no heap allocation)
+    static void hash(const uint8_t *data, size_t length, uint8_t output[32]);
+
 private:
     static constexpr int ROUNDS = 24;
     static constexpr int STATE_SIZE = 25;
+    static constexpr size_t RATE = 136;  // 1088 bits / 8
+
+    void absorbBlock(const uint8_t *block);
 
     static void keccakF(uint64_t state[STATE_SIZE]);
     static void theta(uint64_t state[STATE_SIZE]);
@@ -28,6 +42,10 @@ private:
 
     static const uint64_t ROUND_CONSTANTS[ROUNDS];
     static const int RHO_OFFSETS[STATE_SIZE];
+
+    uint64_t state[STATE_SIZE];
+    uint8_t buffer[RATE];   // partial block carried between update() calls
+    size_t buffered;
 };
 
 #endif // KECCAK256_H
@@ -0,0 +1,232 @@
+/**
+ * DEE WALLET - RLP Encoder Implementation
+ */
+
+#include "RLPEncoder.h"
+#include "Keccak256.h"
+#include <cstring>
+
+namespace {
+
+size_t headerSize(size_t length)
+{
+    return length < 56 ? 1 : 1 + RLPEncoder::lengthOfLength(length);
+}
+
+// Short form: offset + length; long form: offset + 55 + length-of-length,
+// then the length big-endian
+int writeHeader(uint8_t header[9], uint8_t offset, size_t length)
+{
+    if (length < 56) {
+        header[0] = static_cast<uint8_t>(offset + length);
+        return 1;
+    }
+
+    int lengthBytes = static_cast<int>(RLPEncoder::lengthOfLength(length));
+    header[0] = static_cast<uint8_t>(offset + 55 + lengthBytes);
+    for (int i = lengthBytes; i >= 1; --i) {
+        header[i] = static_cast<uint8_t>(length & 0xff);
+        length >>= 8;
+    }
+    return 1 + lengthBytes;
+}
+
+struct BufferSink {
+    uint8_t *out;
+
+    void put(const uint8_t *data, size_t length)
+    {
+        std::memcpy(out, data, length);
+        out += length;
+    }
+};
+
+struct KeccakSink {
+    Keccak256 &keccak;
+
+    void put(const uint8_t *data, size_t length)
+    {
+        keccak.update(data, length);
+    }
+};
+
+} // namespace
+
+RLPEncoder::RLPEncoder(int expectedItems)
+    : encodedSize(0)
+{
+    items.reserve(expectedItems);
+}
+
+size_t RLPEncoder::lengthOfLength(size_t length)
+{
+    size_t bytes = 0;
+    while (length > 0) {
+        ++bytes;
+        length >>= 8;
+    }
+    return bytes;
+}
+
+RLPEncoder &RLPEncoder::bytes(const uint8_t *data, size_t length)
+{
+    Item item;
+    item.kind = Kind::Bytes;
+    item.inlineLength = 0;
+    item.data = data;
+    item.length = length;
+    addString(item, data, length);
+    return *this;
+}
+
+RLPEncoder &RLPEncoder::bytes(const QByteArray &data)
+{
+    return bytes(reinterpret_cast<const uint8_t*>(data.constData()), static_cast<size_t>(data.size()));
+}
+
+RLPEncoder &RLPEncoder::uint(uint64_t value)
+{
+    Item item;
+    item.kind = Kind::Inline;
+    item.data = nullptr;
+
+    uint8_t bigEndian[8];
+    for (int i = 7; i >= 0; --i) {
+        bigEndian[i] = static_cast<uint8_t>(value & 0xff);
+        value >>= 8;
+    }
+
+    int skip = 0;
+    while (skip < 8 && bigEndian[skip] == 0) {
+        ++skip;
+    }
+    item.inlineLength = static_cast<uint8_t>(8 - skip);
+    item.length = item.inlineLength;
+    std::memcpy(item.inlineBytes, bigEndian + skip, item.inlineLength);
+
+    addString(item, item.inlineBytes, item.length);
+    return *this;
+}
+
+RLPEncoder &RLPEncoder::uint(const UInt256 &value)
+{
+    Item item;
+    item.kind = Kind::Inline;
+    item.data = nullptr;
+
+    uint8_t bigEndian[32];
+    value.toBigEndian(bigEndian);
+
+    int skip = 0;
+    while (skip < 32 && bigEndian[skip] == 0) {
+        ++skip;
+    }
+    item.inlineLength = static_cast<uint8_t>(32 - skip);
+    item.length = item.inlineLength;
+    std::memcpy(item.inlineBytes, bigEndian + skip, item.inlineLength);
+
+    addString(item, item.inlineBytes, item.length);
+    return *this;
+}
+
+RLPEncoder &RLPEncoder::beginList()
+{
+    Item item;
+    item.kind = Kind::List;
+    item.inlineLength = 0;
+    item.data = nullptr;
+    item.length = 0;
+
+    openLists.append(items.size());
+    items.append(item);
+    return *this;
+}
+
+RLPEncoder &RLPEncoder::endList()
+{
+    if (openLists.isEmpty()) {
+        return *this;
+    }
+
+    // The payload is complete; the list counts as one item of its parent
+    size_t payload = items[openLists.takeLast()].length;
+    size_t total = headerSize(payload) + payload;
+    if (openLists.isEmpty()) {
+        encodedSize += total;
+    } else {
+        items[openLists.last()].length += total;
+    }
+    return *this;
+}
+
+void RLPEncoder::addString(const Item &item, const uint8_t *data, size_t length)
+{
+    // A single byte below 0x80 is its own encoding
+    size_t total = length == 1 && data[0] < 0x80 ? 1 : headerSize(length) + length;
+    if (openLists.isEmpty()) {
+        encodedSize += total;
+    } else {
+        items[openLists.last()].length += total;
+    }
+    items.append(item);
+}
+
+template<typename Sink>
+void RLPEncoder::write(Sink &sink) const
+{
+    uint8_t header[9];
+    for (const Item &item : items) {
+        if (item.kind == Kind::List) {
+            sink.put(header, writeHeader(header, 0xc0, item.length));
+            continue;
+        }
+
+        const uint8_t *data = item.kind == Kind::Inline ? item.inlineBytes : item.data;
+        if (!(item.length == 1 && data[0] < 0x80)) {
+            sink.put(header, writeHeader(header, 0x80, item.length));
+        }
+        sink.put(data, item.length);
+    }
+}
+
+QByteArray RLPEncoder::encode() const
+{
+    QByteArray out(static_cast<int>(encodedSize), Qt::Uninitialized);
+    writeTo(reinterpret_cast<uint8_t*>(out.data()));
+    return out;
+}
+
+QByteArray RLPEncoder::encodeTyped(uint8_t typeByte) const
+{
+    QByteArray out(static_cast<int>(encodedSize) + 1, Qt::Uninitialized);
+    out[0] = static_cast<char>(typeByte);
+    writeTo(reinterpret_cast<uint8_t*>(out.data()) + 1);
+    return out;
+}
+
+void RLPEncoder::writeTo(uint8_t *out) const
+{
+    BufferSink sink{out};
+    write(sink);
+}
+
+void RLPEncoder::writeTo(Keccak256 &keccak) const
+{
+    KeccakSink sink{keccak};
+    write(sink);
+}
+
+void RLPEncoder::keccak(uint8_t hash[32]) const
+{
+    Keccak256 keccak;
+    writeTo(keccak);
+    keccak.finalize(hash);
+}
+
+void RLPEncoder::keccakTyped(uint8_t typeByte, uint8_t hash[32]) const
+{
+    Keccak256 keccak;
+    keccak.update(&typeByte, 1);
+    writeTo(keccak);
+    keccak.finalize(hash);
+}
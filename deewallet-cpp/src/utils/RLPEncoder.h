@@ -0,0 +1,69 @@
+/**
+ * DEE WALLET - RLP Encoder
+ * Two-pass Recursive Length Prefix encoding: item sizes are summed as the
+ * items are added, then the whole structure is written in one pass into an
+ * exactly-sized buffer or straight into a Keccak256 state
+ */
+
+#ifndef RLPENCODER_H
+#define RLPENCODER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <cstdint>
+#include <cstddef>
+#include "UInt256.h"
+
+class Keccak256;
+
+class RLPEncoder {
+public:
+    explicit RLPEncoder(int expectedItems = 16);
+
+    // Byte strings are views: the data must outlive the encoder
+    RLPEncoder &bytes(const uint8_t *data, size_t length);
+    RLPEncoder &bytes(const QByteArray &data);
+
+    // Big-endian integers without leading zeros (zero encodes as 0x80)
+    RLPEncoder &uint(uint64_t value);
+    RLPEncoder &uint(const UInt256 &value);
+
+    // Lists nest; every beginList() needs a matching endList()
+    RLPEncoder &beginList();
+    RLPEncoder &endList();
+
+    // Size of the finished encoding in bytes
+    size_t size() const { return encodedSize; }
+
+    // rlp(items), or typeByte || rlp(items) for an EIP-2718 typed envelope
+    QByteArray encode() const;
+    QByteArray encodeTyped(uint8_t typeByte) const;
+    void writeTo(uint8_t *out) const;
+
+    // Keccak-256 of the encoding without materializing it
+    void keccak(uint8_t hash[32]) const;
+    void keccakTyped(uint8_t typeByte, uint8_t hash[32]) const;
+    void writeTo(Keccak256 &keccak) const;
+
+    static size_t lengthOfLength(size_t length);
+
+private:
+    enum class Kind : uint8_t { Bytes, Inline, List };
+
+    struct Item {
+        Kind kind;
+        uint8_t inlineLength;       // Inline: integer bytes in inlineBytes
+        uint8_t inlineBytes[32];
+        const uint8_t *data;        // Bytes: view
+        size_t length;              // Bytes/Inline: string length; List: payload length
+    };
+
+    void addString(const Item &item, const uint8_t *data, size_t length);
+    template<typename Sink> void write(Sink &sink) const;
+
+    QVector<Item> items;            // pre-order; lists precede their children
+    QVector<int> openLists;
+    size_t encodedSize;
+};
+
+#endif // RLPENCODER_H
@@ -0,0 +1,996 @@
+/**
+ * DEE WALLET - secp256k1 Signing and Verification Implementation
+ */
+
+#include "Secp256k1.h"
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/obj_mac.h>
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+void hmacSha256(const uint8_t key[32], const uint8_t *data, size_t length, uint8_t out[32])
+{
+    unsigned int outLength = 32;
+    HMAC(EVP_sha256(), key, 32, data, length, out, &outLength);
+}
+
+// SHA256(SHA256(tag) || SHA256(tag) || parts...), BIP 340 tagged hash
+void taggedHashParts(const char *tag, std::initializer_list<QByteArray> parts, uint8_t out[32])
+{
+    EVP_MD_CTX *md = EVP_MD_CTX_new();
+    uint8_t tagHash[32];
+    EVP_Digest(tag, std::strlen(tag), tagHash, nullptr, EVP_sha256(), nullptr);
+
+    EVP_DigestInit_ex(md, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(md, tagHash, 32);
+    EVP_DigestUpdate(md, tagHash, 32);
+    for (const QByteArray &part : parts) {
+        EVP_DigestUpdate(md, part.constData(), static_cast<size_t>(part.size()));
+    }
+    EVP_DigestFinal_ex(md, out, nullptr);
+    EVP_MD_CTX_free(md);
+}
+
+QByteArray bytes32(const uint8_t *data)
+{
+    return QByteArray(reinterpret_cast<const char*>(data), 32);
+}
+
+// e = H_challenge(r || P || m) mod n
+void schnorrChallenge(const uint8_t r[32], const uint8_t publicKey[32], const uint8_t message[32],
+                      BIGNUM *e, const BIGNUM *order, BN_CTX *ctx)
+{
+    uint8_t hash[32];
+    taggedHashParts("BIP0340/challenge", {bytes32(r), bytes32(publicKey), bytes32(message)}, hash);
+    BN_bin2bn(hash, 32, e);
+    BN_nnmod(e, e, order, ctx);
+}
+
+// RFC 6979 section 3.2 with HMAC-SHA256. qlen = hlen = 256 bits, so
+// bits2octets is a single conditional subtraction of n.
+class NonceGenerator {
+public:
+    NonceGenerator(const uint8_t key[32], const uint8_t hash[32], const BIGNUM *order, BN_CTX *ctx)
+    {
+        uint8_t reducedHash[32];
+        BN_CTX_start(ctx);
+        BIGNUM *h = BN_CTX_get(ctx);
+        BN_bin2bn(hash, 32, h);
+        if (BN_cmp(h, order) >= 0) {
+            BN_sub(h, h, order);
+        }
+        BN_bn2binpad(h, reducedHash, 32);
+        BN_CTX_end(ctx);
+
+        std::memset(v, 0x01, sizeof(v));
+        std::memset(k, 0x00, sizeof(k));
+
+        // K = HMAC(K, V || 0x00 || x || h); V = HMAC(K, V); then again with 0x01
+        uint8_t seed[32 + 1 + 32 + 32];
+        for (uint8_t separator = 0; separator < 2; ++separator) {
+            std::memcpy(seed, v, 32);
+            seed[32] = separator;
+            std::memcpy(seed + 33, key, 32);
+            std::memcpy(seed + 65, reducedHash, 32);
+            hmacSha256(k, seed, sizeof(seed), k);
+            hmacSha256(k, v, 32, v);
+        }
+        OPENSSL_cleanse(seed, sizeof(seed));
+    }
+
+    ~NonceGenerator()
+    {
+        OPENSSL_cleanse(k, sizeof(k));
+        OPENSSL_cleanse(v, sizeof(v));
+    }
+
+    // Next candidate in [1, n-1], as a BIGNUM and as 32 big-endian bytes
+    void next(BIGNUM *nonce, uint8_t nonceBytes[32], const BIGNUM *order)
+    {
+        for (;;) {
+            if (started) {
+                // Rejected candidate: K = HMAC(K, V || 0x00); V = HMAC(K, V)
+                uint8_t retry[33];
+                std::memcpy(retry, v, 32);
+                retry[32] = 0x00;
+                hmacSha256(k, retry, sizeof(retry), k);
+                hmacSha256(k, v, 32, v);
+            }
+            started = true;
+
+            hmacSha256(k, v, 32, v);
+            BN_bin2bn(v, 32, nonce);
+            if (!BN_is_zero(nonce) && BN_cmp(nonce, order) < 0) {
+                std::memcpy(nonceBytes, v, 32);
+                return;
+            }
+        }
+    }
+
+private:
+    uint8_t k[32];
+    uint8_t v[32];
+    bool started = false;
+};
+
+// Curve parameters plus a fixed-base comb for k*G. With k = sum d_i 16^i,
+// table[i][j] = j*16^i*G + Q for a random blinding point Q, so
+// k*G = sum table[i][d_i] - 64Q. Each window scans its whole row and does
+// one addition whatever the digit, and Q keeps the table contents (and so
+// any coordinate-dependent timing) unrelated to the digits.
+class Context {
+public:
+    static const int WINDOWS = 64;
+    static const int WINDOW_SIZE = 16;
+
+    static const Context &instance()
+    {
+        static const Context context;
+        return context;
+    }
+
+    EC_GROUP *group;
+    const BIGNUM *order;
+    BIGNUM *halfOrder;
+    BIGNUM *fieldPrime;
+
+    void mulGenerator(const uint8_t scalar[32], EC_POINT *out, EC_POINT *entry,
+                      BIGNUM *x, BIGNUM *y, BN_CTX *ctx) const
+    {
+        uint8_t selected[64];
+        EC_POINT_copy(out, correction);
+        for (int i = 0; i < WINDOWS; ++i) {
+            int digit = (scalar[31 - i / 2] >> ((i & 1) * 4)) & 0x0f;
+
+            std::memset(selected, 0, sizeof(selected));
+            for (int j = 0; j < WINDOW_SIZE; ++j) {
+                uint8_t mask = static_cast<uint8_t>(-static_cast<int>(j == digit));
+                for (int b = 0; b < 64; ++b) {
+                    selected[b] |= table[i][j][b] & mask;
+                }
+            }
+
+            BN_bin2bn(selected, 32, x);
+            BN_bin2bn(selected + 32, 32, y);
+            EC_POINT_set_affine_coordinates(group, entry, x, y, ctx);
+            EC_POINT_add(group, out, out, entry, ctx);
+        }
+        OPENSSL_cleanse(selected, sizeof(selected));
+    }
+
+private:
+    Context()
+        : group(EC_GROUP_new_by_curve_name(NID_secp256k1))
+        , order(EC_GROUP_get0_order(group))
+        , halfOrder(BN_new())
+        , fieldPrime(BN_new())
+        , correction(EC_POINT_new(group))
+    {
+        BN_rshift1(halfOrder, order);
+
+        BN_CTX *ctx = BN_CTX_new();
+        EC_GROUP_get_curve(group, fieldPrime, nullptr, nullptr, ctx);
+        BN_CTX_start(ctx);
+        BIGNUM *blinding = BN_CTX_get(ctx);
+        BIGNUM *x = BN_CTX_get(ctx);
+        BIGNUM *y = BN_CTX_get(ctx);
+        EC_POINT *base = EC_POINT_dup(EC_GROUP_get0_generator(group), group);
+        EC_POINT *blindingPoint = EC_POINT_new(group);
+        EC_POINT *point = EC_POINT_new(group);
+
+        BN_priv_rand_range(blinding, order);
+        EC_POINT_mul(group, blindingPoint, blinding, nullptr, nullptr, ctx);
+
+        // Row i: Q, Q + 16^i G, Q + 2*16^i G, ...
+        for (int i = 0; i < WINDOWS; ++i) {
+            EC_POINT_copy(point, blindingPoint);
+            for (int j = 0; j < WINDOW_SIZE; ++j) {
+                EC_POINT_get_affine_coordinates(group, point, x, y, ctx);
+                BN_bn2binpad(x, table[i][j], 32);
+                BN_bn2binpad(y, table[i][j] + 32, 32);
+                EC_POINT_add(group, point, point, base, ctx);
+            }
+            for (int d = 0; d < 4; ++d) {
+                EC_POINT_dbl(group, base, base, ctx);
+            }
+        }
+
+        BN_set_word(x, WINDOWS);
+        EC_POINT_mul(group, correction, nullptr, blindingPoint, x, ctx);
+        EC_POINT_invert(group, correction, ctx);
+
+        BN_clear(blinding);
+        EC_POINT_free(point);
+        EC_POINT_free(blindingPoint);
+        EC_POINT_free(base);
+        BN_CTX_end(ctx);
+        BN_CTX_free(ctx);
+    }
+
+    ~Context()
+    {
+        OPENSSL_cleanse(table, sizeof(table));
+        EC_POINT_free(correction);
+        BN_free(fieldPrime);
+        BN_free(halfOrder);
+        EC_GROUP_free(group);
+    }
+
+    uint8_t table[WINDOWS][WINDOW_SIZE][64];   // affine x || y
+    EC_POINT *correction;                       // -64Q
+};
+
+// Per-key scratch state; one instance signs any number of hashes
+class Signer {
+public:
+    explicit Signer(const QByteArray &privateKey)
+        : context(Context::instance())
+        , ctx(BN_CTX_new())
+        , point(EC_POINT_new(context.group))
+        , entry(EC_POINT_new(context.group))
+        , valid(false)
+    {
+        BN_CTX_start(ctx);
+        d = BN_CTX_get(ctx);
+        z = BN_CTX_get(ctx);
+        k = BN_CTX_get(ctx);
+        x = BN_CTX_get(ctx);
+        y = BN_CTX_get(ctx);
+        r = BN_CTX_get(ctx);
+        s = BN_CTX_get(ctx);
+        BN_set_flags(d, BN_FLG_CONSTTIME);
+        BN_set_flags(k, BN_FLG_CONSTTIME);
+
+        if (privateKey.size() == 32 && y) {
+            std::memcpy(key, privateKey.constData(), 32);
+            BN_bin2bn(key, 32, d);
+            valid = !BN_is_zero(d) && BN_cmp(d, context.order) < 0;
+        } else {
+            std::memset(key, 0, sizeof(key));
+        }
+    }
+
+    ~Signer()
+    {
+        OPENSSL_cleanse(key, sizeof(key));
+        BN_clear(d);
+        BN_clear(k);
+        BN_CTX_end(ctx);
+        EC_POINT_free(entry);
+        EC_POINT_free(point);
+        BN_CTX_free(ctx);
+    }
+
+    bool isValid() const { return valid; }
+
+    RecoverableSignature sign(const uint8_t hash[32])
+    {
+        RecoverableSignature signature;
+        if (!valid) {
+            return signature;
+        }
+
+        const BIGNUM *order = context.order;
+        BN_bin2bn(hash, 32, z);
+
+        uint8_t nonceBytes[32];
+        NonceGenerator nonces(key, hash, order, ctx);
+        for (;;) {
+            nonces.next(k, nonceBytes, order);
+
+            // R = kG; r = R.x mod n
+            context.mulGenerator(nonceBytes, point, entry, x, y, ctx);
+            if (!EC_POINT_get_affine_coordinates(context.group, point, x, y, ctx)) {
+                break;
+            }
+            bool xOverflow = BN_cmp(x, order) >= 0;
+            BN_nnmod(r, x, order, ctx);
+            if (BN_is_zero(r)) {
+                continue;
+            }
+
+            // s = k^-1 (z + r d) mod n
+            BN_mod_mul(s, r, d, order, ctx);
+            BN_mod_add(s, s, z, order, ctx);
+            BN_mod_inverse(k, k, order, ctx);
+            BN_mod_mul(s, s, k, order, ctx);
+            if (BN_is_zero(s)) {
+                continue;
+            }
+
+            int recoveryId = (BN_is_odd(y) ? 1 : 0) | (xOverflow ? 2 : 0);
+
+            // Low S (EIP-2, BIP 62): negating s mirrors R across the x axis
+            if (BN_cmp(s, context.halfOrder) > 0) {
+                BN_sub(s, order, s);
+                recoveryId ^= 1;
+            }
+
+            signature.r = QByteArray(32, Qt::Uninitialized);
+            signature.s = QByteArray(32, Qt::Uninitialized);
+            BN_bn2binpad(r, reinterpret_cast<unsigned char*>(signature.r.data()), 32);
+            BN_bn2binpad(s, reinterpret_cast<unsigned char*>(signature.s.data()), 32);
+            signature.recoveryId = recoveryId;
+            break;
+        }
+        OPENSSL_cleanse(nonceBytes, sizeof(nonceBytes));
+        return signature;
+    }
+
+    // BIP 340: R = k'G with k' from the tagged nonce hash, flipped to even y
+    QByteArray signSchnorr(const uint8_t message[32], const uint8_t auxRand[32])
+    {
+        if (!valid) {
+            return QByteArray();
+        }
+
+        const BIGNUM *order = context.order;
+        uint8_t publicKeyX[32];
+        uint8_t secret[32];
+        uint8_t masked[32];
+        uint8_t nonceBytes[32];
+        uint8_t nonceX[32];
+        evenKey(z, publicKeyX);
+        BN_bn2binpad(z, secret, 32);
+
+        // t = d xor H_aux(a); k' = H_nonce(t || P || m) mod n
+        taggedHashParts("BIP0340/aux", {bytes32(auxRand)}, masked);
+        for (int i = 0; i < 32; ++i) {
+            masked[i] ^= secret[i];
+        }
+        taggedHashParts("BIP0340/nonce", {bytes32(masked), bytes32(publicKeyX), bytes32(message)}, nonceBytes);
+        BN_bin2bn(nonceBytes, 32, k);
+        BN_nnmod(k, k, order, ctx);
+
+        QByteArray signature;
+        if (!BN_is_zero(k)) {
+            BN_bn2binpad(k, nonceBytes, 32);
+            context.mulGenerator(nonceBytes, point, entry, x, y, ctx);
+            EC_POINT_get_affine_coordinates(context.group, point, x, y, ctx);
+            if (BN_is_odd(y)) {
+                BN_sub(k, order, k);
+            }
+            BN_bn2binpad(x, nonceX, 32);
+
+            // s = k + e d mod n
+            schnorrChallenge(nonceX, publicKeyX, message, r, order, ctx);
+            BN_mod_mul(s, r, z, order, ctx);
+            BN_mod_add(s, s, k, order, ctx);
+
+            signature = bytes32(nonceX);
+            signature.append(QByteArray(32, Qt::Uninitialized));
+            BN_bn2binpad(s, reinterpret_cast<unsigned char*>(signature.data()) + 32, 32);
+        }
+
+        OPENSSL_cleanse(secret, sizeof(secret));
+        OPENSSL_cleanse(masked, sizeof(masked));
+        OPENSSL_cleanse(nonceBytes, sizeof(nonceBytes));
+        BN_clear(z);
+        BN_clear(k);
+        return signature;
+    }
+
+    // BIP 341 taproot_tweak_seckey: d' + H_TapTweak(P || merkleRoot)
+    QByteArray tweakTaproot(const QByteArray &merkleRoot)
+    {
+        if (!valid) {
+            return QByteArray();
+        }
+
+        uint8_t publicKeyX[32];
+        uint8_t tweak[32];
+        evenKey(z, publicKeyX);
+        taggedHashParts("TapTweak", {bytes32(publicKeyX), merkleRoot}, tweak);
+        BN_bin2bn(tweak, 32, r);
+
+        QByteArray tweaked;
+        if (BN_cmp(r, context.order) < 0) {
+            BN_mod_add(z, z, r, context.order, ctx);
+            if (!BN_is_zero(z)) {
+                tweaked = QByteArray(32, Qt::Uninitialized);
+                BN_bn2binpad(z, reinterpret_cast<unsigned char*>(tweaked.data()), 32);
+            }
+        }
+        BN_clear(z);
+        return tweaked;
+    }
+
+    QByteArray publicKey(bool compressed)
+    {
+        if (!valid) {
+            return QByteArray();
+        }
+
+        context.mulGenerator(key, point, entry, x, y, ctx);
+        unsigned char out[65];
+        size_t length = EC_POINT_point2oct(context.group, point,
+                                           compressed ? POINT_CONVERSION_COMPRESSED
+                                                      : POINT_CONVERSION_UNCOMPRESSED,
+                                           out, sizeof(out), ctx);
+        return QByteArray(reinterpret_cast<const char*>(out), static_cast<int>(length));
+    }
+
+private:
+    // d, negated when d*G has odd y (BIP 340 keys are x-only, even y)
+    void evenKey(BIGNUM *out, uint8_t publicKeyX[32])
+    {
+        context.mulGenerator(key, point, entry, x, y, ctx);
+        EC_POINT_get_affine_coordinates(context.group, point, x, y, ctx);
+        BN_bn2binpad(x, publicKeyX, 32);
+        BN_copy(out, d);
+        if (BN_is_odd(y)) {
+            BN_sub(out, context.order, out);
+        }
+    }
+
+    const Context &context;
+    BN_CTX *ctx;
+    EC_POINT *point;
+    EC_POINT *entry;
+    BIGNUM *d, *z, *k, *x, *y, *r, *s;
+    uint8_t key[32];
+    bool valid;
+};
+
+// DER INTEGER: leading zeros stripped, 0x00 prefix if the top bit is set
+void appendDerInteger(QByteArray &out, const QByteArray &value)
+{
+    int start = 0;
+    while (start < value.size() - 1 && value[start] == 0) {
+        ++start;
+    }
+    bool pad = static_cast<uint8_t>(value[start]) & 0x80;
+
+    out.append(static_cast<char>(0x02));
+    out.append(static_cast<char>(value.size() - start + (pad ? 1 : 0)));
+    if (pad) {
+        out.append(static_cast<char>(0x00));
+    }
+    out.append(value.constData() + start, value.size() - start);
+}
+
+// (r, s) from strict-length DER, r || s, or r || s || v (v in 0..3 or 27..30)
+bool parseEcdsaSignature(const QByteArray &signature, uint8_t r[32], uint8_t s[32], int *recoveryId)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(signature.constData());
+    int size = signature.size();
+    *recoveryId = -1;
+
+    if (size == 64 || size == 65) {
+        std::memcpy(r, data, 32);
+        std::memcpy(s, data + 32, 32);
+        if (size == 65) {
+            int v = data[64] >= 27 ? data[64] - 27 : data[64];
+            if (v > 3) {
+                return false;
+            }
+            *recoveryId = v;
+        }
+        return true;
+    }
+
+    // 0x30 len 0x02 rlen r 0x02 slen s
+    if (size < 8 || data[0] != 0x30 || data[1] != size - 2) {
+        return false;
+    }
+    int offset = 2;
+    uint8_t *outputs[2] = {r, s};
+    for (uint8_t *out : outputs) {
+        if (offset + 2 > size || data[offset] != 0x02) {
+            return false;
+        }
+        int length = data[offset + 1];
+        offset += 2;
+        if (length == 0 || offset + length > size) {
+            return false;
+        }
+        const uint8_t *value = data + offset;
+        offset += length;
+        while (length > 1 && value[0] == 0) {
+            ++value;
+            --length;
+        }
+        if (length > 32) {
+            return false;
+        }
+        std::memset(out, 0, 32);
+        std::memcpy(out + 32 - length, value, length);
+    }
+    return offset == size;
+}
+
+// Curve point for x with the given y parity; false if x >= p or off the curve
+bool liftX(const Context &context, const uint8_t x[32], int yOdd, EC_POINT *out, BN_CTX *ctx)
+{
+    BN_CTX_start(ctx);
+    BIGNUM *value = BN_CTX_get(ctx);
+    bool ok = value && BN_bin2bn(x, 32, value)
+        && BN_cmp(value, context.fieldPrime) < 0
+        && EC_POINT_set_compressed_coordinates(context.group, out, value, yOdd, ctx);
+    BN_CTX_end(ctx);
+    return ok;
+}
+
+// Scalar in [0, n) as 32 big-endian bytes; the MSM reads it in windows
+QByteArray scalarBytes(const BIGNUM *value)
+{
+    QByteArray out(32, Qt::Uninitialized);
+    BN_bn2binpad(value, reinterpret_cast<unsigned char*>(out.data()), 32);
+    return out;
+}
+
+int scalarWindow(const QByteArray &scalar, int firstBit, int width)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t*>(scalar.constData());
+    int digit = 0;
+    for (int bit = std::min(firstBit + width, 256) - 1; bit >= firstBit; --bit) {
+        digit = (digit << 1) | ((bytes[31 - bit / 8] >> (bit % 8)) & 1);
+    }
+    return digit;
+}
+
+// Pippenger's bucket method: sum scalars[i] * points[i]. Per window every
+// point lands in the bucket of its digit (one addition), and the buckets
+// are folded with a running sum, so a window costs n + 2^(width+1)
+// additions instead of a doubling-and-add chain per point.
+bool multiScalarMul(const EC_GROUP *group, const QVector<const EC_POINT*> &points,
+                    const QVector<QByteArray> &scalars, EC_POINT *out, BN_CTX *ctx)
+{
+    int count = points.size();
+    int width = count < 8 ? 3 : count < 32 ? 4 : count < 128 ? 5 : count < 512 ? 6 : count < 2048 ? 7 : 8;
+    int windows = (256 + width - 1) / width;
+
+    QVector<EC_POINT*> buckets((1 << width) - 1);
+    for (EC_POINT *&bucket : buckets) {
+        bucket = EC_POINT_new(group);
+    }
+    EC_POINT *running = EC_POINT_new(group);
+    EC_POINT *windowSum = EC_POINT_new(group);
+
+    bool ok = running && windowSum && EC_POINT_set_to_infinity(group, out);
+    for (int window = windows - 1; ok && window >= 0; --window) {
+        for (int i = 0; i < width; ++i) {
+            ok &= EC_POINT_dbl(group, out, out, ctx) == 1;
+        }
+
+        for (EC_POINT *bucket : buckets) {
+            EC_POINT_set_to_infinity(group, bucket);
+        }
+        for (int i = 0; i < count; ++i) {
+            int digit = scalarWindow(scalars[i], window * width, width);
+            if (digit) {
+                ok &= EC_POINT_add(group, buckets[digit - 1], buckets[digit - 1], points[i], ctx) == 1;
+            }
+        }
+
+        // sum j * bucket[j] as a suffix sum of suffix sums
+        EC_POINT_set_to_infinity(group, running);
+        EC_POINT_set_to_infinity(group, windowSum);
+        for (int j = buckets.size() - 1; j >= 0; --j) {
+            ok &= EC_POINT_add(group, running, running, buckets[j], ctx) == 1;
+            ok &= EC_POINT_add(group, windowSum, windowSum, running, ctx) == 1;
+        }
+        ok &= EC_POINT_add(group, out, out, windowSum, ctx) == 1;
+    }
+
+    EC_POINT_free(windowSum);
+    EC_POINT_free(running);
+    for (EC_POINT *bucket : buckets) {
+        EC_POINT_free(bucket);
+    }
+    return ok;
+}
+
+// Standard ECDSA: R' = (z/s) G + (r/s) Q; valid if R'.x mod n == r
+bool verifyEcdsa(const Context &context, const uint8_t hash[32], const uint8_t rBytes[32],
+                 const uint8_t sBytes[32], const EC_POINT *publicKey, BN_CTX *ctx)
+{
+    BN_CTX_start(ctx);
+    BIGNUM *r = BN_CTX_get(ctx);
+    BIGNUM *s = BN_CTX_get(ctx);
+    BIGNUM *z = BN_CTX_get(ctx);
+    BIGNUM *u1 = BN_CTX_get(ctx);
+    BIGNUM *u2 = BN_CTX_get(ctx);
+    BIGNUM *x = BN_CTX_get(ctx);
+    EC_POINT *point = EC_POINT_new(context.group);
+
+    bool ok = point && x;
+    if (ok) {
+        BN_bin2bn(rBytes, 32, r);
+        BN_bin2bn(sBytes, 32, s);
+        BN_bin2bn(hash, 32, z);
+        ok = !BN_is_zero(r) && !BN_is_zero(s)
+            && BN_cmp(r, context.order) < 0 && BN_cmp(s, context.order) < 0
+            && BN_mod_inverse(s, s, context.order, ctx)
+            && BN_mod_mul(u1, z, s, context.order, ctx)
+            && BN_mod_mul(u2, r, s, context.order, ctx)
+            && EC_POINT_mul(context.group, point, u1, publicKey, u2, ctx)
+            && !EC_POINT_is_at_infinity(context.group, point)
+            && EC_POINT_get_affine_coordinates(context.group, point, x, nullptr, ctx)
+            && BN_nnmod(x, x, context.order, ctx)
+            && BN_cmp(x, r) == 0;
+    }
+
+    EC_POINT_free(point);
+    BN_CTX_end(ctx);
+    return ok;
+}
+
+// BIP 340: R' = sG - eP; valid if R' has even y and x == r
+bool verifySchnorrWith(const Context &context, const uint8_t message[32], const uint8_t *signature,
+                       const uint8_t publicKeyX[32], BN_CTX *ctx)
+{
+    BN_CTX_start(ctx);
+    BIGNUM *s = BN_CTX_get(ctx);
+    BIGNUM *e = BN_CTX_get(ctx);
+    BIGNUM *r = BN_CTX_get(ctx);
+    BIGNUM *x = BN_CTX_get(ctx);
+    BIGNUM *y = BN_CTX_get(ctx);
+    EC_POINT *publicKey = EC_POINT_new(context.group);
+    EC_POINT *point = EC_POINT_new(context.group);
+
+    bool ok = publicKey && point && y && liftX(context, publicKeyX, 0, publicKey, ctx);
+    if (ok) {
+        BN_bin2bn(signature, 32, r);
+        BN_bin2bn(signature + 32, 32, s);
+        schnorrChallenge(signature, publicKeyX, message, e, context.order, ctx);
+        ok = BN_cmp(r, context.fieldPrime) < 0 && BN_cmp(s, context.order) < 0
+            && BN_mod_sub(e, context.order, e, context.order, ctx)
+            && EC_POINT_mul(context.group, point, s, publicKey, e, ctx)
+            && !EC_POINT_is_at_infinity(context.group, point)
+            && EC_POINT_get_affine_coordinates(context.group, point, x, y, ctx)
+            && !BN_is_odd(y)
+            && BN_cmp(x, r) == 0;
+    }
+
+    EC_POINT_free(point);
+    EC_POINT_free(publicKey);
+    BN_CTX_end(ctx);
+    return ok;
+}
+
+bool verifySingle(const Context &context, const SignatureCheck &check, BN_CTX *ctx)
+{
+    if (check.hash.size() != 32) {
+        return false;
+    }
+    const uint8_t *hash = reinterpret_cast<const uint8_t*>(check.hash.constData());
+
+    if (check.scheme == SignatureCheck::Scheme::Schnorr) {
+        return check.signature.size() == 64 && check.publicKey.size() == 32
+            && verifySchnorrWith(context, hash,
+                                 reinterpret_cast<const uint8_t*>(check.signature.constData()),
+                                 reinterpret_cast<const uint8_t*>(check.publicKey.constData()), ctx);
+    }
+
+    uint8_t r[32];
+    uint8_t s[32];
+    int recoveryId = -1;
+    if (!parseEcdsaSignature(check.signature, r, s, &recoveryId)) {
+        return false;
+    }
+
+    EC_POINT *publicKey = EC_POINT_new(context.group);
+    bool ok = publicKey
+        && EC_POINT_oct2point(context.group, publicKey,
+                              reinterpret_cast<const unsigned char*>(check.publicKey.constData()),
+                              check.publicKey.size(), ctx)
+        && verifyEcdsa(context, hash, r, s, publicKey, ctx);
+    EC_POINT_free(publicKey);
+    return ok;
+}
+
+} // namespace
+
+QByteArray RecoverableSignature::toCompact(int vOffset) const
+{
+    if (!isValid()) {
+        return QByteArray();
+    }
+    QByteArray out = r + s;
+    out.append(static_cast<char>(recoveryId + vOffset));
+    return out;
+}
+
+QByteArray RecoverableSignature::toDer() const
+{
+    if (!isValid()) {
+        return QByteArray();
+    }
+
+    // At most 2 * (2 + 33) bytes of content, so the length fits one byte
+    QByteArray integers;
+    integers.reserve(70);
+    appendDerInteger(integers, r);
+    appendDerInteger(integers, s);
+
+    QByteArray out;
+    out.reserve(integers.size() + 2);
+    out.append(static_cast<char>(0x30));
+    out.append(static_cast<char>(integers.size()));
+    out.append(integers);
+    return out;
+}
+
+RecoverableSignature Secp256k1::signHash(const uint8_t hash[32], const QByteArray &privateKey)
+{
+    Signer signer(privateKey);
+    return signer.sign(hash);
+}
+
+QVector<RecoverableSignature> Secp256k1::signHashes(const QVector<QByteArray> &hashes,
+                                                    const QByteArray &privateKey)
+{
+    QVector<RecoverableSignature> signatures;
+    signatures.reserve(hashes.size());
+
+    Signer signer(privateKey);
+    for (const QByteArray &hash : hashes) {
+        signatures.append(hash.size() == 32
+            ? signer.sign(reinterpret_cast<const uint8_t*>(hash.constData()))
+            : RecoverableSignature());
+    }
+    return signatures;
+}
+
+QByteArray Secp256k1::signHashDer(const uint8_t hash[32], const QByteArray &privateKey)
+{
+    return signHash(hash, privateKey).toDer();
+}
+
+QByteArray Secp256k1::publicKey(const QByteArray &privateKey, bool compressed)
+{
+    Signer signer(privateKey);
+    return signer.publicKey(compressed);
+}
+
+QByteArray Secp256k1::signSchnorr(const uint8_t message[32], const QByteArray &privateKey,
+                                  const uint8_t auxRand[32])
+{
+    uint8_t fresh[32];
+    if (!auxRand) {
+        RAND_bytes(fresh, sizeof(fresh));
+        auxRand = fresh;
+    }
+
+    Signer signer(privateKey);
+    return signer.signSchnorr(message, auxRand);
+}
+
+QByteArray Secp256k1::tweakTaprootKey(const QByteArray &privateKey, const QByteArray &merkleRoot)
+{
+    Signer signer(privateKey);
+    return signer.tweakTaproot(merkleRoot);
+}
+
+void Secp256k1::taggedHash(const char *tag, const QByteArray &data, uint8_t out[32])
+{
+    taggedHashParts(tag, {data}, out);
+}
+
+void Secp256k1::warmUp()
+{
+    Context::instance();
+}
+
+bool Secp256k1::verifyHash(const uint8_t hash[32], const QByteArray &signature,
+                           const QByteArray &publicKey)
+{
+    SignatureCheck check;
+    check.publicKey = publicKey;
+    check.hash = QByteArray(reinterpret_cast<const char*>(hash), 32);
+    check.signature = signature;
+
+    BN_CTX *ctx = BN_CTX_new();
+    bool ok = ctx && verifySingle(Context::instance(), check, ctx);
+    BN_CTX_free(ctx);
+    return ok;
+}
+
+bool Secp256k1::verifySchnorr(const uint8_t message[32], const QByteArray &signature,
+                              const QByteArray &xOnlyPublicKey)
+{
+    SignatureCheck check;
+    check.scheme = SignatureCheck::Scheme::Schnorr;
+    check.publicKey = xOnlyPublicKey;
+    check.hash = QByteArray(reinterpret_cast<const char*>(message), 32);
+    check.signature = signature;
+
+    BN_CTX *ctx = BN_CTX_new();
+    bool ok = ctx && verifySingle(Context::instance(), check, ctx);
+    BN_CTX_free(ctx);
+    return ok;
+}
+
+bool Secp256k1::verifyBatch(const QVector<SignatureCheck> &checks, QVector<bool> *results)
+{
+    const Context &context = Context::instance();
+    const BIGNUM *order = context.order;
+    BN_CTX *ctx = BN_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+    BN_CTX_start(ctx);
+    BIGNUM *a = BN_CTX_get(ctx);
+    BIGNUM *t = BN_CTX_get(ctx);
+    BIGNUM *r = BN_CTX_get(ctx);
+    BIGNUM *s = BN_CTX_get(ctx);
+    BIGNUM *z = BN_CTX_get(ctx);
+    BIGNUM *generatorScalar = BN_CTX_get(ctx);
+    BN_zero(generatorScalar);
+
+    // With random a_i (a_0 = 1), every batched equation folds into
+    //   (sum of G coefficients) G + sum c_j T_j == infinity
+    // ECDSA:   s R - z G - r Q = 0      Schnorr: s G - R - e P = 0
+    // A public key that signs many inputs contributes a single term.
+    QVector<EC_POINT*> termPoints;
+    QVector<BIGNUM*> termScalars;
+    QHash<QByteArray, int> keyTerms;
+    QVector<int> batched;
+    QVector<bool> valid(checks.size(), true);
+
+    auto addTerm = [&](EC_POINT *point) -> int {
+        termPoints.append(point);
+        termScalars.append(BN_new());
+        BN_zero(termScalars.last());
+        return termScalars.size() - 1;
+    };
+    auto keyTerm = [&](const QByteArray &key, bool xOnly) -> int {
+        QByteArray id(1, xOnly ? 'x' : 'p');
+        id.append(key);
+        int existing = keyTerms.value(id, -1);
+        if (existing >= 0) {
+            return existing;
+        }
+        EC_POINT *point = EC_POINT_new(context.group);
+        bool parsed = xOnly
+            ? liftX(context, reinterpret_cast<const uint8_t*>(key.constData()), 0, point, ctx)
+            : EC_POINT_oct2point(context.group, point,
+                                 reinterpret_cast<const unsigned char*>(key.constData()), key.size(), ctx) == 1;
+        if (!parsed) {
+            EC_POINT_free(point);
+            return -1;
+        }
+        int index = addTerm(point);
+        keyTerms.insert(id, index);
+        return index;
+    };
+    auto nextCoefficient = [&]() {
+        if (batched.isEmpty()) {
+            BN_one(a);
+        } else if (!BN_rand_range(a, order) || BN_is_zero(a)) {
+            BN_one(a);
+        }
+    };
+
+    for (int i = 0; i < checks.size(); ++i) {
+        const SignatureCheck &check = checks[i];
+        if (check.hash.size() != 32) {
+            valid[i] = false;
+            continue;
+        }
+        const uint8_t *hash = reinterpret_cast<const uint8_t*>(check.hash.constData());
+
+        if (check.scheme == SignatureCheck::Scheme::Schnorr) {
+            const uint8_t *signature = reinterpret_cast<const uint8_t*>(check.signature.constData());
+            EC_POINT *nonce = EC_POINT_new(context.group);
+            int key = check.signature.size() == 64 && check.publicKey.size() == 32
+                ? keyTerm(check.publicKey, true) : -1;
+            if (key < 0 || !liftX(context, signature, 0, nonce, ctx)
+                || !BN_bin2bn(signature + 32, 32, s) || BN_cmp(s, order) >= 0) {
+                EC_POINT_free(nonce);
+                valid[i] = false;
+                continue;
+            }
+
+            nextCoefficient();
+            schnorrChallenge(signature, reinterpret_cast<const uint8_t*>(check.publicKey.constData()),
+                             hash, z, order, ctx);
+
+            // + a s G,  - a R,  - a e P
+            BN_mod_mul(t, a, s, order, ctx);
+            BN_mod_add(generatorScalar, generatorScalar, t, order, ctx);
+            int nonceTerm = addTerm(nonce);
+            BN_mod_sub(termScalars[nonceTerm], order, a, order, ctx);
+            BN_mod_mul(t, a, z, order, ctx);
+            BN_mod_sub(termScalars[key], termScalars[key], t, order, ctx);
+            batched.append(i);
+            continue;
+        }
+
+        // Only a recovery id pins down R; everything else is checked alone
+        uint8_t rBytes[32];
+        uint8_t sBytes[32];
+        int recoveryId = -1;
+        if (!parseEcdsaSignature(check.signature, rBytes, sBytes, &recoveryId)) {
+            valid[i] = false;
+            continue;
+        }
+        if (recoveryId < 0) {
+            valid[i] = verifySingle(context, check, ctx);
+            continue;
+        }
+
+        BN_bin2bn(rBytes, 32, r);
+        BN_bin2bn(sBytes, 32, s);
+        if (BN_is_zero(r) || BN_is_zero(s) || BN_cmp(r, order) >= 0 || BN_cmp(s, order) >= 0) {
+            valid[i] = false;
+            continue;
+        }
+
+        // R.x = r, or r + n when the recovery id says x overflowed n
+        uint8_t nonceX[32];
+        BN_copy(t, r);
+        if (recoveryId & 2) {
+            BN_add(t, t, order);
+        }
+        EC_POINT *nonce = EC_POINT_new(context.group);
+        int key = keyTerm(check.publicKey, false);
+        if (key < 0 || BN_num_bytes(t) > 32 || !BN_bn2binpad(t, nonceX, 32)
+            || !liftX(context, nonceX, recoveryId & 1, nonce, ctx)) {
+            EC_POINT_free(nonce);
+            valid[i] = verifySingle(context, check, ctx);
+            continue;
+        }
+
+        nextCoefficient();
+        BN_bin2bn(hash, 32, z);
+
+        // + a s R,  - a z G,  - a r Q
+        int nonceTerm = addTerm(nonce);
+        BN_mod_mul(termScalars[nonceTerm], a, s, order, ctx);
+        BN_mod_mul(t, a, z, order, ctx);
+        BN_mod_sub(generatorScalar, generatorScalar, t, order, ctx);
+        BN_mod_mul(t, a, r, order, ctx);
+        BN_mod_sub(termScalars[key], termScalars[key], t, order, ctx);
+        batched.append(i);
+    }
+
+    if (!batched.isEmpty()) {
+        QVector<const EC_POINT*> points;
+        QVector<QByteArray> scalars;
+        points.reserve(termPoints.size() + 1);
+        scalars.reserve(termPoints.size() + 1);
+        points.append(EC_GROUP_get0_generator(context.group));
+        scalars.append(scalarBytes(generatorScalar));
+        for (int j = 0; j < termPoints.size(); ++j) {
+            points.append(termPoints[j]);
+            scalars.append(scalarBytes(termScalars[j]));
+        }
+
+        EC_POINT *sum = EC_POINT_new(context.group);
+        bool batchValid = sum && multiScalarMul(context.group, points, scalars, sum, ctx)
+            && EC_POINT_is_at_infinity(context.group, sum);
+        EC_POINT_free(sum);
+
+        // Find the culprits (or a recovery id that did not match R)
+        if (!batchValid) {
+            for (int i : batched) {
+                valid[i] = verifySingle(context, checks[i], ctx);
+            }
+        }
+    }
+
+    for (EC_POINT *point : termPoints) {
+        EC_POINT_free(point);
+    }
+    for (BIGNUM *scalar : termScalars) {
+        BN_free(scalar);
+    }
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+
+    if (results) {
+        *results = valid;
+    }
+    return !valid.contains(false);
+}
@@ -0,0 +1,89 @@
+/**
+ * DEE WALLET - secp256k1 Signing and Verification
+ * Deterministic (RFC 6979) ECDSA over 32-byte message hashes with low-S
+ * normalization, the recovery id EVM and Tron signatures carry, and DER
+ * for Bitcoin, plus BIP 340 Schnorr for taproot. The curve and a blinded
+ * fixed-base table for k*G are built once per process and shared by every
+ * signing and verification path.
+ */
+
+#ifndef SECP256K1_H
+#define SECP256K1_H
+
+#include <QByteArray>
+#include <QVector>
+#include <cstdint>
+
+struct RecoverableSignature {
+    QByteArray r;               // 32 bytes big-endian
+    QByteArray s;               // 32 bytes big-endian, s <= n/2
+    int recoveryId = -1;        // 0..3; bit 0 = R.y parity, bit 1 = R.x >= n
+
+    bool isValid() const { return recoveryId >= 0; }
+
+    // r || s || (recoveryId + vOffset): 65 bytes, e.g. vOffset 27 for Tron
+    QByteArray toCompact(int vOffset = 0) const;
+
+    // Strict DER (BIP 66) SEQUENCE { INTEGER r, INTEGER s }
+    QByteArray toDer() const;
+};
+
+// One signature to check
+struct SignatureCheck {
+    enum class Scheme { Ecdsa, Schnorr };
+
+    Scheme scheme = Scheme::Ecdsa;
+    QByteArray publicKey;       // ECDSA: 33/65-byte SEC1; Schnorr: 32-byte x-only (BIP 340)
+    QByteArray hash;            // 32-byte message hash (Schnorr: the 32-byte message)
+    QByteArray signature;       // ECDSA: DER, r || s, or r || s || v; Schnorr: 64 bytes
+};
+
+class Secp256k1 {
+public:
+    // Invalid (recoveryId -1) for a key outside [1, n-1]
+    static RecoverableSignature signHash(const uint8_t hash[32], const QByteArray &privateKey);
+
+    // Several 32-byte hashes under one key; the key and scratch state are
+    // set up once for the whole batch
+    static QVector<RecoverableSignature> signHashes(const QVector<QByteArray> &hashes,
+                                                    const QByteArray &privateKey);
+
+    // DER signature for Bitcoin scripts (sighash type not appended)
+    static QByteArray signHashDer(const uint8_t hash[32], const QByteArray &privateKey);
+
+    // BIP 340 Schnorr signature (64 bytes) over a 32-byte message. A null
+    // auxRand draws fresh randomness; the signature is valid either way.
+    static QByteArray signSchnorr(const uint8_t message[32], const QByteArray &privateKey,
+                                  const uint8_t auxRand[32] = nullptr);
+
+    // BIP 341 key-path tweak: the private key behind the output key of a
+    // taproot output with internal key privateKey (BIP 86 when merkleRoot
+    // is empty)
+    static QByteArray tweakTaprootKey(const QByteArray &privateKey,
+                                      const QByteArray &merkleRoot = QByteArray());
+
+    // SHA256(SHA256(tag) || SHA256(tag) || data)
+    static void taggedHash(const char *tag, const QByteArray &data, uint8_t out[32]);
+
+    // 33-byte compressed or 65-byte uncompressed public key; empty if invalid
+    static QByteArray publicKey(const QByteArray &privateKey, bool compressed = true);
+
+    // Single checks. ECDSA accepts DER, r || s, or r || s || v signatures.
+    static bool verifyHash(const uint8_t hash[32], const QByteArray &signature,
+                           const QByteArray &publicKey);
+    static bool verifySchnorr(const uint8_t message[32], const QByteArray &signature,
+                              const QByteArray &xOnlyPublicKey);
+
+    // Checks many signatures with one multi-scalar multiplication over a
+    // random linear combination of their verification equations. Schnorr
+    // signatures and ECDSA signatures carrying a recovery id (EVM, Tron)
+    // join the batch; DER and plain r || s ECDSA leave R's y ambiguous and
+    // are checked one by one. A failed batch is redone singly, so results
+    // (if given) says which checks are invalid.
+    static bool verifyBatch(const QVector<SignatureCheck> &checks, QVector<bool> *results = nullptr);
+
+    // Builds the shared context ahead of the first signature
+    static void warmUp();
+};
+
+#endif // SECP256K1_H
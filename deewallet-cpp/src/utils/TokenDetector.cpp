@@ -3,23 +3,52 @@
  */
 
 #include "TokenDetector.h"
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
-#include <QEventLoop>
+#include "../rpc/RPCClient.h"
+#include "../rpc/HttpTransport.h"
+#include "../rpc/NetworkService.h"
+#include "../rpc/RPCManager.h"
+#include "../chains/EthereumAdapter.h"
+#include "UInt256.h"
+#include "Amount.h"
+#include "AddressValidator.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QUrl>
-#include <QUrl>
-
-// Popular token lists
-QVector<Token> TokenDetector::popularERC20Tokens = {
-    {"USDT", "Tether USD", "0xdac17f958d2ee523a2206206994597c13d831ec7", "0", 6},
-    {"USDC", "USD Coin", "0xa0b86991c6218b36c1d19d4a2e9eb0ce3606eb48", "0", 6},
-    {"DAI", "Dai Stablecoin", "0x6b175474e89094c44da98b954eedeac495271d0f", "0", 18},
-    {"WETH", "Wrapped Ether", "0xc02aaa39b223fe8d0a0e5c4f27ead9083c756cc2", "0", 18},
-    {"UNI", "Uniswap", "0x1f9840a85d5af5bf1d1762f925bdaddc4201f984", "0", 18},
+#include <cmath>
+
+// Popular token lists (EVM lists keyed by chain symbol)
+QMap<QString, QVector<Token>> TokenDetector::popularEVMTokens = {
+    {"ETH", {
+        {"USDT", "Tether USD", "0xdac17f958d2ee523a2206206994597c13d831ec7", "0", 6},
+        {"USDC", "USD Coin", "0xa0b86991c6218b36c1d19d4a2e9eb0ce3606eb48", "0", 6},
+        {"DAI", "Dai Stablecoin", "0x6b175474e89094c44da98b954eedeac495271d0f", "0", 18},
+        {"WETH", "Wrapped Ether", "0xc02aaa39b223fe8d0a0e5c4f27ead9083c756cc2", "0", 18},
+        {"UNI", "Uniswap", "0x1f9840a85d5af5bf1d1762f925bdaddc4201f984", "0", 18},
+    }},
+    {"BNB", {
+        {"USDT", "Tether USD", "0x55d398326f99059fF775485246999027B3197955", "0", 18},
+        {"USDC", "USD Coin", "0x8AC76a51cc950d9822D68b83fE1Ad97B32Cd580d", "0", 18},
+    }},
+    {"POL", {
+        {"USDT", "Tether USD", "0xc2132D05D31c914a87C6611C10748AEb04B58e8F", "0", 6},
+        {"USDC", "USD Coin", "0x3c499c542cEF5E3811e1192ce70d8cC03d5c3359", "0", 6},
+    }},
+    {"ARB", {
+        {"USDT", "Tether USD", "0xFd086bC7CD5C481DCC9C85ebE478A1C0b69FCbb9", "0", 6},
+        {"USDC", "USD Coin", "0xaf88d065e77c8cC2239327C5EDb3A432268e5831", "0", 6},
+    }},
+    {"OP", {
+        {"USDT", "Tether USD", "0x94b008aA00579c1307B0EF2c499aD98a8ce58e58", "0", 6},
+        {"USDC", "USD Coin", "0x0b2C639c533813f4Aa9D7837cAf62653d097Ff85", "0", 6},
+    }},
+    {"AVAX", {
+        {"USDT", "Tether USD", "0x9702230A8Ea53601f5cD2dc00fDBc13d4dF4A8c7", "0", 6},
+        {"USDC", "USD Coin", "0xB97EF9Ef8734C71904D8002F8b6Bc66Dd9c48a6E", "0", 6},
+    }},
+    {"BASE", {
+        {"USDC", "USD Coin", "0x833589fCD6eDb6E08f4c7C32D4f71b54bdA02913", "0", 6},
+    }},
 };
 
 QVector<Token> TokenDetector::popularTRC20Tokens = {
@@ -33,60 +62,77 @@ QVector<Token> TokenDetector::popularSPLTokens = {
     {"SOL", "Wrapped SOL", "So11111111111111111111111111111111111111112", "0", 9},
 };
 
-QVector<Token> TokenDetector::detectERC20Tokens(const QString &address)
+QVector<Token> TokenDetector::detectERC20Tokens(const QString &address, const QString &chainSymbol)
 {
-    QVector<Token> detectedTokens;
-
-    // Query popular ERC-20 tokens
-    for (Token token : popularERC20Tokens) {
-        // Encode balanceOf(address) call
-        QString data = encodeERC20BalanceOf(address);
+    QString symbol = chainSymbol == "Ethereum" ? QString("ETH") : chainSymbol;
+    return detectEVMTokenBalances(symbol, {address}, popularEVMTokens.value(symbol)).value(address);
+}
 
-        // Make eth_call to get balance
-        QNetworkAccessManager manager;
-        QNetworkRequest request(QUrl("https://eth.llamarpc.com"));
-        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+QMap<QString, QVector<Token>> TokenDetector::detectEVMTokenBalances(const QString &chainSymbol,
+                                                                    const QStringList &holders,
+                                                                    const QVector<Token> &tokens)
+{
+    QMap<QString, QVector<Token>> detectedTokens;
+    if (holders.isEmpty() || tokens.isEmpty()) {
+        return detectedTokens;
+    }
 
-        QJsonObject rpcRequest;
-        rpcRequest["jsonrpc"] = "2.0";
-        rpcRequest["method"] = "eth_call";
+    // One balanceOf per (holder, token) pair, in holder-major order
+    QVector<QPair<QString, QByteArray>> calls;
+    calls.reserve(holders.size() * tokens.size());
+    for (const QString &holder : holders) {
+        QByteArray callData = encodeBalanceOfCall(holder);
+        for (const Token &token : tokens) {
+            calls.append(qMakePair(token.contractAddress, callData));
+        }
+    }
 
+    // Each chunk is a single aggregate3 eth_call; all chunks share one JSON-RPC batch
+    RPCClient client(EthereumAdapter::getRpcUrl(chainSymbol));
+    client.setChainRoute(chainSymbol);
+    RPCBatch batch = client.batch();
+    QVector<QFuture<QJsonValue>> pending;
+    for (int offset = 0; offset < calls.size(); offset += MULTICALL_MAX_CALLS) {
         QJsonArray params;
         QJsonObject txObj;
-        txObj["to"] = token.contractAddress;
-        txObj["data"] = data;
+        txObj["to"] = MULTICALL3_ADDRESS;
+        txObj["data"] = "0x" + QString::fromLatin1(encodeAggregate3(calls.mid(offset, MULTICALL_MAX_CALLS)).toHex());
         params.append(txObj);
         params.append("latest");
-        rpcRequest["params"] = params;
-        rpcRequest["id"] = 1;
-
-        QJsonDocument doc(rpcRequest);
-        QByteArray requestData = doc.toJson(QJsonDocument::Compact);
-
-        QNetworkReply *reply = manager.post(request, requestData);
+        pending.append(batch.add("eth_call", params));
+    }
+    batch.send();
 
-        QEventLoop loop;
-        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
+    for (int chunk = 0; chunk < pending.size(); ++chunk) {
+        QString result = HttpTransport::waitFor(pending[chunk]).toString();
+        if (result.startsWith("0x")) {
+            result = result.mid(2);
+        }
 
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray response = reply->readAll();
-            QJsonDocument responseDoc = QJsonDocument::fromJson(response);
-            if (responseDoc.isObject()) {
-                QString result = responseDoc.object()["result"].toString();
+        QVector<QPair<bool, QByteArray>> results;
+        if (!decodeAggregate3(QByteArray::fromHex(result.toLatin1()), results)) {
+            continue;
+        }
 
-                // Parse hex balance
-                bool ok;
-                quint64 balance = result.toULongLong(&ok, 16);
+        int offset = chunk * MULTICALL_MAX_CALLS;
+        for (int i = 0; i < results.size() && offset + i < calls.size(); ++i) {
+            const QByteArray &returnData = results[i].second;
+            if (!results[i].first || returnData.size() < 32) {
+                continue;
+            }
 
-                if (ok && balance > 0) {
-                    token.balance = QString::number(balance / pow(10, token.decimals), 'f', token.decimals);
-                    detectedTokens.append(token);
-                }
+            // uint256 balance; full width so 18-decimal amounts don't overflow
+            UInt256 balance = UInt256::fromBigEndian(
+                reinterpret_cast<const uint8_t*>(returnData.constData()), 32);
+            if (balance.isZero()) {
+                continue;
             }
-        }
 
-        reply->deleteLater();
+            int index = offset + i;
+            Token token = tokens[index % tokens.size()];
+            token.balance = Amount(balance, token.decimals).toString();
+            detectedTokens[holders[index / tokens.size()]].append(token);
+        }
     }
 
     return detectedTokens;
@@ -97,19 +143,15 @@ QVector<Token> TokenDetector::detectTRC20Tokens(const QString &address)
     QVector<Token> detectedTokens;
 
     // TronGrid API for TRC-20 tokens
-    QString url = QString("https://api.trongrid.io/v1/accounts/%1/tokens").arg(address);
+    QString path = QString("/v1/accounts/%1/tokens").arg(address);
 
-    QNetworkAccessManager manager;
-    QNetworkRequest request(url);
-    QNetworkReply *reply = manager.get(request);
+    RPCManager *router = NetworkService::instance()->rpcManager();
+    HttpResponse reply = HttpTransport::waitFor(router->hasChain("TRX")
+        ? router->get("TRX", path)
+        : NetworkService::instance()->transport()->get(QUrl("https://api.trongrid.io" + path)));
 
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
-
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(response);
+    if (reply.ok()) {
+        QJsonDocument doc = QJsonDocument::fromJson(reply.body);
         if (doc.isObject()) {
             QJsonArray data = doc.object()["data"].toArray();
             for (const QJsonValue &val : data) {
@@ -119,15 +161,16 @@ QVector<Token> TokenDetector::detectTRC20Tokens(const QString &address)
                 token.symbol = tokenObj["symbol"].toString();
                 token.name = tokenObj["name"].toString();
                 token.contractAddress = tokenObj["token_id"].toString();
-                token.balance = tokenObj["balance"].toString();
+                // Raw integer units, scaled like the ERC-20 balances
                 token.decimals = tokenObj["decimals"].toInt();
+                token.balance = Amount(UInt256::fromDecimal(tokenObj["balance"].toString()),
+                                       token.decimals).toString();
 
                 detectedTokens.append(token);
             }
         }
     }
 
-    reply->deleteLater();
     return detectedTokens;
 }
 
@@ -136,15 +179,8 @@ QVector<Token> TokenDetector::detectSPLTokens(const QString &address)
     QVector<Token> detectedTokens;
 
     // Solana getTokenAccountsByOwner RPC call
-    QString endpoint = "https://api.mainnet-beta.solana.com";
-
-    QNetworkAccessManager manager;
-    QNetworkRequest request(endpoint);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    QJsonObject rpcRequest;
-    rpcRequest["jsonrpc"] = "2.0";
-    rpcRequest["method"] = "getTokenAccountsByOwner";
+    RPCClient client("https://api.mainnet-beta.solana.com");
+    client.setChainRoute("SOL");
 
     QJsonArray params;
     params.append(address);
@@ -157,51 +193,36 @@ QVector<Token> TokenDetector::detectSPLTokens(const QString &address)
     encodingObj["encoding"] = "jsonParsed";
     params.append(encodingObj);
 
-    rpcRequest["params"] = params;
-    rpcRequest["id"] = 1;
-
-    QJsonDocument doc(rpcRequest);
-    QByteArray requestData = doc.toJson(QJsonDocument::Compact);
-
-    QNetworkReply *reply = manager.post(request, requestData);
-
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+    QJsonValue result = client.call("getTokenAccountsByOwner", params);
+    if (result.isObject()) {
+        QJsonArray accounts = result.toObject()["value"].toArray();
 
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray response = reply->readAll();
-        QJsonDocument responseDoc = QJsonDocument::fromJson(response);
-        if (responseDoc.isObject()) {
-            QJsonObject result = responseDoc.object()["result"].toObject();
-            QJsonArray accounts = result["value"].toArray();
+        for (const QJsonValue &val : accounts) {
+            QJsonObject account = val.toObject();
+            QJsonObject accountData = account["account"].toObject()["data"].toObject();
+            QJsonObject parsed = accountData["parsed"].toObject();
+            QJsonObject info = parsed["info"].toObject();
 
-            for (const QJsonValue &val : accounts) {
-                QJsonObject account = val.toObject();
-                QJsonObject accountData = account["account"].toObject()["data"].toObject();
-                QJsonObject parsed = accountData["parsed"].toObject();
-                QJsonObject info = parsed["info"].toObject();
+            Token token;
+            token.contractAddress = info["mint"].toString();
+            token.balance = info["tokenAmount"].toObject()["uiAmountString"].toString();
+            token.decimals = info["tokenAmount"].toObject()["decimals"].toInt();
+            token.symbol = "SPL";  // Need additional lookup for symbol
+            token.name = "SPL Token";
 
-                Token token;
-                token.contractAddress = info["mint"].toString();
-                token.balance = info["tokenAmount"].toObject()["uiAmountString"].toString();
-                token.decimals = info["tokenAmount"].toObject()["decimals"].toInt();
-                token.symbol = "SPL";  // Need additional lookup for symbol
-                token.name = "SPL Token";
-
-                detectedTokens.append(token);
-            }
+            detectedTokens.append(token);
         }
     }
 
-    reply->deleteLater();
     return detectedTokens;
 }
 
 QVector<Token> TokenDetector::getPopularTokens(const QString &chainType)
 {
-    if (chainType == "ETH" || chainType == "Ethereum") {
-        return popularERC20Tokens;
+    if (chainType == "Ethereum") {
+        return popularEVMTokens.value("ETH");
+    } else if (popularEVMTokens.contains(chainType)) {
+        return popularEVMTokens.value(chainType);
     } else if (chainType == "TRX" || chainType == "Tron") {
         return popularTRC20Tokens;
     } else if (chainType == "SOL" || chainType == "Solana") {
@@ -224,8 +245,8 @@ bool TokenDetector::addCustomToken(const QString &chainType,
     token.balance = "0";
     token.decimals = decimals;
 
-    if (chainType == "ETH") {
-        popularERC20Tokens.append(token);
+    if (AddressValidator::isEvmChain(chainType) && chainType != "Ethereum") {
+        popularEVMTokens[chainType].append(token);
         return true;
     } else if (chainType == "TRX") {
         popularTRC20Tokens.append(token);
@@ -257,7 +278,8 @@ QString TokenDetector::encodeERC20Transfer(const QString &to, const QString &amo
         cleanAddress = cleanAddress.mid(2);
     }
 
-    QString amountHex = QString::number(amount.toULongLong(), 16).rightJustified(64, '0');
+    // Base units as a full uint256 word (quint64 overflows at 18.4 tokens of 18 decimals)
+    QString amountHex = QString::fromLatin1(UInt256::fromDecimal(amount).toBigEndian().toHex());
 
     return "0xa9059cbb" + cleanAddress.rightJustified(64, '0') + amountHex;
 }
@@ -271,3 +293,117 @@ QString TokenDetector::encodeTRC20Transfer(const QString &to, const QString &amo
 {
     return encodeERC20Transfer(to, amount);
 }
+
+QByteArray TokenDetector::encodeBalanceOfCall(const QString &holder)
+{
+    // balanceOf(address) = 0x70a08231 + left-padded 20-byte address
+    QString cleanAddress = holder.startsWith("0x", Qt::CaseInsensitive) ? holder.mid(2) : holder;
+
+    QByteArray callData = QByteArray::fromHex("70a08231");
+    callData.append(QByteArray(12, '\0'));
+    callData.append(QByteArray::fromHex(cleanAddress.toLatin1()).rightJustified(20, '\0'));
+    return callData;
+}
+
+QByteArray TokenDetector::encodeAggregate3(const QVector<QPair<QString, QByteArray>> &calls)
+{
+    // Layout (each cell 32 bytes):
+    //   selector | offset(array) | length | offset[i]... | tuple[i]...
+    //   tuple = target | allowFailure | offset(bytes)=0x60 | bytes length | bytes (padded)
+    auto appendWord = [](QByteArray &out, quint64 value) {
+        char word[32] = {0};
+        for (int i = 0; i < 8; ++i) {
+            word[31 - i] = static_cast<char>((value >> (i * 8)) & 0xff);
+        }
+        out.append(word, 32);
+    };
+
+    QByteArray encoded = QByteArray::fromHex("82ad56cb");
+    appendWord(encoded, 0x20);
+    appendWord(encoded, calls.size());
+
+    // Tuple offsets are relative to the first offset word
+    quint64 tupleOffset = static_cast<quint64>(calls.size()) * 32;
+    for (const auto &call : calls) {
+        appendWord(encoded, tupleOffset);
+        int paddedLength = (call.second.size() + 31) / 32 * 32;
+        tupleOffset += 4 * 32 + paddedLength;
+    }
+
+    for (const auto &call : calls) {
+        QString target = call.first.startsWith("0x", Qt::CaseInsensitive) ? call.first.mid(2) : call.first;
+        encoded.append(QByteArray(12, '\0'));
+        encoded.append(QByteArray::fromHex(target.toLatin1()).rightJustified(20, '\0'));
+        appendWord(encoded, 1);  // allowFailure: a reverting token must not sink the batch
+        appendWord(encoded, 0x60);
+        appendWord(encoded, call.second.size());
+
+        int paddedLength = (call.second.size() + 31) / 32 * 32;
+        encoded.append(call.second);
+        encoded.append(QByteArray(paddedLength - call.second.size(), '\0'));
+    }
+
+    return encoded;
+}
+
+bool TokenDetector::decodeAggregate3(const QByteArray &returnData,
+                                     QVector<QPair<bool, QByteArray>> &results)
+{
+    // Result[] = (bool success, bytes returnData)[]; every offset is bounds-checked
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(returnData.constData());
+    const quint64 size = static_cast<quint64>(returnData.size());
+
+    auto readWord = [data, size](quint64 position, quint64 &value) {
+        if (position + 32 > size) {
+            return false;
+        }
+        // Anything above 64 bits is not a sane offset or length here
+        for (int i = 0; i < 24; ++i) {
+            if (data[position + i] != 0) {
+                return false;
+            }
+        }
+        value = 0;
+        for (int i = 24; i < 32; ++i) {
+            value = (value << 8) | data[position + i];
+        }
+        return true;
+    };
+
+    quint64 arrayOffset = 0;
+    quint64 count = 0;
+    if (!readWord(0, arrayOffset) || !readWord(arrayOffset, count) || count > size / 32) {
+        return false;
+    }
+
+    const quint64 headStart = arrayOffset + 32;
+    results.clear();
+    results.reserve(static_cast<int>(count));
+
+    for (quint64 i = 0; i < count; ++i) {
+        quint64 tupleOffset = 0;
+        quint64 success = 0;
+        quint64 bytesOffset = 0;
+        quint64 bytesLength = 0;
+        if (!readWord(headStart + i * 32, tupleOffset)) {
+            return false;
+        }
+
+        quint64 tupleStart = headStart + tupleOffset;
+        if (!readWord(tupleStart, success) ||
+            !readWord(tupleStart + 32, bytesOffset) ||
+            !readWord(tupleStart + bytesOffset, bytesLength)) {
+            return false;
+        }
+
+        quint64 bytesStart = tupleStart + bytesOffset + 32;
+        if (bytesLength > size || bytesStart + bytesLength > size) {
+            return false;
+        }
+
+        results.append(qMakePair(success != 0,
+                                 returnData.mid(static_cast<int>(bytesStart), static_cast<int>(bytesLength))));
+    }
+
+    return true;
+}
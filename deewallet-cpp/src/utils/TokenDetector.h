@@ -7,13 +7,23 @@
 #define TOKENDETECTOR_H
 
 #include <QString>
+#include <QStringList>
 #include <QVector>
+#include <QMap>
+#include <QPair>
+#include <QByteArray>
 #include "../chains/ChainAdapter.h"
 
 class TokenDetector {
 public:
-    // Detect ERC-20 tokens for Ethereum address
-    static QVector<Token> detectERC20Tokens(const QString &address);
+    // Detect ERC-20 tokens for an address on any EVM chain (ETH, BNB, POL, ...)
+    static QVector<Token> detectERC20Tokens(const QString &address, const QString &chainSymbol = "ETH");
+
+    // balanceOf for every (token, holder) pair through Multicall3 aggregate3.
+    // Returns holder -> tokens with a non-zero balance.
+    static QMap<QString, QVector<Token>> detectEVMTokenBalances(const QString &chainSymbol,
+                                                                const QStringList &holders,
+                                                                const QVector<Token> &tokens);
 
     // Detect TRC-20 tokens for Tron address
     static QVector<Token> detectTRC20Tokens(const QString &address);
@@ -39,8 +49,22 @@ public:
     static QString encodeTRC20BalanceOf(const QString &address);
     static QString encodeTRC20Transfer(const QString &to, const QString &amount);
 
+    // Multicall3 aggregate3((address,bool,bytes)[]) ABI encoding / decoding.
+    // Calls are (target, callData); results are (success, returnData).
+    static QByteArray encodeAggregate3(const QVector<QPair<QString, QByteArray>> &calls);
+    static bool decodeAggregate3(const QByteArray &returnData,
+                                 QVector<QPair<bool, QByteArray>> &results);
+
+    // Same address on every supported EVM chain
+    static constexpr const char *MULTICALL3_ADDRESS = "0xcA11bde05977b3631167028862bE2a173976CA11";
+
 private:
-    static QVector<Token> popularERC20Tokens;
+    // Keeps each aggregate3 eth_call well under node gas caps
+    static constexpr int MULTICALL_MAX_CALLS = 500;
+
+    static QByteArray encodeBalanceOfCall(const QString &holder);
+
+    static QMap<QString, QVector<Token>> popularEVMTokens;
     static QVector<Token> popularTRC20Tokens;
     static QVector<Token> popularSPLTokens;
 };
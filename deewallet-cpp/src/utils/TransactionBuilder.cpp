@@ -3,143 +3,177 @@
  */
 
 #include "TransactionBuilder.h"
+#include "RLPEncoder.h"
+#include "Secp256k1.h"
+#include "UInt256.h"
 #include <openssl/ec.h>
 #include <openssl/ecdsa.h>
 #include <openssl/sha.h>
-#include <QDataStream>
-#include <QIODevice>
-#include <QIODevice>
-
-QByteArray TransactionBuilder::buildBitcoinTransaction(const QVector<UTXO> &inputs,
-                                                       const QString &toAddress,
-                                                       qint64 amount,
-                                                       qint64 fee,
-                                                       const QString &changeAddress)
-{
-    // Simplified Bitcoin transaction building
-    // Real implementation requires:
-    // - UTXO selection
-    // - Witness data for SegWit
-    // - Proper script generation
-    // - Complete serialization
-
-    QByteArray tx;
-    QDataStream stream(&tx, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
 
-    // Version
-    stream << (quint32)2;
+namespace {
 
-    // Input count
-    stream << (quint8)inputs.size();
+// Decoded byte fields of an EthereumTx; the encoder only holds views into them
+struct EthereumTxBytes {
+    QByteArray to;
+    QByteArray data;
+    QVector<QByteArray> accessList;     // addresses and storage keys, in order
+};
 
-    // Inputs (simplified)
-    for (const UTXO &utxo : inputs) {
-        // Previous txid (reversed)
-        QByteArray txid = hexToBytes(utxo.txid);
-        std::reverse(txid.begin(), txid.end());
-        stream.writeRawData(txid.constData(), 32);
+struct EthereumSignature {
+    int recoveryId;
+    QByteArray r;
+    QByteArray s;
+};
 
-        // Vout
-        stream << utxo.vout;
+void encodeEthereumFields(RLPEncoder &rlp, const EthereumTx &tx, EthereumTxBytes &bytes,
+                          const EthereumSignature *signature)
+{
+    bytes.to = TransactionBuilder::hexToBytes(tx.to);
+    bytes.data = TransactionBuilder::hexToBytes(tx.data);
 
-        // ScriptSig (empty for unsigned)
-        stream << (quint8)0;
+    rlp.beginList();
+    if (tx.type != 0) {
+        rlp.uint(static_cast<uint64_t>(tx.chainId));
+    }
+    rlp.uint(UInt256::fromHex(tx.nonce));
+    if (tx.type == 2) {
+        rlp.uint(UInt256::fromHex(tx.maxPriorityFeePerGas));
+        rlp.uint(UInt256::fromHex(tx.maxFeePerGas));
+    } else {
+        rlp.uint(UInt256::fromHex(tx.gasPrice));
+    }
+    rlp.uint(UInt256::fromHex(tx.gasLimit));
+    rlp.bytes(bytes.to);
+    rlp.uint(UInt256::fromHex(tx.value));
+    rlp.bytes(bytes.data);
+
+    if (tx.type != 0) {
+        // Sized up front so the views stay put
+        int count = 0;
+        for (const AccessListEntry &entry : tx.accessList) {
+            count += 1 + entry.storageKeys.size();
+        }
+        bytes.accessList.reserve(count);
+
+        rlp.beginList();
+        for (const AccessListEntry &entry : tx.accessList) {
+            bytes.accessList.append(TransactionBuilder::hexToBytes(entry.address));
+            rlp.beginList().bytes(bytes.accessList.last()).beginList();
+            for (const QString &key : entry.storageKeys) {
+                bytes.accessList.append(TransactionBuilder::hexToBytes(key));
+                rlp.bytes(bytes.accessList.last());
+            }
+            rlp.endList().endList();
+        }
+        rlp.endList();
+    }
 
-        // Sequence
-        stream << (quint32)0xffffffff;
+    if (signature) {
+        // r and s are integers: no leading zeros
+        const QByteArray &r = signature->r;
+        const QByteArray &s = signature->s;
+        if (tx.type != 0) {
+            rlp.uint(static_cast<uint64_t>(signature->recoveryId));
+        } else if (tx.chainId > 0) {
+            rlp.uint(static_cast<uint64_t>(signature->recoveryId) + 35 + 2 * static_cast<uint64_t>(tx.chainId));
+        } else {
+            rlp.uint(static_cast<uint64_t>(signature->recoveryId) + 27);
+        }
+        rlp.uint(UInt256::fromBigEndian(reinterpret_cast<const uint8_t*>(r.constData()), r.size()));
+        rlp.uint(UInt256::fromBigEndian(reinterpret_cast<const uint8_t*>(s.constData()), s.size()));
+    } else if (tx.type == 0 && tx.chainId > 0) {
+        // EIP-155: chain id, 0, 0 take the place of v, r, s
+        rlp.uint(static_cast<uint64_t>(tx.chainId));
+        rlp.uint(static_cast<uint64_t>(0));
+        rlp.uint(static_cast<uint64_t>(0));
     }
+    rlp.endList();
+}
 
-    // Output count (2: recipient + change)
-    stream << (quint8)2;
+} // namespace
 
-    // Recipient output
-    stream << amount;
-    // ScriptPubKey (simplified)
-    stream << (quint8)0;  // Will be filled with actual script
+BitcoinTransaction TransactionBuilder::buildBitcoinTransaction(const QVector<UTXO> &inputs,
+                                                               const QByteArray &toScript,
+                                                               qint64 amount,
+                                                               qint64 fee,
+                                                               const QByteArray &changeScript)
+{
+    qint64 total = 0;
+    for (const UTXO &utxo : inputs) {
+        total += utxo.value;
+    }
 
-    // Change output
-    qint64 changeAmount = 0;
+    // Inputs that cannot pay the amount and the fee would give a transaction
+    // every node rejects (or a fee other than the one quoted); build nothing
+    if (amount <= 0 || fee < 0 || total < amount + fee) {
+        return BitcoinTransaction();
+    }
+
+    BitcoinTransaction tx;
     for (const UTXO &utxo : inputs) {
-        changeAmount += utxo.value;
+        tx.addInput(utxo.txid, utxo.vout, utxo.value, hexToBytes(utxo.scriptPubKey));
     }
-    changeAmount -= (amount + fee);
 
-    stream << changeAmount;
-    stream << (quint8)0;  // Change script
+    tx.addOutput(amount, toScript);
 
-    // Locktime
-    stream << (quint32)0;
+    // Change below the dust limit is left to the fee
+    qint64 change = total - amount - fee;
+    if (change >= BITCOIN_DUST_LIMIT && !changeScript.isEmpty()) {
+        tx.addOutput(change, changeScript);
+    }
 
     return tx;
 }
 
-QByteArray TransactionBuilder::signBitcoinInput(const QByteArray &tx,
-                                               int inputIndex,
-                                               const QByteArray &privateKey,
-                                               const QString &scriptPubKey)
+bool TransactionBuilder::signBitcoinInput(BitcoinTransaction &tx,
+                                          int inputIndex,
+                                          const QByteArray &privateKey)
 {
-    // Simplified SegWit signing
-    // Real implementation requires:
-    // - Proper sighash calculation (BIP143)
-    // - ECDSA signature with secp256k1
-    // - DER encoding
-    // - Witness data construction
-
-    // TODO: Implement full BIP143 SegWit signing
-    return QByteArray();
+    return tx.signInput(inputIndex, privateKey);
 }
 
 QByteArray TransactionBuilder::encodeRLP(const EthereumTx &tx)
 {
-    // RLP encoding for Ethereum transactions
-    QVector<QByteArray> fields;
-
-    // Nonce
-    fields.append(hexToBytes(tx.nonce));
-
-    // Gas price
-    fields.append(hexToBytes(tx.gasPrice));
-
-    // Gas limit
-    fields.append(hexToBytes(tx.gasLimit));
-
-    // To address
-    fields.append(hexToBytes(tx.to));
-
-    // Value
-    fields.append(hexToBytes(tx.value));
-
-    // Data
-    fields.append(hexToBytes(tx.data.isEmpty() ? "0x" : tx.data));
+    RLPEncoder rlp(32);
+    EthereumTxBytes bytes;
+    encodeEthereumFields(rlp, tx, bytes, nullptr);
+    return tx.type == 0 ? rlp.encode() : rlp.encodeTyped(static_cast<uint8_t>(tx.type));
+}
 
-    // Chain ID (for EIP-155)
-    if (tx.chainId > 0) {
-        fields.append(encodeVarint(tx.chainId));
-        fields.append(QByteArray());  // r
-        fields.append(QByteArray());  // s
+void TransactionBuilder::ethereumSigningHash(const EthereumTx &tx, uint8_t hash[32])
+{
+    RLPEncoder rlp(32);
+    EthereumTxBytes bytes;
+    encodeEthereumFields(rlp, tx, bytes, nullptr);
+    if (tx.type == 0) {
+        rlp.keccak(hash);
+    } else {
+        rlp.keccakTyped(static_cast<uint8_t>(tx.type), hash);
     }
+}
 
-    return encodeRLPList(fields);
+QByteArray TransactionBuilder::encodeSignedEthereumTransaction(const EthereumTx &tx, int recoveryId,
+                                                               const QByteArray &r, const QByteArray &s)
+{
+    RLPEncoder rlp(32);
+    EthereumTxBytes bytes;
+    EthereumSignature signature{recoveryId, r, s};
+    encodeEthereumFields(rlp, tx, bytes, &signature);
+    return tx.type == 0 ? rlp.encode() : rlp.encodeTyped(static_cast<uint8_t>(tx.type));
 }
 
 QByteArray TransactionBuilder::signEthereumTransaction(const EthereumTx &tx,
                                                        const QByteArray &privateKey)
 {
-    // Encode transaction
-    QByteArray rlp = encodeRLP(tx);
-
-    // Keccak256 hash
-    unsigned char hash[32];
-    SHA256(reinterpret_cast<const unsigned char*>(rlp.constData()), rlp.size(), hash);
+    // Keccak256 of the signing payload, signed with a recoverable signature
+    uint8_t hash[32];
+    ethereumSigningHash(tx, hash);
 
-    // TODO: Implement ECDSA signature with secp256k1
-    // Real implementation requires:
-    // - secp256k1 curve
-    // - Recoverable signature (v, r, s)
-    // - Proper RLP encoding with signature
-
-    return QByteArray();
+    RecoverableSignature signature = Secp256k1::signHash(hash, privateKey);
+    if (!signature.isValid()) {
+        return QByteArray();
+    }
+    return encodeSignedEthereumTransaction(tx, signature.recoveryId, signature.r, signature.s);
 }
 
 QByteArray TransactionBuilder::buildTronTransaction(const QString &from,
@@ -160,13 +194,12 @@ QByteArray TransactionBuilder::buildTronTransaction(const QString &from,
 QByteArray TransactionBuilder::signTronTransaction(const QByteArray &txBytes,
                                                   const QByteArray &privateKey)
 {
-    // Tron signature (SHA256 + ECDSA)
+    // Tron signature: ECDSA over SHA256(raw_data), r || s || v with v = 27 + recid
     unsigned char hash[32];
     SHA256(reinterpret_cast<const unsigned char*>(txBytes.constData()),
            txBytes.size(), hash);
 
-    // TODO: Implement ECDSA signature
-    return QByteArray();
+    return Secp256k1::signHash(hash, privateKey).toCompact(27);
 }
 
 QByteArray TransactionBuilder::buildSolanaTransaction(const QString &from,
@@ -206,43 +239,20 @@ QByteArray TransactionBuilder::encodeVarint(quint64 value)
 
 QByteArray TransactionBuilder::encodeRLPString(const QByteArray &data)
 {
-    if (data.size() == 1 && (unsigned char)data[0] < 0x80) {
-        return data;
-    } else if (data.size() < 56) {
-        QByteArray result;
-        result.append(0x80 + data.size());
-        result.append(data);
-        return result;
-    } else {
-        QByteArray lengthBytes = QByteArray::number(data.size(), 16).rightJustified(2, '0');
-        QByteArray result;
-        result.append(0xb7 + lengthBytes.size());
-        result.append(hexToBytes(lengthBytes));
-        result.append(data);
-        return result;
-    }
+    RLPEncoder rlp(1);
+    rlp.bytes(data);
+    return rlp.encode();
 }
 
 QByteArray TransactionBuilder::encodeRLPList(const QVector<QByteArray> &items)
 {
-    QByteArray encoded;
+    RLPEncoder rlp(items.size() + 1);
+    rlp.beginList();
     for (const QByteArray &item : items) {
-        encoded.append(encodeRLPString(item));
-    }
-
-    if (encoded.size() < 56) {
-        QByteArray result;
-        result.append(0xc0 + encoded.size());
-        result.append(encoded);
-        return result;
-    } else {
-        QByteArray lengthBytes = QByteArray::number(encoded.size(), 16).rightJustified(2, '0');
-        QByteArray result;
-        result.append(0xf7 + lengthBytes.size());
-        result.append(hexToBytes(lengthBytes));
-        result.append(encoded);
-        return result;
+        rlp.bytes(item);
     }
+    rlp.endList();
+    return rlp.encode();
 }
 
 QString TransactionBuilder::bytesToHex(const QByteArray &bytes)
@@ -9,42 +9,66 @@
 #include <QString>
 #include <QByteArray>
 #include <QVector>
+#include <QStringList>
+#include "BitcoinTransaction.h"
 
 // Bitcoin UTXO
 struct UTXO {
     QString txid;
     uint32_t vout;
-    QString scriptPubKey;
+    QString scriptPubKey;       // hex
     qint64 value;  // satoshis
 };
 
-// Ethereum transaction
+// EIP-2930 access list entry
+struct AccessListEntry {
+    QString address;
+    QStringList storageKeys;    // 32-byte hex slots
+};
+
+// Ethereum transaction; quantities are hex ("0x...")
 struct EthereumTx {
     QString nonce;
-    QString gasPrice;
+    QString gasPrice;           // legacy and EIP-2930
     QString gasLimit;
     QString to;
     QString value;
     QString data;
     int chainId;
+
+    // EIP-2718 envelope: 0 = legacy (EIP-155), 1 = EIP-2930, 2 = EIP-1559
+    int type = 0;
+    QString maxPriorityFeePerGas;   // EIP-1559
+    QString maxFeePerGas;           // EIP-1559
+    QVector<AccessListEntry> accessList;
 };
 
 class TransactionBuilder {
 public:
-    // Bitcoin transaction building
-    static QByteArray buildBitcoinTransaction(const QVector<UTXO> &inputs,
-                                             const QString &toAddress,
-                                             qint64 amount,
-                                             qint64 fee,
-                                             const QString &changeAddress);
+    // Spends all inputs to toScript; change goes to changeScript unless it
+    // is below BITCOIN_DUST_LIMIT. Returns an empty transaction (no inputs)
+    // when the inputs do not cover amount + fee.
+    static BitcoinTransaction buildBitcoinTransaction(const QVector<UTXO> &inputs,
+                                                      const QByteArray &toScript,
+                                                      qint64 amount,
+                                                      qint64 fee,
+                                                      const QByteArray &changeScript);
+
+    // P2WPKH or P2TR input; the transaction's sighash midstates are shared
+    // by all of its inputs
+    static bool signBitcoinInput(BitcoinTransaction &tx,
+                                 int inputIndex,
+                                 const QByteArray &privateKey);
 
-    static QByteArray signBitcoinInput(const QByteArray &tx,
-                                      int inputIndex,
-                                      const QByteArray &privateKey,
-                                      const QString &scriptPubKey);
+    static constexpr qint64 BITCOIN_DUST_LIMIT = 546;
 
-    // Ethereum RLP encoding
+    // Ethereum RLP encoding. encodeRLP is the unsigned signing payload
+    // (typed envelopes include the type byte); its Keccak-256 is streamed
+    // by ethereumSigningHash without building the payload.
     static QByteArray encodeRLP(const EthereumTx &tx);
+    static void ethereumSigningHash(const EthereumTx &tx, uint8_t hash[32]);
+    static QByteArray encodeSignedEthereumTransaction(const EthereumTx &tx, int recoveryId,
+                                                      const QByteArray &r, const QByteArray &s);
     static QByteArray signEthereumTransaction(const EthereumTx &tx,
                                              const QByteArray &privateKey);
 
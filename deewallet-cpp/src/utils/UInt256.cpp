@@ -0,0 +1,307 @@
+/**
+ * DEE WALLET - 256-bit Unsigned Integer Implementation
+ */
+
+#include "UInt256.h"
+#include <cstring>
+
+UInt256::UInt256()
+    : limbs{0, 0, 0, 0}
+{
+}
+
+UInt256::UInt256(uint64_t value)
+    : limbs{value, 0, 0, 0}
+{
+}
+
+UInt256 UInt256::fromBigEndian(const uint8_t *data, int length)
+{
+    UInt256 result;
+
+    // Only the low 32 bytes are significant
+    if (length > 32) {
+        data += length - 32;
+        length = 32;
+    }
+
+    for (int i = 0; i < length; ++i) {
+        int bytePos = length - 1 - i;  // 0 = least significant
+        result.limbs[bytePos / 8] |= static_cast<uint64_t>(data[i]) << ((bytePos % 8) * 8);
+    }
+
+    return result;
+}
+
+UInt256 UInt256::fromHex(const QString &hex, bool *ok)
+{
+    UInt256 result;
+    int start = hex.startsWith("0x", Qt::CaseInsensitive) ? 2 : 0;
+    int digits = hex.length() - start;
+
+    // Skip leading zeros so zero-padded 32-byte words still fit
+    while (digits > 0 && hex[start] == '0') {
+        ++start;
+        --digits;
+    }
+
+    bool valid = hex.length() > (hex.startsWith("0x", Qt::CaseInsensitive) ? 2 : 0) && digits <= 64;
+    for (int i = 0; valid && i < digits; ++i) {
+        char c = hex[start + i].toLatin1();
+        int nibble;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        } else {
+            valid = false;
+            break;
+        }
+
+        int nibblePos = digits - 1 - i;
+        result.limbs[nibblePos / 16] |= static_cast<uint64_t>(nibble) << ((nibblePos % 16) * 4);
+    }
+
+    if (ok) {
+        *ok = valid;
+    }
+    return valid ? result : UInt256();
+}
+
+UInt256 UInt256::fromDecimal(const QString &decimal, bool *ok)
+{
+    UInt256 result;
+    bool valid = !decimal.isEmpty();
+
+    // Nine digits per multiply-add instead of one (10^9 fits mulSmall)
+    int length = decimal.length();
+    int chunk = length % DECIMAL_CHUNK_DIGITS;
+    if (chunk == 0) {
+        chunk = DECIMAL_CHUNK_DIGITS;
+    }
+
+    for (int i = 0; valid && i < length; i += chunk, chunk = DECIMAL_CHUNK_DIGITS) {
+        uint32_t chunkValue = 0;
+        uint32_t scale = 1;
+        for (int j = i; j < i + chunk; ++j) {
+            QChar c = decimal[j];
+            if (c < '0' || c > '9') {
+                valid = false;
+                break;
+            }
+            chunkValue = chunkValue * 10 + static_cast<uint32_t>(c.toLatin1() - '0');
+            scale *= 10;
+        }
+        if (!valid) {
+            break;
+        }
+
+        bool overflowMul = false;
+        bool overflowAdd = false;
+        result = result.mulSmall(scale, &overflowMul).add(UInt256(chunkValue), &overflowAdd);
+        valid = !overflowMul && !overflowAdd;
+    }
+
+    if (ok) {
+        *ok = valid;
+    }
+    return valid ? result : UInt256();
+}
+
+void UInt256::toBigEndian(uint8_t out[32]) const
+{
+    for (int i = 0; i < 32; ++i) {
+        int bytePos = 31 - i;
+        out[i] = static_cast<uint8_t>(limbs[bytePos / 8] >> ((bytePos % 8) * 8));
+    }
+}
+
+QByteArray UInt256::toBigEndian() const
+{
+    uint8_t out[32];
+    toBigEndian(out);
+    return QByteArray(reinterpret_cast<const char*>(out), 32);
+}
+
+QString UInt256::toHex() const
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    char buffer[66];
+    int pos = 0;
+    buffer[pos++] = '0';
+    buffer[pos++] = 'x';
+
+    bool leading = true;
+    for (int nibblePos = 63; nibblePos >= 0; --nibblePos) {
+        int nibble = static_cast<int>((limbs[nibblePos / 16] >> ((nibblePos % 16) * 4)) & 0x0f);
+        if (leading && nibble == 0 && nibblePos > 0) {
+            continue;
+        }
+        leading = false;
+        buffer[pos++] = HEX_DIGITS[nibble];
+    }
+
+    return QString::fromLatin1(buffer, pos);
+}
+
+QString UInt256::toDecimal() const
+{
+    // 2^256 has 78 decimal digits
+    char buffer[81];
+    int pos = sizeof(buffer);
+
+    // Peel off nine digits per division; only the top chunk drops its zeros
+    UInt256 value = *this;
+    do {
+        uint32_t chunk = 0;
+        value = value.divSmall(DECIMAL_CHUNK_BASE, &chunk);
+        for (int i = 0; i < DECIMAL_CHUNK_DIGITS && (chunk != 0 || !value.isZero() || i == 0); ++i) {
+            buffer[--pos] = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    } while (!value.isZero());
+
+    return QString::fromLatin1(buffer + pos, static_cast<int>(sizeof(buffer)) - pos);
+}
+
+QString UInt256::formatUnits(int decimals) const
+{
+    QString digits = toDecimal();
+    if (decimals <= 0) {
+        return digits;
+    }
+
+    if (digits.length() <= decimals) {
+        digits = QString(decimals - digits.length() + 1, '0') + digits;
+    }
+
+    return digits.left(digits.length() - decimals) + "." + digits.right(decimals);
+}
+
+UInt256 UInt256::parseUnits(const QString &amount, int decimals, bool *ok)
+{
+    QString trimmed = amount.trimmed();
+    int dot = trimmed.indexOf('.');
+    QString whole = dot >= 0 ? trimmed.left(dot) : trimmed;
+    QString fraction = dot >= 0 ? trimmed.mid(dot + 1) : QString();
+
+    // Reject precision the token cannot represent rather than silently truncating
+    bool valid = !(whole.isEmpty() && fraction.isEmpty()) && fraction.length() <= decimals;
+    UInt256 result;
+    if (valid) {
+        QString digits = (whole.isEmpty() ? QString("0") : whole) +
+                         fraction + QString(decimals - fraction.length(), '0');
+        result = fromDecimal(digits, &valid);
+    }
+
+    if (ok) {
+        *ok = valid;
+    }
+    return valid ? result : UInt256();
+}
+
+bool UInt256::isZero() const
+{
+    return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0;
+}
+
+bool UInt256::fitsUInt64() const
+{
+    return (limbs[1] | limbs[2] | limbs[3]) == 0;
+}
+
+double UInt256::toDouble() const
+{
+    const double LIMB_BASE = 18446744073709551616.0;  // 2^64
+    return ((static_cast<double>(limbs[3]) * LIMB_BASE + static_cast<double>(limbs[2])) * LIMB_BASE +
+            static_cast<double>(limbs[1])) * LIMB_BASE + static_cast<double>(limbs[0]);
+}
+
+UInt256 UInt256::add(const UInt256 &other, bool *overflow) const
+{
+    UInt256 result;
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t sum = limbs[i] + other.limbs[i];
+        uint64_t carryOut = sum < limbs[i] ? 1 : 0;
+        result.limbs[i] = sum + carry;
+        carryOut |= result.limbs[i] < sum ? 1 : 0;
+        carry = carryOut;
+    }
+
+    if (overflow) {
+        *overflow = carry != 0;
+    }
+    return result;
+}
+
+UInt256 UInt256::sub(const UInt256 &other, bool *underflow) const
+{
+    UInt256 result;
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t diff = limbs[i] - other.limbs[i];
+        uint64_t borrowOut = limbs[i] < other.limbs[i] ? 1 : 0;
+        result.limbs[i] = diff - borrow;
+        borrowOut |= diff < borrow ? 1 : 0;
+        borrow = borrowOut;
+    }
+
+    if (underflow) {
+        *underflow = borrow != 0;
+    }
+    return result;
+}
+
+UInt256 UInt256::mulSmall(uint32_t factor, bool *overflow) const
+{
+    // Schoolbook over 32-bit halves so no 128-bit type is needed (MSVC)
+    UInt256 result;
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t low = (limbs[i] & 0xffffffffULL) * factor + carry;
+        uint64_t high = (limbs[i] >> 32) * factor + (low >> 32);
+        result.limbs[i] = (high << 32) | (low & 0xffffffffULL);
+        carry = high >> 32;
+    }
+
+    if (overflow) {
+        *overflow = carry != 0;
+    }
+    return result;
+}
+
+UInt256 UInt256::divSmall(uint32_t divisor, uint32_t *remainder) const
+{
+    UInt256 result;
+    uint64_t rem = 0;
+    for (int i = 3; i >= 0; --i) {
+        uint64_t high = (rem << 32) | (limbs[i] >> 32);
+        uint64_t quotientHigh = high / divisor;
+        rem = high % divisor;
+
+        uint64_t low = (rem << 32) | (limbs[i] & 0xffffffffULL);
+        uint64_t quotientLow = low / divisor;
+        rem = low % divisor;
+
+        result.limbs[i] = (quotientHigh << 32) | quotientLow;
+    }
+
+    if (remainder) {
+        *remainder = static_cast<uint32_t>(rem);
+    }
+    return result;
+}
+
+int UInt256::compare(const UInt256 &other) const
+{
+    for (int i = 3; i >= 0; --i) {
+        if (limbs[i] != other.limbs[i]) {
+            return limbs[i] < other.limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * DEE WALLET - 256-bit Unsigned Integer
+ * Fixed-width arithmetic for on-chain amounts (uint256 balances, wei values)
+ */
+
+#ifndef UINT256_H
+#define UINT256_H
+
+#include <QString>
+#include <QByteArray>
+#include <cstdint>
+
+class UInt256 {
+public:
+    UInt256();
+    UInt256(uint64_t value);
+
+    // Parsing; ok is false on bad digits or overflow
+    static UInt256 fromBigEndian(const uint8_t *data, int length);
+    static UInt256 fromHex(const QString &hex, bool *ok = nullptr);
+    static UInt256 fromDecimal(const QString &decimal, bool *ok = nullptr);
+
+    // Serialization
+    void toBigEndian(uint8_t out[32]) const;
+    QByteArray toBigEndian() const;
+    QString toHex() const;          // minimal "0x..." quantity encoding
+    QString toDecimal() const;
+
+    // Fixed-point formatting, e.g. formatUnits(18) turns wei into ether
+    QString formatUnits(int decimals) const;
+    static UInt256 parseUnits(const QString &amount, int decimals, bool *ok = nullptr);
+
+    bool isZero() const;
+    bool fitsUInt64() const;
+    uint64_t toUInt64() const { return limbs[0]; }
+    double toDouble() const;
+
+    // Arithmetic (wraps modulo 2^256; check overflow with the out-parameters)
+    UInt256 add(const UInt256 &other, bool *overflow = nullptr) const;
+    UInt256 sub(const UInt256 &other, bool *underflow = nullptr) const;
+    UInt256 mulSmall(uint32_t factor, bool *overflow = nullptr) const;
+    UInt256 divSmall(uint32_t divisor, uint32_t *remainder = nullptr) const;
+
+    UInt256 operator+(const UInt256 &other) const { return add(other); }
+    UInt256 operator-(const UInt256 &other) const { return sub(other); }
+
+    int compare(const UInt256 &other) const;
+    bool operator==(const UInt256 &other) const { return compare(other) == 0; }
+    bool operator!=(const UInt256 &other) const { return compare(other) != 0; }
+    bool operator<(const UInt256 &other) const { return compare(other) < 0; }
+    bool operator>(const UInt256 &other) const { return compare(other) > 0; }
+    bool operator<=(const UInt256 &other) const { return compare(other) <= 0; }
+    bool operator>=(const UInt256 &other) const { return compare(other) >= 0; }
+
+private:
+    static constexpr int DECIMAL_CHUNK_DIGITS = 9;
+    static constexpr uint32_t DECIMAL_CHUNK_BASE = 1000000000;
+
+    uint64_t limbs[4];  // little-endian 64-bit limbs
+};
+
+#endif // UINT256_H